@@ -0,0 +1,49 @@
+#ifndef BENCHMARKUTILS_H
+#define BENCHMARKUTILS_H
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<stdbool.h>
+#include<time.h>
+
+//Helpers shared by the benchmarks.
+
+static inline double seconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+//Write a file of about megaBytes MB with a header and ncol columns of random
+//numbers in the styles of numbers.txt: integers and decimals with up to 5
+//fraction digits, either sign, followed by a blank line if blankLine is set.
+//The numbers are the same for every call.
+static inline void writeNumbersFile(const char* fileName, const size_t megaBytes, const size_t ncol, const bool blankLine)
+{
+    FILE* file_p = fopen(fileName, "w");
+    if (file_p == NULL)
+    {
+        printf("%s failed to open. \n", fileName);
+        exit(1);
+    }
+
+    for (size_t j = 0; j < ncol; j++)
+    {   fprintf(file_p, j + 1 < ncol ? "column%zu," : "column%zu\n", j);  }
+
+    srand(9999);
+    while ((size_t)ftell(file_p) < megaBytes << 20)
+    {
+        for (size_t j = 0; j < ncol; j++)
+        {
+            const int fractionDigits = rand() % 6;
+            const double value = (rand() % 2000000 - 1000000) / 100.0;
+            fprintf(file_p, j + 1 < ncol ? "%.*f," : "%.*f\n", fractionDigits, value);
+        }
+    }
+    if (blankLine)
+    {   fprintf(file_p, "\n");  }
+    fclose(file_p);
+}
+
+#endif /* BENCHMARKUTILS_H */
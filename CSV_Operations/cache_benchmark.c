@@ -0,0 +1,65 @@
+#include "dataframeCache.h"
+#include "benchmarkUtils.h"
+
+#define BENCHMARK_FILE "cache_benchmark.csv"
+#define BENCHMARK_CACHE "cache_benchmark.csv.f32df"
+#define BENCHMARK_COLUMNS 10
+
+static bool sameDataframe(f32_dataframe_t* a, f32_dataframe_t* b)
+{
+    if (a->nrow != b->nrow || a->ncol != b->ncol)
+    {   return false;   }
+    if (strcmp(a->colNames, b->colNames) != 0)
+    {   return false;   }
+    if (memcmp(a->colIndices, b->colIndices, sizeof(size_t) * (a->ncol + 1)) != 0)
+    {   return false;   }
+    return memcmp(a->data, b->data, sizeof(float) * a->nrow * a->ncol) == 0;
+}
+
+//Sum of every element, which touches every page of the data.
+static double total(f32_dataframe_t* data_p)
+{
+    double sum = 0.0;
+    for (size_t i = 0; i < data_p->nrow * data_p->ncol; i++)
+    {   sum += *(data_p->data + i); }
+    return sum;
+}
+
+//Takes the size of the generated file in MB as an optional argument.
+int main(int argc, char** argv)
+{
+    const size_t megaBytes = argc > 1 ? (size_t)atol(argv[1]) : 256;
+    writeNumbersFile(BENCHMARK_FILE, megaBytes, BENCHMARK_COLUMNS, false);
+    remove(BENCHMARK_CACHE);
+
+    double start = seconds();
+    f32_dataframe_t parsed = f32_mapCSV(BENCHMARK_FILE, true);
+    const double parseTime = seconds() - start;
+
+    //Without a cache the file is parsed and the cache written.
+    start = seconds();
+    f32_dataframe_t first = f32_readCSVCached(BENCHMARK_FILE, true, NULL);
+    const double missTime = seconds() - start;
+
+    start = seconds();
+    f32_dataframe_t cached = f32_readCSVCached(BENCHMARK_FILE, true, NULL);
+    const double hitTime = seconds() - start;
+
+    start = seconds();
+    const double sum = total(&cached);
+    const double touchTime = seconds() - start;
+
+    printf("%zu rows x %zu columns, %.1f MB of floats \n", parsed.nrow, parsed.ncol, sizeof(float) * parsed.nrow * parsed.ncol / 1e6);
+    printf("f32_mapCSV, 1 thread:                   %9.3f ms \n", parseTime * 1e3);
+    printf("f32_readCSVCached, parse + write cache: %9.3f ms \n", missTime * 1e3);
+    printf("f32_readCSVCached, load cache:          %9.3f ms \n", hitTime * 1e3);
+    printf("  then reading every element:           %9.3f ms \n", touchTime * 1e3);
+    printf("Results %s (sum %.6g) \n", sameDataframe(&parsed, &first) && sameDataframe(&parsed, &cached) ? "match" : "DIFFER", sum);
+
+    f32_freeCSV(&parsed);
+    f32_freeCSV(&first);
+    f32_freeCSV(&cached);
+    remove(BENCHMARK_FILE);
+    remove(BENCHMARK_CACHE);
+    return 0;
+}
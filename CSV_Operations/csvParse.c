@@ -0,0 +1,305 @@
+#include "csvParse.h"
+#include<stdlib.h>
+#include<string.h>
+#include<pthread.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include<immintrin.h>
+#endif
+
+#define BLOCK_BYTES 32
+
+//Bitmap of the delimiters in the BLOCK_BYTES bytes at block, one bit per byte.
+static uint32_t scalarMask(const char* block)
+{
+    uint32_t mask = 0;
+    for (size_t i = 0; i < BLOCK_BYTES; i++)
+    {
+        if (*(block + i) == ',' || *(block + i) == '\n')
+        {   mask |= (uint32_t)1 << i;   }
+    }
+    return mask;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("avx2")))
+static uint32_t avx2Mask(const char* block)
+{
+    __m256i bytes = _mm256_loadu_si256((const __m256i*)block);
+    __m256i commas = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(','));
+    __m256i newlines = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\n'));
+    return (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(commas, newlines));
+}
+#endif
+
+static uint32_t (*delimiterMask)(const char*) = NULL;
+
+bool csv_useAVX2(bool enable)
+{
+    delimiterMask = scalarMask;
+#if defined(__x86_64__) || defined(__i386__)
+    if (enable && __builtin_cpu_supports("avx2"))
+    {   delimiterMask = avx2Mask;   }
+#endif
+    return delimiterMask != scalarMask;
+}
+
+//The first scanner picks the kernel once, whichever thread starts it.
+static pthread_once_t dispatchOnce = PTHREAD_ONCE_INIT;
+
+static void defaultDispatch(void)
+{
+    if (delimiterMask == NULL)
+    {   csv_useAVX2(true);  }
+}
+
+//Bitmap of a block that may run past end. Bytes past end are never read.
+static uint32_t blockMask(const char* block, const char* end)
+{
+    if (end - block >= BLOCK_BYTES)
+    {   return delimiterMask(block);    }
+
+    uint32_t mask = 0;
+    for (size_t i = 0; block + i < end; i++)
+    {
+        if (*(block + i) == ',' || *(block + i) == '\n')
+        {   mask |= (uint32_t)1 << i;   }
+    }
+    return mask;
+}
+
+void csv_initScanner(csv_scanner_t* scanner_p, const char* p, const char* end)
+{
+    pthread_once(&dispatchOnce, defaultDispatch);
+    scanner_p->block = p;
+    scanner_p->end = end;
+    scanner_p->mask = p < end ? blockMask(p, end) : 0;
+}
+
+bool csv_refill(csv_scanner_t* scanner_p)
+{
+    while (scanner_p->mask == 0)
+    {
+        if (scanner_p->end - scanner_p->block <= BLOCK_BYTES)
+        {   return false;   }
+        scanner_p->block += BLOCK_BYTES;
+        scanner_p->mask = blockMask(scanner_p->block, scanner_p->end);
+    }
+    return true;
+}
+
+//Return a pointer to the next ',' or '\n' at or after p, or to end.
+static const char* fieldEnd(const char* p, const char* end)
+{
+    while (p < end && *p != ',' && *p != '\n')
+    {   p++;    }
+    return p;
+}
+
+const char* csv_parseHeader(const char* p, const char* end, char** colNames_p, size_t** colIndices_p, size_t* ncol_p)
+{
+    const char* lineEnd = (const char*)memchr(p, '\n', end - p);
+    if (lineEnd == NULL)
+    {   lineEnd = end;  }
+
+    size_t capacity = 16, ncol = 0;
+    char* colNames = (char*)malloc(lineEnd - p + 1);
+    size_t* colIndices = (size_t*)malloc(sizeof(size_t) * (capacity + 1));
+    *colIndices = 0;
+    while (p < lineEnd)
+    {
+        const char* stop = fieldEnd(p, lineEnd);
+        size_t strLength = stop - p;
+        if (strLength && *(stop - 1) == '\r')
+        {   strLength--;    }
+        if (strLength)
+        {
+            if (ncol == capacity)
+            {
+                capacity *= 2;
+                colIndices = (size_t*)realloc(colIndices, sizeof(size_t) * (capacity + 1));
+            }
+            memcpy(colNames + *(colIndices + ncol), p, strLength);
+            *(colIndices + ncol + 1) = *(colIndices + ncol) + strLength;
+            ncol++;
+        }
+        p = stop + 1;
+    }
+    *(colNames + *(colIndices + ncol)) = '\0';
+
+    *colNames_p = colNames;
+    *colIndices_p = colIndices;
+    *ncol_p = ncol;
+    return lineEnd < end ? lineEnd + 1 : end;
+}
+
+size_t csv_firstRowWidth(const char* p, const char* end)
+{
+    size_t rowWidth = 0;
+    while (p < end)
+    {
+        const char* stop = fieldEnd(p, end);
+        if (!csv_isEmptyField(csv_skipBlanks(p, stop), stop))
+        {   rowWidth++; }
+        if ((stop == end || *stop == '\n') && rowWidth)
+        {   break;  }
+        p = stop + 1;
+    }
+    return rowWidth;
+}
+
+//strtod on the field. Every field but the last one in the buffer is followed
+//by a delimiter, which stops strtod. The last one may end exactly at the end
+//of the buffer, so it is copied and terminated first.
+static double slowParse(const char* start, const char* stop, const char* end, bool toFloat)
+{
+    if (stop < end)
+    {   return toFloat ? strtof(start, NULL) : strtod(start, NULL);   }
+
+    char* field = (char*)malloc(stop - start + 1);
+    memcpy(field, start, stop - start);
+    *(field + (stop - start)) = '\0';
+    double value = toFloat ? strtof(field, NULL) : strtod(field, NULL);
+    free(field);
+    return value;
+}
+
+//Powers of ten that are exact in a double.
+static const double powersOfTen[] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+//The field as mantissa * 10^exponent.
+typedef struct decimal
+{
+    uint64_t mantissa;
+    int exponent;
+    bool negative;
+} decimal_t;
+
+//Read [start, stop) as a decimal number with at most 19 significant digits,
+//an optional exponent and trailing blanks. Returns false for anything else,
+//including inf, nan and hex floats, which are left to strtof and strtod.
+static bool scanDecimal(const char* start, const char* stop, decimal_t* decimal_p)
+{
+    const char* p = start;
+    bool negative = false, anyDigits = false;
+    if (p < stop && (*p == '-' || *p == '+'))
+    {   negative = *p == '-'; p++;  }
+
+    uint64_t mantissa = 0;
+    int digits = 0, exponent = 0;
+    while (p < stop && (unsigned)(*p - '0') < 10)
+    {
+        if (mantissa || *p != '0')
+        {
+            if (digits == 19)
+            {   return false;   }
+            mantissa = mantissa * 10 + (*p - '0');
+            digits++;
+        }
+        anyDigits = true;
+        p++;
+    }
+    if (p < stop && *p == '.')
+    {
+        p++;
+        while (p < stop && (unsigned)(*p - '0') < 10)
+        {
+            if (mantissa || *p != '0')
+            {
+                if (digits == 19)
+                {   return false;   }
+                mantissa = mantissa * 10 + (*p - '0');
+                digits++;
+            }
+            exponent--;
+            anyDigits = true;
+            p++;
+        }
+    }
+    if (!anyDigits)
+    {   return false;   }
+
+    //An exponent without digits is not part of the number, as in strtof.
+    if (p < stop && (*p == 'e' || *p == 'E'))
+    {
+        const char* q = p + 1;
+        bool negativeExponent = false;
+        if (q < stop && (*q == '-' || *q == '+'))
+        {   negativeExponent = *q == '-'; q++;  }
+        if (q < stop && (unsigned)(*q - '0') < 10)
+        {
+            int explicitExponent = 0;
+            while (q < stop && (unsigned)(*q - '0') < 10)
+            {
+                if (explicitExponent > 10000)
+                {   return false;   }
+                explicitExponent = explicitExponent * 10 + (*q - '0');
+                q++;
+            }
+            exponent += negativeExponent ? -explicitExponent : explicitExponent;
+            p = q;
+        }
+    }
+    //Anything left other than trailing blanks is something strtof may read differently.
+    while (p < stop && (*p == ' ' || *p == '\t' || *p == '\r'))
+    {   p++;    }
+    if (p < stop)
+    {   return false;   }
+
+    decimal_p->mantissa = mantissa;
+    decimal_p->exponent = exponent;
+    decimal_p->negative = negative;
+    return true;
+}
+
+//Decimal numbers with a mantissa below 2^53 and a power of ten up to 22 are
+//scaled with one double operation, which is correctly rounded (Clinger's fast
+//path). Returns false for the others.
+static bool fastDouble(const decimal_t* decimal_p, double* value_p)
+{
+    if (decimal_p->mantissa > ((uint64_t)1 << 53) || decimal_p->exponent < -22 || decimal_p->exponent > 22)
+    {   return false;   }
+    *value_p = decimal_p->exponent < 0 ? (double)decimal_p->mantissa / powersOfTen[-decimal_p->exponent]
+                                       : (double)decimal_p->mantissa * powersOfTen[decimal_p->exponent];
+    return true;
+}
+
+//Rounding the fast path double to a float is exact unless it falls on the
+//midpoint between two floats. Everything else goes to strtof.
+float csv_parseFloat(const char* start, const char* stop, const char* end)
+{
+    decimal_t decimal;
+    double value;
+    if (!scanDecimal(start, stop, &decimal))
+    {   return (float)slowParse(start, stop, end, true);  }
+    if (decimal.mantissa == 0)
+    {   return decimal.negative ? -0.0f : 0.0f;    }
+    if (!fastDouble(&decimal, &value))
+    {   return (float)slowParse(start, stop, end, true);  }
+
+    //The 29 low bits of the double are the ones a float drops. The value is
+    //always in the normal float range here.
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    if ((bits & (((uint64_t)1 << 29) - 1)) == ((uint64_t)1 << 28))
+    {   return (float)slowParse(start, stop, end, true);  }
+
+    float result = (float)value;
+    return decimal.negative ? -result : result;
+}
+
+double csv_parseDouble(const char* start, const char* stop, const char* end)
+{
+    decimal_t decimal;
+    double value;
+    if (!scanDecimal(start, stop, &decimal))
+    {   return slowParse(start, stop, end, false); }
+    if (decimal.mantissa == 0)
+    {   return decimal.negative ? -0.0 : 0.0;  }
+    if (!fastDouble(&decimal, &value))
+    {   return slowParse(start, stop, end, false); }
+    return decimal.negative ? -value : value;
+}
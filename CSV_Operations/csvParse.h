@@ -0,0 +1,68 @@
+#ifndef CSVPARSE_H
+#define CSVPARSE_H
+
+#include<stdbool.h>
+#include<stddef.h>
+#include<stdint.h>
+
+//Walks the ',' and '\n' delimiters of [p, end) in order. Delimiters are found
+//32 bytes at a time and kept as a bitmap of the current block.
+typedef struct csv_scanner
+{
+    const char* block;
+    const char* end;
+    uint32_t mask;
+} csv_scanner_t;
+
+void csv_initScanner(csv_scanner_t* scanner_p, const char* p, const char* end);
+
+//Load the bitmap of the next block that holds a delimiter. Returns false at the end.
+bool csv_refill(csv_scanner_t* scanner_p);
+
+//Return the next delimiter, or end once there are none left.
+static inline const char* csv_nextDelimiter(csv_scanner_t* scanner_p)
+{
+    if (scanner_p->mask == 0 && !csv_refill(scanner_p))
+    {   return scanner_p->end;  }
+    const char* delimiter = scanner_p->block + __builtin_ctz(scanner_p->mask);
+    scanner_p->mask &= scanner_p->mask - 1;
+    return delimiter;
+}
+
+//Skip spaces and tabs, but never a line end.
+static inline const char* csv_skipBlanks(const char* p, const char* end)
+{
+    while (p < end && (*p == ' ' || *p == '\t'))
+    {   p++;    }
+    return p;
+}
+
+//A field is empty if it holds nothing but a carriage return. Empty fields are
+//skipped, as strtok does in f32_readCSV.
+static inline bool csv_isEmptyField(const char* start, const char* stop)
+{
+    return stop == start || (stop - start == 1 && *start == '\r');
+}
+
+//Parse the header line starting at p: the names are stored back to back in
+//colNames_p, and colIndices_p holds the offset of each name followed by the
+//total length, as in f32_dataframe_t. Stores the number of names in ncol_p and
+//returns the start of the next line.
+const char* csv_parseHeader(const char* p, const char* end, char** colNames_p, size_t** colIndices_p, size_t* ncol_p);
+
+//Number of fields in the first row of [p, end) that is not blank.
+size_t csv_firstRowWidth(const char* p, const char* end);
+
+//Parse the float at the start of the field [start, stop) with the same result
+//as strtof. 'end' is the end of the buffer holding the field.
+float csv_parseFloat(const char* start, const char* stop, const char* end);
+
+//As csv_parseFloat, with the same result as strtod.
+double csv_parseDouble(const char* start, const char* stop, const char* end);
+
+//Choose between the AVX2 and the scalar delimiter scan. AVX2 is only used if
+//the CPU supports it, which is also the default, picked once by the first
+//scanner. Not to be called while scanners run. Returns whether AVX2 is used.
+bool csv_useAVX2(bool enable);
+
+#endif /* CSVPARSE_H */
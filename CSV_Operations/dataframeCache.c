@@ -0,0 +1,244 @@
+#include "dataframeCache.h"
+#include<fcntl.h>
+#include<stdint.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
+
+#define BINARY_MAGIC "F32DF\0\0\1"
+#define BINARY_ENDIAN 0x01020304U
+
+typedef struct binary_header
+{
+    char magic[8];
+    uint32_t endian;        //BINARY_ENDIAN as written; anything else is another byte order.
+    uint32_t layout;
+    uint64_t nrow;
+    uint64_t ncol;
+    uint64_t rowStride;
+    uint64_t colStride;
+    uint64_t namesBytes;    //colNames with its '\0', or 0 without names.
+    uint64_t payloadOffset;
+    uint64_t payloadBytes;
+    //The CSV file the data was parsed from, for f32_readCSVCached. All 0 otherwise.
+    uint64_t sourceSize;
+    int64_t sourceSeconds;
+    int64_t sourceNanoseconds;
+    uint32_t hasHeader;
+    uint32_t reserved;
+} binary_header_t;
+
+//Floats of data in memory, padding included.
+static size_t payloadFloats(f32_dataframe_t* data_p)
+{
+    if (data_p->layout == F32_COLUMN_MAJOR)
+    {   return data_p->ncol * data_p->colStride;    }
+    return data_p->nrow * data_p->ncol;
+}
+
+//Write the dataframe to a temporary file that is then renamed to fileName, so
+//that a reader never maps a half-written file. Returns false on failure.
+static bool writeBinary(f32_dataframe_t* data_p, const char* fileName, const struct stat* source_p, bool hasHeader)
+{
+    binary_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BINARY_MAGIC, sizeof(header.magic));
+    header.endian = BINARY_ENDIAN;
+    header.layout = (uint32_t)data_p->layout;
+    header.nrow = data_p->nrow;
+    header.ncol = data_p->ncol;
+    header.rowStride = data_p->rowStride;
+    header.colStride = data_p->colStride;
+    const size_t indexBytes = data_p->colIndices ? sizeof(size_t) * (data_p->ncol + 1) : 0;
+    header.namesBytes = data_p->colIndices ? *(data_p->colIndices + data_p->ncol) + 1 : 0;
+    const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    header.payloadOffset = (sizeof(header) + indexBytes + header.namesBytes + pageSize - 1) / pageSize * pageSize;
+    header.payloadBytes = sizeof(float) * payloadFloats(data_p);
+    if (source_p != NULL)
+    {
+        header.sourceSize = (uint64_t)source_p->st_size;
+        header.sourceSeconds = (int64_t)source_p->st_mtim.tv_sec;
+        header.sourceNanoseconds = (int64_t)source_p->st_mtim.tv_nsec;
+        header.hasHeader = hasHeader;
+    }
+
+    const size_t nameLength = strlen(fileName);
+    char* tempName = (char*)malloc(nameLength + 32);
+    snprintf(tempName, nameLength + 32, "%s.%ld.tmp", fileName, (long)getpid());
+    FILE* file_p = fopen(tempName, "wb");
+    if (file_p == NULL)
+    {
+        free(tempName);
+        return false;
+    }
+
+    bool written = fwrite(&header, sizeof(header), 1, file_p) == 1;
+    if (indexBytes)
+    {
+        written = written && fwrite(data_p->colIndices, indexBytes, 1, file_p) == 1;
+        written = written && fwrite(data_p->colNames, header.namesBytes, 1, file_p) == 1;
+    }
+    written = written && fseek(file_p, (long)header.payloadOffset, SEEK_SET) == 0;
+    if (header.payloadBytes)
+    {   written = written && fwrite(data_p->data, header.payloadBytes, 1, file_p) == 1;    }
+    written = fclose(file_p) == 0 && written;
+    written = written && rename(tempName, fileName) == 0;
+    if (!written)
+    {   remove(tempName);   }
+    free(tempName);
+    return written;
+}
+
+//Check that the header describes a dataframe that fits in the file, with
+//names that end inside the name table.
+static bool validHeader(const binary_header_t* header, const char* map, size_t fileSize)
+{
+    if (fileSize < sizeof(binary_header_t) || memcmp(header->magic, BINARY_MAGIC, sizeof(header->magic)) != 0)
+    {   return false;   }
+    if (header->endian != BINARY_ENDIAN || header->payloadOffset % 32 != 0)
+    {   return false;   }
+    //Nothing is written at the payload offset of an empty dataframe.
+    if (header->payloadBytes && (header->payloadOffset > fileSize || header->payloadBytes > fileSize - header->payloadOffset))
+    {   return false;   }
+
+    uint64_t nFloats;
+    if (header->layout == F32_ROW_MAJOR)
+    {
+        if (header->rowStride != header->ncol || header->colStride != 1)
+        {   return false;   }
+        nFloats = header->nrow * header->ncol;
+    }
+    else if (header->layout == F32_COLUMN_MAJOR)
+    {
+        if (header->rowStride != 1 || header->colStride < header->nrow || header->colStride % F32_COLUMN_PAD != 0)
+        {   return false;   }
+        nFloats = header->ncol * header->colStride;
+    }
+    else
+    {   return false;   }
+    if (header->ncol && nFloats / header->ncol != (header->layout == F32_ROW_MAJOR ? header->nrow : header->colStride))
+    {   return false;   }
+    if (sizeof(float) * nFloats != header->payloadBytes)
+    {   return false;   }
+
+    if (header->namesBytes == 0)
+    {   return true;    }
+    const uint64_t indexBytes = sizeof(size_t) * (header->ncol + 1);
+    if (header->ncol >= fileSize || sizeof(binary_header_t) + indexBytes + header->namesBytes > header->payloadOffset)
+    {   return false;   }
+    const size_t* indices = (const size_t*)(map + sizeof(binary_header_t));
+    const char* names = map + sizeof(binary_header_t) + indexBytes;
+    for (size_t i = 0; i < header->ncol; i++)
+    {
+        if (*(indices + i + 1) < *(indices + i))
+        {   return false;   }
+    }
+    return *indices == 0 && *(indices + header->ncol) + 1 == header->namesBytes
+           && *(names + *(indices + header->ncol)) == '\0';
+}
+
+//Map a binary file into dataframe. Returns false if it cannot be opened or is
+//not a valid binary file; header receives its header otherwise.
+static bool mapBinary(const char* fileName, f32_dataframe_t* dataframe, binary_header_t* header)
+{
+    int fd = open(fileName, O_RDONLY);
+    struct stat fileStat;
+    if (fd < 0)
+    {   return false;   }
+    if (fstat(fd, &fileStat) != 0 || (size_t)fileStat.st_size < sizeof(binary_header_t))
+    {
+        close(fd);
+        return false;
+    }
+
+    //Private and writable: pages are shared with the page cache until the
+    //dataframe writes to them, and writes never reach the file.
+    const size_t fileSize = (size_t)fileStat.st_size;
+    char* map = (char*)mmap(NULL, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {   return false;   }
+    memcpy(header, map, sizeof(binary_header_t));
+    if (!validHeader(header, map, fileSize))
+    {
+        munmap(map, fileSize);
+        return false;
+    }
+
+    dataframe->colNames = NULL; dataframe->colIndices = NULL;
+    if (header->namesBytes)
+    {
+        const size_t indexBytes = sizeof(size_t) * (header->ncol + 1);
+        dataframe->colIndices = (size_t*)malloc(indexBytes);
+        memcpy(dataframe->colIndices, map + sizeof(binary_header_t), indexBytes);
+        dataframe->colNames = (char*)malloc(header->namesBytes);
+        memcpy(dataframe->colNames, map + sizeof(binary_header_t) + indexBytes, header->namesBytes);
+    }
+    dataframe->data = (float*)(map + header->payloadOffset);
+    dataframe->nrow = header->nrow;
+    dataframe->ncol = header->ncol;
+    dataframe->layout = (f32_layout_t)header->layout;
+    dataframe->rowStride = header->rowStride;
+    dataframe->colStride = header->colStride;
+    dataframe->mapping = map;
+    dataframe->mappedBytes = fileSize;
+    return true;
+}
+
+void f32_saveBinary(f32_dataframe_t* data_p, const char* fileName)
+{
+    if (!writeBinary(data_p, fileName, NULL, false))
+    {
+        printf("%s failed to write. \n", fileName);
+        exit(1);
+    }
+}
+
+f32_dataframe_t f32_loadBinary(const char* fileName)
+{
+    f32_dataframe_t dataframe;
+    binary_header_t header;
+    if (!mapBinary(fileName, &dataframe, &header))
+    {
+        printf("%s is not a binary dataframe file. \n", fileName);
+        exit(1);
+    }
+    return dataframe;
+}
+
+f32_dataframe_t f32_readCSVCached(const char* fileName, bool hasHeader, const char* cacheName)
+{
+    struct stat source;
+    if (stat(fileName, &source) != 0)
+    {
+        printf("%s failed to open. \n", fileName);
+        exit(1);
+    }
+
+    char* defaultName = NULL;
+    if (cacheName == NULL)
+    {
+        defaultName = (char*)malloc(strlen(fileName) + 7);
+        strcpy(defaultName, fileName);
+        strcat(defaultName, ".f32df");
+        cacheName = defaultName;
+    }
+
+    f32_dataframe_t dataframe;
+    binary_header_t header;
+    if (mapBinary(cacheName, &dataframe, &header))
+    {
+        if (header.sourceSize == (uint64_t)source.st_size && header.sourceSeconds == (int64_t)source.st_mtim.tv_sec
+            && header.sourceNanoseconds == (int64_t)source.st_mtim.tv_nsec && header.hasHeader == (uint32_t)hasHeader)
+        {
+            free(defaultName);
+            return dataframe;
+        }
+        f32_freeCSV(&dataframe);
+    }
+
+    dataframe = f32_mapCSVParallel(fileName, hasHeader, 0);
+    writeBinary(&dataframe, cacheName, &source, hasHeader);
+    free(defaultName);
+    return dataframe;
+}
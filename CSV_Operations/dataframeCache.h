@@ -0,0 +1,29 @@
+#ifndef DATAFRAMECACHE_H
+#define DATAFRAMECACHE_H
+
+#include "readCSV.h"
+
+//Binary dataframe files hold, in order:
+//  a fixed header with the shape, layout and strides of the data, and the size
+//  and modification time of the CSV file it was made from, if any;
+//  colIndices (ncol + 1 offsets) and colNames, when the dataframe has names;
+//  the data exactly as it is in memory, starting on a page boundary.
+//Loading maps the file, so the data is not read or copied until it is touched,
+//and processes loading the same file share its pages until they write to them.
+
+//Write a dataframe, in either layout, to a binary file.
+void f32_saveBinary(f32_dataframe_t* data_p, const char* fileName);
+
+//Load a binary file written by f32_saveBinary. The data stays in the mapping
+//until f32_freeCSV; the names are copied.
+f32_dataframe_t f32_loadBinary(const char* fileName);
+
+//Read a .csv file through a binary cache. If cacheName holds a binary file
+//made from a CSV file of the same size and modification time, read with the
+//same hasHeader, it is loaded. Otherwise the CSV file is parsed with
+//f32_mapCSVParallel on every CPU and the cache is rewritten. Passing NULL as
+//cacheName uses fileName followed by ".f32df". Failing to write the cache is
+//not an error.
+f32_dataframe_t f32_readCSVCached(const char* fileName, bool hasHeader, const char* cacheName);
+
+#endif /* DATAFRAMECACHE_H */
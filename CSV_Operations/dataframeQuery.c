@@ -0,0 +1,339 @@
+#include "dataframeQuery.h"
+#include<pthread.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include<immintrin.h>
+#endif
+
+//Rows per block: 16 row-major columns of a block take 128 KB. A multiple of
+//64, so every block starts on a word of the selection.
+#define QUERY_BLOCK_ROWS 2048
+
+f32_selection_t f32_newSelection(const size_t nrow)
+{
+    f32_selection_t selection;
+    selection.nrow = nrow;
+    selection.bits = (uint64_t*)calloc((nrow + 63) / 64 + 1, sizeof(uint64_t));
+    return selection;
+}
+
+size_t f32_selectionCount(const f32_selection_t* selection_p)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < (selection_p->nrow + 63) / 64; i++)
+    {   count += __builtin_popcountll(*(selection_p->bits + i));  }
+    return count;
+}
+
+void f32_freeSelection(f32_selection_t* selection_p)
+{
+    free(selection_p->bits);
+    selection_p->bits = NULL;
+    selection_p->nrow = 0;
+}
+
+static inline bool compareScalar(const float x, const f32_compare_t op, const float value)
+{
+    switch (op)
+    {
+        case F32_LT: return x < value;
+        case F32_LE: return x <= value;
+        case F32_GT: return x > value;
+        case F32_GE: return x >= value;
+        case F32_EQ: return x == value;
+        default: return x != value;
+    }
+}
+
+//Bits of the comparisons of the n floats at x, into (n + 63) / 64 words.
+static void scalarCompare(const float* x, size_t n, const f32_compare_t op, const float value, uint64_t* words)
+{
+    for (size_t i = 0; i < n; i += 64)
+    {
+        uint64_t word = 0;
+        for (size_t k = 0; k < 64 && i + k < n; k++)
+        {   word |= (uint64_t)compareScalar(*(x + i + k), op, value) << k;   }
+        *(words + i / 64) = word;
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("avx2")))
+static inline __m256 compare8(const __m256 x, const f32_compare_t op, const __m256 value)
+{
+    switch (op)
+    {
+        case F32_LT: return _mm256_cmp_ps(x, value, _CMP_LT_OQ);
+        case F32_LE: return _mm256_cmp_ps(x, value, _CMP_LE_OQ);
+        case F32_GT: return _mm256_cmp_ps(x, value, _CMP_GT_OQ);
+        case F32_GE: return _mm256_cmp_ps(x, value, _CMP_GE_OQ);
+        case F32_EQ: return _mm256_cmp_ps(x, value, _CMP_EQ_OQ);
+        default: return _mm256_cmp_ps(x, value, _CMP_NEQ_UQ);
+    }
+}
+
+//As scalarCompare, 8 floats per comparison, whose sign bits give 8 bits of a word.
+__attribute__((target("avx2")))
+static void avx2Compare(const float* x, size_t n, const f32_compare_t op, const float value, uint64_t* words)
+{
+    const __m256 values = _mm256_set1_ps(value);
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64)
+    {
+        uint64_t word = 0;
+        for (size_t k = 0; k < 64; k += 8)
+        {
+            const __m256 mask = compare8(_mm256_loadu_ps(x + i + k), op, values);
+            word |= (uint64_t)(unsigned)_mm256_movemask_ps(mask) << k;
+        }
+        *(words + i / 64) = word;
+    }
+    if (i < n)
+    {   scalarCompare(x + i, n - i, op, value, words + i / 64);  }
+}
+#endif
+
+static void (*compareBlock)(const float*, size_t, const f32_compare_t, const float, uint64_t*) = NULL;
+
+bool f32_queryUseAVX2(bool enable)
+{
+    compareBlock = scalarCompare;
+#if defined(__x86_64__) || defined(__i386__)
+    if (enable && __builtin_cpu_supports("avx2"))
+    {   compareBlock = avx2Compare; }
+#endif
+    return compareBlock != scalarCompare;
+}
+
+//The first query picks the comparisons once, whichever thread makes it.
+static pthread_once_t dispatchOnce = PTHREAD_ONCE_INIT;
+
+static void defaultDispatch(void)
+{
+    if (compareBlock == NULL)
+    {   f32_queryUseAVX2(true); }
+}
+
+void f32_where(f32_dataframe_t* data_p, const f32_predicate_t* predicates, const size_t nPredicates, bool matchAll, f32_selection_t* selection_p)
+{
+    pthread_once(&dispatchOnce, defaultDispatch);
+    for (size_t i = 0; i < nPredicates; i++)
+    {
+        if ((predicates + i)->col >= data_p->ncol)
+        {
+            printf("Column %zu is out of range. \n", (predicates + i)->col);
+            exit(1);
+        }
+    }
+
+    const size_t nWords = (data_p->nrow + 63) / 64;
+    if (nPredicates == 0)
+    {
+        memset(selection_p->bits, matchAll ? 0xFF : 0, sizeof(uint64_t) * nWords);
+        if (matchAll && data_p->nrow % 64)
+        {   *(selection_p->bits + nWords - 1) = ((uint64_t)1 << (data_p->nrow % 64)) - 1; }
+        return;
+    }
+
+    float* tile = (float*)malloc(sizeof(float) * QUERY_BLOCK_ROWS);
+    uint64_t matches[QUERY_BLOCK_ROWS / 64];
+    for (size_t first = 0; first < data_p->nrow; first += QUERY_BLOCK_ROWS)
+    {
+        const size_t n = data_p->nrow - first < QUERY_BLOCK_ROWS ? data_p->nrow - first : QUERY_BLOCK_ROWS;
+        uint64_t* words = selection_p->bits + first / 64;
+        for (size_t i = 0; i < nPredicates; i++)
+        {
+            const f32_predicate_t* predicate = predicates + i;
+            const float* column = data_p->data + first * data_p->rowStride + predicate->col * data_p->colStride;
+            if (data_p->rowStride != 1)
+            {
+                for (size_t k = 0; k < n; k++)
+                {   *(tile + k) = *(column + k * data_p->rowStride);   }
+                column = tile;
+            }
+            compareBlock(column, n, predicate->op, predicate->value, i ? matches : words);
+            for (size_t w = 0; i && w < (n + 63) / 64; w++)
+            {   *(words + w) = matchAll ? *(words + w) & matches[w] : *(words + w) | matches[w];  }
+        }
+    }
+    free(tile);
+}
+
+//FNV-1a.
+static size_t hashName(const char* p, size_t length)
+{
+    size_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; i++)
+    {   hash = (hash ^ (unsigned char)*(p + i)) * 1099511628211ULL;   }
+    return hash;
+}
+
+f32_nameIndex_t f32_buildNameIndex(f32_dataframe_t* data_p)
+{
+    f32_nameIndex_t index;
+    index.colNames = data_p->colNames;
+    index.colIndices = data_p->colIndices;
+    index.capacity = 16;
+    const size_t ncol = data_p->colIndices ? data_p->ncol : 0;
+    while (index.capacity < 2 * ncol)
+    {   index.capacity *= 2;    }
+    //Slots hold column + 1, and 0 when empty.
+    index.slots = (size_t*)calloc(index.capacity, sizeof(size_t));
+    for (size_t j = 0; j < ncol; j++)
+    {
+        const size_t start = *(data_p->colIndices + j), length = *(data_p->colIndices + j + 1) - start;
+        size_t slot = hashName(data_p->colNames + start, length) & (index.capacity - 1);
+        bool duplicate = false;
+        while (*(index.slots + slot) && !duplicate)
+        {
+            const size_t other = *(index.slots + slot) - 1;
+            const size_t otherStart = *(data_p->colIndices + other);
+            duplicate = *(data_p->colIndices + other + 1) - otherStart == length
+                        && memcmp(data_p->colNames + otherStart, data_p->colNames + start, length) == 0;
+            slot = duplicate ? slot : (slot + 1) & (index.capacity - 1);
+        }
+        if (!duplicate)
+        {   *(index.slots + slot) = j + 1;  }
+    }
+    return index;
+}
+
+size_t f32_findColumn(const f32_nameIndex_t* index_p, const char* name)
+{
+    const size_t length = strlen(name);
+    size_t slot = hashName(name, length) & (index_p->capacity - 1);
+    while (*(index_p->slots + slot))
+    {
+        const size_t col = *(index_p->slots + slot) - 1;
+        const size_t start = *(index_p->colIndices + col);
+        if (*(index_p->colIndices + col + 1) - start == length && memcmp(index_p->colNames + start, name, length) == 0)
+        {   return col; }
+        slot = (slot + 1) & (index_p->capacity - 1);
+    }
+    return F32_NO_COLUMN;
+}
+
+void f32_freeNameIndex(f32_nameIndex_t* index_p)
+{
+    free(index_p->slots);
+    index_p->slots = NULL;
+}
+
+f32_dataframe_t f32_project(f32_dataframe_t* data_p, const f32_nameIndex_t* index_p, const char** names, const size_t nNames, const f32_selection_t* selection_p)
+{
+    size_t* cols = (size_t*)malloc(sizeof(size_t) * (nNames + 1));
+    size_t nameBytes = 0;
+    for (size_t j = 0; j < nNames; j++)
+    {
+        *(cols + j) = f32_findColumn(index_p, *(names + j));
+        if (*(cols + j) == F32_NO_COLUMN)
+        {
+            printf("Column %s not found. \n", *(names + j));
+            exit(1);
+        }
+        nameBytes += strlen(*(names + j));
+    }
+
+    const size_t nrow = selection_p ? f32_selectionCount(selection_p) : data_p->nrow;
+    f32_dataframe_t projected = f32_newDataframe(nrow, nNames, F32_ROW_MAJOR);
+    projected.colNames = (char*)malloc(nameBytes + 1);
+    projected.colIndices = (size_t*)malloc(sizeof(size_t) * (nNames + 1));
+    *(projected.colIndices) = 0;
+    for (size_t j = 0; j < nNames; j++)
+    {
+        const size_t length = strlen(*(names + j));
+        memcpy(projected.colNames + *(projected.colIndices + j), *(names + j), length);
+        *(projected.colIndices + j + 1) = *(projected.colIndices + j) + length;
+    }
+    *(projected.colNames + nameBytes) = '\0';
+
+    float* out = projected.data;
+    for (size_t i = 0; i < data_p->nrow; i++)
+    {
+        if (selection_p && !f32_isSelected(selection_p, i))
+        {   continue;   }
+        for (size_t j = 0; j < nNames; j++)
+        {   *(out++) = *(data_p->data + i * data_p->rowStride + *(cols + j) * data_p->colStride); }
+    }
+    free(cols);
+    return projected;
+}
+
+//Hash of a key. -0 and 0 are equal, so they hash alike.
+static size_t hashKey(float key)
+{
+    uint32_t bits;
+    key = key == 0.0f ? 0.0f : key;
+    memcpy(&bits, &key, sizeof(bits));
+    return (size_t)bits * 0x9E3779B97F4A7C15ULL >> 20;
+}
+
+size_t f32_groupBy(f32_dataframe_t* data_p, const size_t keyCol, const size_t valueCol, const f32_selection_t* selection_p, f32_group_t** groups_p)
+{
+    if (keyCol >= data_p->ncol || valueCol >= data_p->ncol)
+    {
+        printf("Column %zu is out of range. \n", keyCol >= data_p->ncol ? keyCol : valueCol);
+        exit(1);
+    }
+
+    size_t nGroups = 0, groupCapacity = 16, capacity = 64;
+    f32_group_t* groups = (f32_group_t*)malloc(sizeof(f32_group_t) * groupCapacity);
+    //Slots hold group + 1, and 0 when empty.
+    size_t* slots = (size_t*)calloc(capacity, sizeof(size_t));
+    const float* keys = data_p->data + keyCol * data_p->colStride;
+    const float* values = data_p->data + valueCol * data_p->colStride;
+    const size_t nWords = (data_p->nrow + 63) / 64;
+    for (size_t w = 0; w < nWords; w++)
+    {
+        uint64_t word = selection_p ? *(selection_p->bits + w)
+                        : w + 1 < nWords || data_p->nrow % 64 == 0 ? ~(uint64_t)0 : ((uint64_t)1 << (data_p->nrow % 64)) - 1;
+        for (; word; word &= word - 1)
+        {
+            const size_t row = w * 64 + __builtin_ctzll(word);
+            const float key = *(keys + row * data_p->rowStride);
+            const float value = *(values + row * data_p->rowStride);
+            size_t slot = hashKey(key) & (capacity - 1);
+            while (*(slots + slot) && (groups + *(slots + slot) - 1)->key != key)
+            {   slot = (slot + 1) & (capacity - 1); }
+
+            if (*(slots + slot) == 0)
+            {
+                if (nGroups == groupCapacity)
+                {
+                    groupCapacity *= 2;
+                    groups = (f32_group_t*)realloc(groups, sizeof(f32_group_t) * groupCapacity);
+                }
+                f32_group_t* group = groups + nGroups;
+                group->key = key; group->count = 0; group->sum = 0.0;
+                group->min = value; group->max = value;
+                *(slots + slot) = ++nGroups;
+
+                //Keep the table at most half full.
+                if (nGroups * 2 > capacity)
+                {
+                    capacity *= 2;
+                    free(slots);
+                    slots = (size_t*)calloc(capacity, sizeof(size_t));
+                    for (size_t g = 0; g < nGroups; g++)
+                    {
+                        size_t s = hashKey((groups + g)->key) & (capacity - 1);
+                        while (*(slots + s))
+                        {   s = (s + 1) & (capacity - 1);   }
+                        *(slots + s) = g + 1;
+                    }
+                    slot = hashKey(key) & (capacity - 1);
+                    while (*(slots + slot) != nGroups)
+                    {   slot = (slot + 1) & (capacity - 1); }
+                }
+            }
+
+            f32_group_t* group = groups + *(slots + slot) - 1;
+            group->count++;
+            group->sum += value;
+            group->min = value < group->min ? value : group->min;
+            group->max = value > group->max ? value : group->max;
+        }
+    }
+    free(slots);
+    *groups_p = groups;
+    return nGroups;
+}
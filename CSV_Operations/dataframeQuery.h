@@ -0,0 +1,96 @@
+#ifndef DATAFRAMEQUERY_H
+#define DATAFRAMEQUERY_H
+
+#include "readCSV.h"
+#include<stdint.h>
+
+//Rows of a dataframe picked by a query, one bit per row in 64-bit words:
+//row i is bit i % 64 of word i / 64. Bits past nrow are always clear.
+typedef struct f32_selection
+{
+    uint64_t* bits;
+    size_t nrow;
+} f32_selection_t;
+
+//A selection of nrow rows with none selected.
+f32_selection_t f32_newSelection(const size_t nrow);
+size_t f32_selectionCount(const f32_selection_t* selection_p);
+void f32_freeSelection(f32_selection_t* selection_p);
+
+static inline bool f32_isSelected(const f32_selection_t* selection_p, const size_t row)
+{
+    return (*(selection_p->bits + row / 64) >> (row % 64)) & 1;
+}
+
+typedef enum f32_compare
+{
+    F32_LT,
+    F32_LE,
+    F32_GT,
+    F32_GE,
+    F32_EQ,
+    F32_NE
+} f32_compare_t;
+
+//The rows where column col compares to value. As in C, only F32_NE holds for NAN.
+typedef struct f32_predicate
+{
+    size_t col;
+    f32_compare_t op;
+    float value;
+} f32_predicate_t;
+
+//Select the rows that match all the predicates, or any of them if matchAll is
+//false, into selection_p, which must have data_p->nrow rows. The rows are
+//taken in blocks that stay in cache while every predicate is applied to them;
+//row-major columns are copied out of a block before they are compared. Each
+//comparison gives 8 bits at once with AVX2 when the CPU supports it.
+void f32_where(f32_dataframe_t* data_p, const f32_predicate_t* predicates, const size_t nPredicates, bool matchAll, f32_selection_t* selection_p);
+
+//Hash table from column name to column number.
+typedef struct f32_nameIndex
+{
+    const char* colNames;
+    const size_t* colIndices;
+    size_t* slots;
+    size_t capacity;
+} f32_nameIndex_t;
+
+#define F32_NO_COLUMN ((size_t)-1)
+
+//Index the names of a dataframe. The index borrows them, so it is rebuilt if
+//the dataframe is freed. A dataframe without names gives an empty index.
+f32_nameIndex_t f32_buildNameIndex(f32_dataframe_t* data_p);
+
+//Number of the first column called name, or F32_NO_COLUMN.
+size_t f32_findColumn(const f32_nameIndex_t* index_p, const char* name);
+void f32_freeNameIndex(f32_nameIndex_t* index_p);
+
+//A new row-major dataframe with the named columns, in the order given, of the
+//rows in selection_p, or of every row if it is NULL. Stops with an error if a
+//name is not found.
+f32_dataframe_t f32_project(f32_dataframe_t* data_p, const f32_nameIndex_t* index_p, const char** names, const size_t nNames, const f32_selection_t* selection_p);
+
+//Aggregates of the values of one column over the rows sharing a key.
+typedef struct f32_group
+{
+    float key;
+    size_t count;
+    double sum;
+    float min;
+    float max;
+} f32_group_t;
+
+//Group the rows in selection_p, or every row if it is NULL, by the value of
+//column keyCol, and aggregate column valueCol over each group with a hash
+//table. Keys that compare equal share a group, and each NAN is a group of its
+//own. The groups, in order of first appearance, go into a new array in
+//groups_p that the caller frees. Returns the number of groups.
+size_t f32_groupBy(f32_dataframe_t* data_p, const size_t keyCol, const size_t valueCol, const f32_selection_t* selection_p, f32_group_t** groups_p);
+
+//Choose between the AVX2 and the scalar comparisons. AVX2 is only used if the
+//CPU supports it, which is also the default, picked once by the first query.
+//Not to be called while queries run. Returns whether AVX2 is used.
+bool f32_queryUseAVX2(bool enable);
+
+#endif /* DATAFRAMEQUERY_H */
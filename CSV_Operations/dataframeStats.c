@@ -0,0 +1,456 @@
+#include "dataframeStats.h"
+#include<math.h>
+#include<pthread.h>
+#include<unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include "../Linking_Practice/mm256Extensions/mm256_extensions.h"
+#endif
+
+//Rows per block. A block of 16 columns centred in double is 128 KB.
+//Columns of a tile are TILE_STRIDE apart rather than a power of two, so that
+//a transposed row does not map all its columns to the same cache set.
+#define BLOCK_ROWS 1024
+#define TILE_STRIDE (BLOCK_ROWS + 16)
+
+//Moments of a set of values: its sum, mean, and sum of squared deviations from the mean.
+typedef struct moments
+{
+    size_t count;
+    double sum;
+    double mean;
+    double m2;
+    float min;
+    float max;
+} moments_t;
+
+//Work of one thread: the rows [firstRow, lastRow) of the columns [firstCol, lastCol).
+typedef struct stats_task
+{
+    f32_dataframe_t* data_p;
+    size_t firstRow, lastRow;
+    size_t firstCol, lastCol;
+    moments_t* moments;     //lastCol - firstCol entries, for f32_columnStats.
+    const double* means;    //ncol entries, for f32_covariance.
+    double* comoments;      //ncol x ncol, for f32_covariance.
+} stats_task_t;
+
+static void scalarMoments(const float* x, size_t n, moments_t* moments_p)
+{
+    double sum = 0.0;
+    float min = *x, max = *x;
+    for (size_t i = 0; i < n; i++)
+    {
+        sum += *(x + i);
+        min = *(x + i) < min ? *(x + i) : min;
+        max = *(x + i) > max ? *(x + i) : max;
+    }
+    const double mean = sum / n;
+    double m2 = 0.0;
+    for (size_t i = 0; i < n; i++)
+    {
+        const double deviation = *(x + i) - mean;
+        m2 += deviation * deviation;
+    }
+    moments_p->count = n; moments_p->sum = sum; moments_p->mean = mean;
+    moments_p->m2 = m2; moments_p->min = min; moments_p->max = max;
+}
+
+static void scalarCenter(const float* x, size_t n, double mean, double* out)
+{
+    for (size_t i = 0; i < n; i++)
+    {   *(out + i) = *(x + i) - mean;   }
+}
+
+static double scalarDot(const double* a, const double* b, size_t n)
+{
+    double dot = 0.0;
+    for (size_t i = 0; i < n; i++)
+    {   dot += *(a + i) * *(b + i); }
+    return dot;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+//As scalarMoments, 16 floats at a time. Each half of a register of 8 floats
+//is widened to 4 doubles, with separate accumulators to hide the add latency.
+__attribute__((target("avx2,fma")))
+static void avx2Moments(const float* x, size_t n, moments_t* moments_p)
+{
+    __m256d sum0 = _mm256_setzero_pd(), sum1 = _mm256_setzero_pd();
+    __m256d sum2 = _mm256_setzero_pd(), sum3 = _mm256_setzero_pd();
+    __m256 min = _mm256_set1_ps(*x), max = min;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        const __m256 a = _mm256_loadu_ps(x + i);
+        const __m256 b = _mm256_loadu_ps(x + i + 8);
+        min = _mm256_min_ps(min, _mm256_min_ps(a, b));
+        max = _mm256_max_ps(max, _mm256_max_ps(a, b));
+        sum0 = _mm256_add_pd(sum0, _mm256_cvtps_pd(_mm256_castps256_ps128(a)));
+        sum1 = _mm256_add_pd(sum1, _mm256_cvtps_pd(_mm256_extractf128_ps(a, 1)));
+        sum2 = _mm256_add_pd(sum2, _mm256_cvtps_pd(_mm256_castps256_ps128(b)));
+        sum3 = _mm256_add_pd(sum3, _mm256_cvtps_pd(_mm256_extractf128_ps(b, 1)));
+    }
+    __m256d sums = _mm256_add_pd(_mm256_add_pd(sum0, sum1), _mm256_add_pd(sum2, sum3));
+    double sum = _mm256_reduce_add_pd(&sums);
+    float minimum = _mm256_reduce_min_ps(&min), maximum = _mm256_reduce_max_ps(&max);
+    for (size_t j = i; j < n; j++)
+    {
+        sum += *(x + j);
+        minimum = *(x + j) < minimum ? *(x + j) : minimum;
+        maximum = *(x + j) > maximum ? *(x + j) : maximum;
+    }
+
+    const double mean = sum / n;
+    const __m256d means = _mm256_set1_pd(mean);
+    sum0 = _mm256_setzero_pd(); sum1 = _mm256_setzero_pd();
+    sum2 = _mm256_setzero_pd(); sum3 = _mm256_setzero_pd();
+    for (i = 0; i + 16 <= n; i += 16)
+    {
+        const __m256 a = _mm256_loadu_ps(x + i);
+        const __m256 b = _mm256_loadu_ps(x + i + 8);
+        const __m256d d0 = _mm256_sub_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(a)), means);
+        const __m256d d1 = _mm256_sub_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(a, 1)), means);
+        const __m256d d2 = _mm256_sub_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(b)), means);
+        const __m256d d3 = _mm256_sub_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(b, 1)), means);
+        sum0 = _mm256_fmadd_pd(d0, d0, sum0);
+        sum1 = _mm256_fmadd_pd(d1, d1, sum1);
+        sum2 = _mm256_fmadd_pd(d2, d2, sum2);
+        sum3 = _mm256_fmadd_pd(d3, d3, sum3);
+    }
+    sums = _mm256_add_pd(_mm256_add_pd(sum0, sum1), _mm256_add_pd(sum2, sum3));
+    double m2 = _mm256_reduce_add_pd(&sums);
+    for (; i < n; i++)
+    {
+        const double deviation = *(x + i) - mean;
+        m2 += deviation * deviation;
+    }
+    moments_p->count = n; moments_p->sum = sum; moments_p->mean = mean;
+    moments_p->m2 = m2; moments_p->min = minimum; moments_p->max = maximum;
+}
+
+__attribute__((target("avx2,fma")))
+static void avx2Center(const float* x, size_t n, double mean, double* out)
+{
+    const __m256d means = _mm256_set1_pd(mean);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m256 a = _mm256_loadu_ps(x + i);
+        _mm256_storeu_pd(out + i, _mm256_sub_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(a)), means));
+        _mm256_storeu_pd(out + i + 4, _mm256_sub_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(a, 1)), means));
+    }
+    for (; i < n; i++)
+    {   *(out + i) = *(x + i) - mean;   }
+}
+
+__attribute__((target("avx2,fma")))
+static double avx2Dot(const double* a, const double* b, size_t n)
+{
+    __m256d dot0 = _mm256_setzero_pd(), dot1 = _mm256_setzero_pd();
+    __m256d dot2 = _mm256_setzero_pd(), dot3 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        dot0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), dot0);
+        dot1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), dot1);
+        dot2 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8), dot2);
+        dot3 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12), dot3);
+    }
+    __m256d dots = _mm256_add_pd(_mm256_add_pd(dot0, dot1), _mm256_add_pd(dot2, dot3));
+    double dot = _mm256_reduce_add_pd(&dots);
+    for (; i < n; i++)
+    {   dot += *(a + i) * *(b + i); }
+    return dot;
+}
+#endif
+
+static void (*blockMoments)(const float*, size_t, moments_t*) = NULL;
+static void (*centerBlock)(const float*, size_t, double, double*) = NULL;
+static double (*dotBlock)(const double*, const double*, size_t) = NULL;
+
+bool f32_statsUseAVX2(bool enable)
+{
+    blockMoments = scalarMoments;
+    centerBlock = scalarCenter;
+    dotBlock = scalarDot;
+#if defined(__x86_64__) || defined(__i386__)
+    if (enable && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    {
+        blockMoments = avx2Moments;
+        centerBlock = avx2Center;
+        dotBlock = avx2Dot;
+    }
+#endif
+    return blockMoments != scalarMoments;
+}
+
+//The first call picks the kernels once, whichever thread makes it.
+static pthread_once_t dispatchOnce = PTHREAD_ONCE_INIT;
+
+static void defaultDispatch(void)
+{
+    if (blockMoments == NULL)
+    {   f32_statsUseAVX2(true); }
+}
+
+//Merge the moments of another set into moments_p.
+static void mergeMoments(moments_t* moments_p, const moments_t* other)
+{
+    if (other->count == 0)
+    {   return; }
+    if (moments_p->count == 0)
+    {
+        *moments_p = *other;
+        return;
+    }
+    const double count = (double)moments_p->count + other->count;
+    const double delta = other->mean - moments_p->mean;
+    moments_p->mean += delta * other->count / count;
+    moments_p->m2 += other->m2 + delta * delta * ((double)moments_p->count * other->count / count);
+    moments_p->sum += other->sum;
+    moments_p->count += other->count;
+    moments_p->min = other->min < moments_p->min ? other->min : moments_p->min;
+    moments_p->max = other->max > moments_p->max ? other->max : moments_p->max;
+}
+
+//Point columns[j - firstCol] at n contiguous rows from firstRow of column j.
+//Column-major data is used in place; row-major rows are transposed into tile,
+//which holds TILE_STRIDE floats per column.
+static void loadBlock(f32_dataframe_t* data_p, size_t firstRow, size_t n, size_t firstCol, size_t lastCol, float* tile, const float** columns)
+{
+    if (data_p->layout == F32_COLUMN_MAJOR)
+    {
+        for (size_t j = firstCol; j < lastCol; j++)
+        {   *(columns + j - firstCol) = data_p->data + j * data_p->colStride + firstRow;  }
+        return;
+    }
+    for (size_t i = 0; i < n; i++)
+    {
+        const float* row = data_p->data + (firstRow + i) * data_p->rowStride;
+        for (size_t j = firstCol; j < lastCol; j++)
+        {   *(tile + (j - firstCol) * TILE_STRIDE + i) = *(row + j);  }
+    }
+    for (size_t j = firstCol; j < lastCol; j++)
+    {   *(columns + j - firstCol) = tile + (j - firstCol) * TILE_STRIDE;  }
+}
+
+static void* momentsThread(void* task_p)
+{
+    stats_task_t* task = (stats_task_t*)task_p;
+    const size_t width = task->lastCol - task->firstCol;
+    float* tile = (float*)malloc(sizeof(float) * TILE_STRIDE * width);
+    const float** columns = (const float**)malloc(sizeof(float*) * width);
+    memset(task->moments, 0, sizeof(moments_t) * width);
+
+    for (size_t row = task->firstRow; row < task->lastRow; row += BLOCK_ROWS)
+    {
+        const size_t n = task->lastRow - row < BLOCK_ROWS ? task->lastRow - row : BLOCK_ROWS;
+        loadBlock(task->data_p, row, n, task->firstCol, task->lastCol, tile, columns);
+        for (size_t j = 0; j < width; j++)
+        {
+            moments_t block;
+            blockMoments(*(columns + j), n, &block);
+            mergeMoments(task->moments + j, &block);
+        }
+    }
+    free(tile);
+    free(columns);
+    return NULL;
+}
+
+//Co-moments of the columns [firstCol, lastCol) with every column after them,
+//into the upper triangle of comoments. Each block is centred into a tile of
+//doubles once, then every pair is a dot product over the tile.
+static void* comomentsThread(void* task_p)
+{
+    stats_task_t* task = (stats_task_t*)task_p;
+    const size_t ncol = task->data_p->ncol;
+    const size_t width = ncol - task->firstCol;
+    float* tile = (float*)malloc(sizeof(float) * TILE_STRIDE * width);
+    double* centred = (double*)malloc(sizeof(double) * TILE_STRIDE * width);
+    const float** columns = (const float**)malloc(sizeof(float*) * width);
+    memset(task->comoments, 0, sizeof(double) * ncol * ncol);
+
+    for (size_t row = task->firstRow; row < task->lastRow; row += BLOCK_ROWS)
+    {
+        const size_t n = task->lastRow - row < BLOCK_ROWS ? task->lastRow - row : BLOCK_ROWS;
+        loadBlock(task->data_p, row, n, task->firstCol, ncol, tile, columns);
+        for (size_t j = 0; j < width; j++)
+        {   centerBlock(*(columns + j), n, *(task->means + task->firstCol + j), centred + j * TILE_STRIDE);  }
+        for (size_t j = task->firstCol; j < task->lastCol; j++)
+        {
+            const double* a = centred + (j - task->firstCol) * TILE_STRIDE;
+            for (size_t k = j; k < ncol; k++)
+            {   *(task->comoments + j * ncol + k) += dotBlock(a, centred + (k - task->firstCol) * TILE_STRIDE, n);   }
+        }
+    }
+    free(tile);
+    free(centred);
+    free(columns);
+    return NULL;
+}
+
+//Cut the dataframe into tasks: one range of whole blocks of rows per thread,
+//and when there are fewer blocks than threads, ranges of columns as well.
+//Returns the number of tasks; rowParts receives the number of row ranges.
+static size_t planTasks(f32_dataframe_t* data_p, unsigned nThreads, stats_task_t** tasks_p, size_t* rowParts)
+{
+    if (nThreads == 0)
+    {   nThreads = (unsigned)sysconf(_SC_NPROCESSORS_ONLN); }
+    const size_t nBlocks = (data_p->nrow + BLOCK_ROWS - 1) / BLOCK_ROWS;
+    *rowParts = nBlocks < nThreads ? (nBlocks ? nBlocks : 1) : nThreads;
+    size_t colParts = nThreads / *rowParts;
+    if (colParts > data_p->ncol)
+    {   colParts = data_p->ncol ? data_p->ncol : 1;    }
+
+    stats_task_t* tasks = (stats_task_t*)calloc(*rowParts * colParts, sizeof(stats_task_t));
+    for (size_t c = 0; c < colParts; c++)
+    {
+        for (size_t r = 0; r < *rowParts; r++)
+        {
+            stats_task_t* task = tasks + c * *rowParts + r;
+            task->data_p = data_p;
+            task->firstRow = nBlocks * r / *rowParts * BLOCK_ROWS;
+            task->lastRow = nBlocks * (r + 1) / *rowParts * BLOCK_ROWS;
+            task->lastRow = task->lastRow < data_p->nrow ? task->lastRow : data_p->nrow;
+            task->firstCol = data_p->ncol * c / colParts;
+            task->lastCol = data_p->ncol * (c + 1) / colParts;
+        }
+    }
+    *tasks_p = tasks;
+    return *rowParts * colParts;
+}
+
+//Run a thread per task, or the only task on this thread.
+static void runTasks(void* (*work)(void*), stats_task_t* tasks, size_t nTasks)
+{
+    if (nTasks == 1)
+    {
+        work(tasks);
+        return;
+    }
+    pthread_t* threads = (pthread_t*)malloc(sizeof(pthread_t) * nTasks);
+    for (size_t i = 0; i < nTasks; i++)
+    {   pthread_create(threads + i, NULL, work, tasks + i);   }
+    for (size_t i = 0; i < nTasks; i++)
+    {   pthread_join(*(threads + i), NULL);   }
+    free(threads);
+}
+
+void f32_columnStats(f32_dataframe_t* data_p, f32_colStats_t* stats_p, unsigned nThreads)
+{
+    pthread_once(&dispatchOnce, defaultDispatch);
+
+    const size_t ncol = data_p->ncol;
+    moments_t* moments = (moments_t*)calloc(ncol ? ncol : 1, sizeof(moments_t));
+    stats_task_t* tasks;
+    size_t rowParts;
+    const size_t nTasks = planTasks(data_p, nThreads, &tasks, &rowParts);
+    for (size_t i = 0; i < nTasks; i++)
+    {   (tasks + i)->moments = (moments_t*)malloc(sizeof(moments_t) * ((tasks + i)->lastCol - (tasks + i)->firstCol + 1));    }
+    runTasks(momentsThread, tasks, nTasks);
+
+    //Merge the row ranges of each column in row order.
+    for (size_t i = 0; i < nTasks; i++)
+    {
+        for (size_t j = (tasks + i)->firstCol; j < (tasks + i)->lastCol; j++)
+        {   mergeMoments(moments + j, (tasks + i)->moments + j - (tasks + i)->firstCol); }
+        free((tasks + i)->moments);
+    }
+    free(tasks);
+
+    for (size_t j = 0; j < ncol; j++)
+    {
+        const moments_t* column = moments + j;
+        (stats_p + j)->count = column->count;
+        (stats_p + j)->sum = column->sum;
+        (stats_p + j)->mean = column->mean;
+        (stats_p + j)->variance = column->count > 1 ? column->m2 / (column->count - 1) : 0.0;
+        (stats_p + j)->min = column->min;
+        (stats_p + j)->max = column->max;
+    }
+    free(moments);
+}
+
+void f32_mergeColStats(f32_colStats_t* stats_p, const f32_colStats_t* more_p, size_t ncol)
+{
+    for (size_t j = 0; j < ncol; j++)
+    {
+        f32_colStats_t* column = stats_p + j;
+        const f32_colStats_t* more = more_p + j;
+        moments_t merged = { column->count, column->sum, column->mean,
+                             column->count > 1 ? column->variance * (column->count - 1) : 0.0, column->min, column->max };
+        const moments_t other = { more->count, more->sum, more->mean,
+                                  more->count > 1 ? more->variance * (more->count - 1) : 0.0, more->min, more->max };
+        mergeMoments(&merged, &other);
+        column->count = merged.count;
+        column->sum = merged.sum;
+        column->mean = merged.mean;
+        column->variance = merged.count > 1 ? merged.m2 / (merged.count - 1) : 0.0;
+        column->min = merged.min;
+        column->max = merged.max;
+    }
+}
+
+void f32_covariance(f32_dataframe_t* data_p, double* cov_p, unsigned nThreads)
+{
+    const size_t ncol = data_p->ncol;
+    if (ncol == 0)
+    {   return; }
+    f32_colStats_t* stats = (f32_colStats_t*)malloc(sizeof(f32_colStats_t) * ncol);
+    f32_columnStats(data_p, stats, nThreads);
+    double* means = (double*)malloc(sizeof(double) * ncol);
+    for (size_t j = 0; j < ncol; j++)
+    {   *(means + j) = (stats + j)->mean;  }
+
+    stats_task_t* tasks;
+    size_t rowParts;
+    const size_t nTasks = planTasks(data_p, nThreads, &tasks, &rowParts);
+    for (size_t i = 0; i < nTasks; i++)
+    {
+        (tasks + i)->means = means;
+        (tasks + i)->comoments = (double*)malloc(sizeof(double) * ncol * ncol);
+    }
+    runTasks(comomentsThread, tasks, nTasks);
+
+    memset(cov_p, 0, sizeof(double) * ncol * ncol);
+    for (size_t i = 0; i < nTasks; i++)
+    {
+        for (size_t j = (tasks + i)->firstCol; j < (tasks + i)->lastCol; j++)
+        {
+            for (size_t k = j; k < ncol; k++)
+            {   *(cov_p + j * ncol + k) += *((tasks + i)->comoments + j * ncol + k);    }
+        }
+        free((tasks + i)->comoments);
+    }
+    const double divisor = data_p->nrow > 1 ? (double)(data_p->nrow - 1) : 0.0;
+    for (size_t j = 0; j < ncol; j++)
+    {
+        for (size_t k = j; k < ncol; k++)
+        {
+            *(cov_p + j * ncol + k) = divisor > 0.0 ? *(cov_p + j * ncol + k) / divisor : 0.0;
+            *(cov_p + k * ncol + j) = *(cov_p + j * ncol + k);
+        }
+    }
+    free(tasks);
+    free(means);
+    free(stats);
+}
+
+void f32_correlation(f32_dataframe_t* data_p, double* corr_p, unsigned nThreads)
+{
+    const size_t ncol = data_p->ncol;
+    f32_covariance(data_p, corr_p, nThreads);
+    double* deviations = (double*)malloc(sizeof(double) * (ncol ? ncol : 1));
+    for (size_t j = 0; j < ncol; j++)
+    {   *(deviations + j) = sqrt(*(corr_p + j * ncol + j));    }
+    for (size_t j = 0; j < ncol; j++)
+    {
+        for (size_t k = 0; k < ncol; k++)
+        {
+            const double scale = *(deviations + j) * *(deviations + k);
+            *(corr_p + j * ncol + k) = scale > 0.0 ? *(corr_p + j * ncol + k) / scale : NAN;
+        }
+    }
+    free(deviations);
+}
@@ -0,0 +1,46 @@
+#ifndef DATAFRAMESTATS_H
+#define DATAFRAMESTATS_H
+
+#include "readCSV.h"
+
+//Summary of one column. Sums and moments are accumulated in double.
+//Without rows every field is 0, and the variance is 0 with fewer than 2 rows.
+typedef struct f32_colStats
+{
+    size_t count;
+    double sum;
+    double mean;
+    double variance;    //Sample variance, divided by count - 1.
+    float min;
+    float max;
+} f32_colStats_t;
+
+//Statistics of every column, into stats_p which must hold ncol entries.
+//The rows are cut into blocks that are small enough to stay in cache. The
+//moments of each block are taken around the block's own mean and merged with
+//Welford's update for pairs of sets (Chan et al.), so that large offsets in
+//the data do not cancel. The work is split across nThreads threads by blocks
+//of rows, and by columns when there are fewer blocks than threads. Passing 0
+//uses one thread per online CPU. Either layout is accepted.
+void f32_columnStats(f32_dataframe_t* data_p, f32_colStats_t* stats_p, unsigned nThreads);
+
+//Add the statistics of more rows of the same columns, such as the next batch
+//of a f32_csvStream_t, to stats_p, as if all the rows had been in one dataframe.
+//stats_p starts zeroed.
+void f32_mergeColStats(f32_colStats_t* stats_p, const f32_colStats_t* more_p, size_t ncol);
+
+//Sample covariance matrix, into the ncol x ncol row-major matrix cov_p. The
+//column means are computed first and the products taken around them.
+void f32_covariance(f32_dataframe_t* data_p, double* cov_p, unsigned nThreads);
+
+//Correlation matrix, into the ncol x ncol row-major matrix corr_p. Pairs with
+//a column of zero variance are NAN.
+void f32_correlation(f32_dataframe_t* data_p, double* corr_p, unsigned nThreads);
+
+//Choose between the AVX2/FMA and the scalar kernels. AVX2 is only used if the
+//CPU supports AVX2 and FMA, which is also the default, picked once by the first
+//call. Not to be called while the statistics are computed. Returns whether AVX2
+//is used.
+bool f32_statsUseAVX2(bool enable);
+
+#endif /* DATAFRAMESTATS_H */
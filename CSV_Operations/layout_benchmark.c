@@ -0,0 +1,96 @@
+#include "readCSV.h"
+#include "benchmarkUtils.h"
+
+#define BENCHMARK_COLUMNS 16
+
+//Sum every column with a strided walk over row-major data.
+static double sumStrided(f32_dataframe_t* data_p)
+{
+    double total = 0.0;
+    for (size_t j = 0; j < data_p->ncol; j++)
+    {
+        float sum = 0.0f;
+        for (size_t i = 0; i < data_p->nrow; i++)
+        {   sum += *(data_p->data + i * data_p->rowStride + j);  }
+        total += sum;
+    }
+    return total;
+}
+
+//Sum every column through the copy f32_getCol returns.
+static double sumCopies(f32_dataframe_t* data_p)
+{
+    double total = 0.0;
+    for (size_t j = 0; j < data_p->ncol; j++)
+    {
+        float* col = f32_getCol(data_p, j);
+        float sum = 0.0f;
+        for (size_t i = 0; i < data_p->nrow; i++)
+        {   sum += col[i];  }
+        total += sum;
+        free(col);
+    }
+    return total;
+}
+
+//Sum every column of column-major data in place. The padding is zero, so the
+//loop runs over whole groups of F32_COLUMN_PAD floats with no remainder, and
+//each lane of the group keeps its own sum.
+static double sumColumns(f32_dataframe_t* data_p)
+{
+    double total = 0.0;
+    for (size_t j = 0; j < data_p->ncol; j++)
+    {
+        const float* col = f32_colPointer(data_p, j);
+        float lanes[F32_COLUMN_PAD] = { 0.0f };
+        for (size_t i = 0; i < data_p->colStride; i += F32_COLUMN_PAD)
+        {
+            for (size_t k = 0; k < F32_COLUMN_PAD; k++)
+            {   lanes[k] += col[i + k]; }
+        }
+        float sum = 0.0f;
+        for (size_t k = 0; k < F32_COLUMN_PAD; k++)
+        {   sum += lanes[k];    }
+        total += sum;
+    }
+    return total;
+}
+
+//Takes the number of rows as an optional argument.
+int main(int argc, char** argv)
+{
+    const size_t nrow = argc > 1 ? (size_t)atol(argv[1]) : 4000000;
+    const double gigaBytes = sizeof(float) * nrow * BENCHMARK_COLUMNS / 1e9;
+
+    f32_dataframe_t data = f32_newDataframe(nrow, BENCHMARK_COLUMNS, F32_ROW_MAJOR);
+    srand(9999);
+    for (size_t i = 0; i < nrow * BENCHMARK_COLUMNS; i++)
+    {   *(data.data + i) = (float)(rand() % 1000) / 100.0f;  }
+
+    printf("%zu rows x %d columns, %.3f GB \n", nrow, BENCHMARK_COLUMNS, gigaBytes);
+    double start = seconds();
+    const double strided = sumStrided(&data);
+    const double stridedTime = seconds() - start;
+
+    start = seconds();
+    const double copied = sumCopies(&data);
+    const double copiedTime = seconds() - start;
+
+    start = seconds();
+    f32_toColumnMajor(&data);
+    const double convertTime = seconds() - start;
+
+    start = seconds();
+    const double columns = sumColumns(&data);
+    const double columnsTime = seconds() - start;
+
+    printf("Column sums, GB/s of data scanned: \n");
+    printf("  row-major, strided:       %.3f \n", gigaBytes / stridedTime);
+    printf("  row-major, f32_getCol:    %.3f \n", gigaBytes / copiedTime);
+    printf("  column-major, in place:   %.3f \n", gigaBytes / columnsTime);
+    printf("Conversion to column-major: %.3f GB/s \n", gigaBytes / convertTime);
+    printf("(totals %.6g, %.6g, %.6g) \n", strided, copied, columns);
+
+    f32_freeCSV(&data);
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include "readCSV.h"
+#include "dataframeQuery.h"
+#include "benchmarkUtils.h"
+
+#define BENCHMARK_COLUMNS 16
+#define BENCHMARK_KEYS 64
+
+//Column j is called c<j>.
+static void nameColumns(f32_dataframe_t* data_p)
+{
+    data_p->colNames = (char*)malloc(4 * data_p->ncol + 1);
+    data_p->colIndices = (size_t*)malloc(sizeof(size_t) * (data_p->ncol + 1));
+    *(data_p->colIndices) = 0;
+    for (size_t j = 0; j < data_p->ncol; j++)
+    {
+        const int length = sprintf(data_p->colNames + *(data_p->colIndices + j), "c%zu", j);
+        *(data_p->colIndices + j + 1) = *(data_p->colIndices + j) + length;
+    }
+}
+
+//The ad-hoc way: find the columns by walking colNames, as f32_printColumnNames does.
+static size_t linearFind(f32_dataframe_t* data_p, const char* name)
+{
+    for (size_t j = 0; j < data_p->ncol; j++)
+    {
+        const size_t start = *(data_p->colIndices + j), length = *(data_p->colIndices + j + 1) - start;
+        if (strlen(name) == length && memcmp(data_p->colNames + start, name, length) == 0)
+        {   return j;   }
+    }
+    return F32_NO_COLUMN;
+}
+
+//SELECT c2, c5, c9 WHERE c3 < 500 AND c7 >= 100, and the sum of c5 grouped by
+//c1, a row at a time through f32_getRow. Returns the number of rows selected.
+static size_t naiveQuery(f32_dataframe_t* data_p, f32_dataframe_t* projected_p, double* sums, size_t* counts)
+{
+    size_t nSelected = 0;
+    for (size_t i = 0; i < data_p->nrow; i++)
+    {
+        float* row = f32_getRow(data_p, i);
+        if (row[linearFind(data_p, "c3")] < 500.0f && row[linearFind(data_p, "c7")] >= 100.0f)
+        {
+            const size_t key = (size_t)row[linearFind(data_p, "c1")];
+            sums[key] += row[linearFind(data_p, "c5")];
+            counts[key]++;
+            float* out = projected_p->data + nSelected * 3;
+            out[0] = row[linearFind(data_p, "c2")];
+            out[1] = row[linearFind(data_p, "c5")];
+            out[2] = row[linearFind(data_p, "c9")];
+            nSelected++;
+        }
+        free(row);
+    }
+    return nSelected;
+}
+
+//Runs both queries on data_p and checks they agree.
+static void compare(f32_dataframe_t* data_p, const char* label)
+{
+    double naiveSums[BENCHMARK_KEYS] = { 0.0 };
+    size_t naiveCounts[BENCHMARK_KEYS] = { 0 };
+    f32_dataframe_t naive = f32_newDataframe(data_p->nrow, 3, F32_ROW_MAJOR);
+    double start = seconds();
+    const size_t nNaive = naiveQuery(data_p, &naive, naiveSums, naiveCounts);
+    const double naiveTime = seconds() - start;
+
+    const char* names[] = { "c2", "c5", "c9" };
+    start = seconds();
+    f32_nameIndex_t index = f32_buildNameIndex(data_p);
+    const f32_predicate_t predicates[] = { { f32_findColumn(&index, "c3"), F32_LT, 500.0f },
+                                           { f32_findColumn(&index, "c7"), F32_GE, 100.0f } };
+    f32_selection_t selection = f32_newSelection(data_p->nrow);
+    f32_where(data_p, predicates, 2, true, &selection);
+    f32_group_t* groups;
+    const size_t nGroups = f32_groupBy(data_p, f32_findColumn(&index, "c1"), f32_findColumn(&index, "c5"), &selection, &groups);
+    f32_dataframe_t projected = f32_project(data_p, &index, names, 3, &selection);
+    const double engineTime = seconds() - start;
+
+    bool same = projected.nrow == nNaive && memcmp(projected.data, naive.data, sizeof(float) * 3 * nNaive) == 0;
+    size_t nNaiveGroups = 0;
+    for (size_t k = 0; k < BENCHMARK_KEYS; k++)
+    {   nNaiveGroups += naiveCounts[k] > 0; }
+    same = same && nGroups == nNaiveGroups;
+    for (size_t g = 0; g < nGroups; g++)
+    {
+        const size_t key = (size_t)(groups + g)->key;
+        same = same && (groups + g)->count == naiveCounts[key] && (groups + g)->sum == naiveSums[key];
+    }
+
+    printf("%-13s naive: %9.3f ms, engine: %8.3f ms, %6.1fx, %zu rows and %zu groups, %s \n", label,
+           naiveTime * 1e3, engineTime * 1e3, naiveTime / engineTime, nNaive, nGroups, same ? "same results" : "RESULTS DIFFER");
+
+    free(groups);
+    f32_freeCSV(&projected);
+    f32_freeSelection(&selection);
+    f32_freeNameIndex(&index);
+    f32_freeCSV(&naive);
+}
+
+//Takes the number of rows as an optional argument.
+int main(int argc, char** argv)
+{
+    const size_t nrow = argc > 1 ? (size_t)atol(argv[1]) : 4000000;
+    f32_dataframe_t data = f32_newDataframe(nrow, BENCHMARK_COLUMNS, F32_ROW_MAJOR);
+    nameColumns(&data);
+    srand(9999);
+    for (size_t i = 0; i < nrow; i++)
+    {
+        for (size_t j = 0; j < BENCHMARK_COLUMNS; j++)
+        {   *(data.data + i * BENCHMARK_COLUMNS + j) = j == 1 ? (float)(rand() % BENCHMARK_KEYS) : (float)(rand() % 1000);  }
+    }
+
+    printf("%zu rows, %d columns: SELECT c2, c5, c9 WHERE c3 < 500 AND c7 >= 100, SUM(c5) GROUP BY c1 \n", nrow, BENCHMARK_COLUMNS);
+    f32_queryUseAVX2(false);
+    compare(&data, "Row-major:");
+    f32_queryUseAVX2(true);
+    compare(&data, "+ AVX2:");
+    f32_toColumnMajor(&data);
+    f32_queryUseAVX2(false);
+    compare(&data, "Column-major:");
+    f32_queryUseAVX2(true);
+    compare(&data, "+ AVX2:");
+
+    f32_freeCSV(&data);
+    return 0;
+}
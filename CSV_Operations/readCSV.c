@@ -1,183 +1,773 @@
-#include<stdio.h>
-#include<stdlib.h>
-#include<string.h>
-#include<stdbool.h>
-
-#define NEW_LINE printf("\n");
-
-//Adjust according to .csv row size.
-//Not enforced in the program.
-#define MAX_BUFFER 10000
-#define MAX_COLUMNS 1000
-typedef const unsigned int index_t;
-
-typedef struct f32_dataframe
-{
-    char* colNames;
-    size_t* colIndices;
-    float* data;
-    size_t nrow;
-    size_t ncol;
-} f32_dataframe_t;
-
-f32_dataframe_t f32_readCSV(const char* fileName, index_t memAlloc, bool hasHeader)
-{
-    FILE* file_p = fopen(fileName, "r");
-    if (file_p == NULL)
-    {
-        printf("%s failed to open. \n", fileName);
-        exit(1);
-    }
-
-    f32_dataframe_t dataframe;
-    
-    if (hasHeader)
-    {
-        char columns[MAX_BUFFER] ; size_t indices[MAX_COLUMNS];
-        indices[0] = 0;
-        size_t nrow = 0, ncol = 0;
-        size_t colStartIndex = 0, strLength;
-        fgets(columns, MAX_BUFFER, file_p);
-        char* token = strtok(columns, ",");
-        while (token != NULL)
-        {   
-            strLength = strlen(token);
-            indices[colStartIndex + 1] =  strLength + indices[colStartIndex]; 
-            for (size_t i = 0; i < strLength; i++)
-            {
-                *(columns + indices[colStartIndex] + i) = *(token + i);
-            }
-            colStartIndex++;
-            token = strtok(NULL, ",");
-        }
-        indices[colStartIndex]--; 
-        index_t nullIndex = indices[colStartIndex]; 
-        *(columns + nullIndex) = '\0'; 
-        dataframe.colNames = (char*)malloc(nullIndex);
-        strcpy(dataframe.colNames, columns);
-        index_t nBytes = sizeof(size_t) * (colStartIndex + 1);
-        dataframe.colIndices = (size_t*)malloc(nBytes);
-        memcpy(dataframe.colIndices, indices, nBytes);
-    }
-    else
-    {   dataframe.colNames = NULL; dataframe.colIndices = NULL; }
-    
-    float* data = (float*)malloc(sizeof(float) * memAlloc);
-    size_t elemCounter = 0, nrow = 0, ncol = 0;
-    char line[MAX_BUFFER]; char* token;
-    while (fgets(line, MAX_BUFFER, file_p) != NULL)
-    {   
-        nrow++;
-        token = strtok(line, ",");
-        while (token != NULL)
-        {   
-            *(data + elemCounter) = strtof(token, NULL);
-            elemCounter++;
-            token = strtok(NULL, ",");
-        }
-    }
-    fclose(file_p);
-    nrow--;
-    ncol = elemCounter / nrow;
-
-    dataframe.data = data;
-    dataframe.nrow = nrow; dataframe.ncol = ncol;
-    return dataframe;
-}
-
-void f32_freeCSV(f32_dataframe_t* data_p)
-{
-    free(data_p->colNames);
-    free(data_p->colIndices);
-    free(data_p->data);
-}
-
-void f32_printColumnNames(f32_dataframe_t* data_p)
-{
-    size_t start, end;
-    for (size_t i = 0; i < data_p->ncol; i++)
-    {   
-        start = *(data_p->colIndices + i); end = *(data_p->colIndices + i + 1); 
-        for (size_t j = start; j < end; j++)
-        {   printf("%c", *(data_p->colNames + j));  }
-        printf(" ");
-    } 
-    NEW_LINE;
-}
-
-void f32_printData(f32_dataframe_t* data_p)
-{
-    for (size_t i = 0; i < data_p->nrow; i++)
-    {   
-        for (size_t j = 0; j < data_p->ncol; j++)
-        {   printf("%f ", *(data_p->data + i*data_p->ncol + j));  }
-        NEW_LINE;
-    }
-}
-
-float* f32_getRow(f32_dataframe_t* data_p, const size_t row)
-{
-    float* row_p;
-    if (row < data_p->nrow)
-    {
-        const size_t ncol = data_p->ncol;
-        row_p = (float*)malloc(sizeof(float) * ncol);
-        for (size_t i = 0; i < ncol; i++)
-        {   row_p[i] = *(data_p->data + (row * ncol) + i);  }
-    }
-    else
-    {   row_p = NULL;   }
-    return row_p;
-}
-
-float* f32_getCol(f32_dataframe_t* data_p, const size_t col)
-{
-    float* col_p;
-    if (col < data_p->ncol)
-    {
-        const size_t nrow = data_p->nrow;
-        col_p = (float*)malloc(sizeof(float) * nrow);
-        for (size_t i = 0; i < nrow; i++)
-        {   col_p[i] = *(data_p->data + (i * data_p->ncol) + col);  }
-    }
-    else
-    {   col_p = NULL;   }
-    return col_p;
-}
-
-int main(void)
-{   
-    const char* fileName = "/path/to/numbers.txt";
-    //memAlloc can be larger than the actual number of elements in the .csv file, but not smaller.
-    index_t memAlloc = 100; bool hasHeader = true;
-    
-    f32_dataframe_t data = f32_readCSV(fileName, memAlloc, hasHeader);
-    
-    f32_printColumnNames(&data);
-
-    f32_printData(&data);
-
-    float* row1 = f32_getRow(&data, 1);
-    if (row1)
-    {   
-        printf("Row 1: \n");
-        for (size_t i = 0; i < data.ncol; i++)
-        {   printf("%f ", row1[i]); }
-        NEW_LINE;
-    }
-
-    float* col4 = f32_getCol(&data, 4);
-    if (col4)
-    {
-        printf("Column 4: \n");
-        for (size_t i = 0; i < data.nrow; i++)
-        {   printf("%f ", col4[i]); }
-        NEW_LINE;
-    }
-
-    f32_freeCSV(&data);
-    free(row1);
-    free(col4);
-    
-    return 0;
-}
+#include "readCSV.h"
+#include "csvParse.h"
+#include<fcntl.h>
+#include<pthread.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
+
+static void setRowMajor(f32_dataframe_t* data_p)
+{
+    data_p->layout = F32_ROW_MAJOR;
+    data_p->rowStride = data_p->ncol;
+    data_p->colStride = 1;
+}
+
+//Floats per column of column-major data with nrow rows.
+static size_t paddedRows(const size_t nrow)
+{
+    return (nrow + F32_COLUMN_PAD - 1) / F32_COLUMN_PAD * F32_COLUMN_PAD;
+}
+
+//True for tokens made only of blanks and line ends, which are not fields.
+static bool isBlankToken(const char* token)
+{
+    while (*token == ' ' || *token == '\t' || *token == '\r' || *token == '\n')
+    {   token++;    }
+    return *token == '\0';
+}
+
+//Every row must have as many fields as the header, or as the first row if
+//there is no header.
+static void checkRowWidth(const char* fileName, const size_t row, const size_t rowWidth, const size_t ncol)
+{
+    if (rowWidth != ncol)
+    {
+        printf("%s: row %zu has %zu columns instead of %zu. \n", fileName, row, rowWidth, ncol);
+        exit(1);
+    }
+}
+
+f32_dataframe_t f32_readCSV(const char* fileName, index_t memAlloc, bool hasHeader)
+{
+    FILE* file_p = fopen(fileName, "r");
+    if (file_p == NULL)
+    {
+        printf("%s failed to open. \n", fileName);
+        exit(1);
+    }
+
+    f32_dataframe_t dataframe;
+    dataframe.mapping = NULL; dataframe.mappedBytes = 0;
+    size_t ncol = 0;
+    
+    if (hasHeader)
+    {
+        char columns[MAX_BUFFER] ; size_t indices[MAX_COLUMNS];
+        indices[0] = 0;
+        size_t colStartIndex = 0, strLength;
+        fgets(columns, MAX_BUFFER, file_p);
+        char* token = strtok(columns, ",");
+        while (token != NULL)
+        {   
+            strLength = strlen(token);
+            indices[colStartIndex + 1] =  strLength + indices[colStartIndex]; 
+            for (size_t i = 0; i < strLength; i++)
+            {
+                *(columns + indices[colStartIndex] + i) = *(token + i);
+            }
+            colStartIndex++;
+            token = strtok(NULL, ",");
+        }
+        indices[colStartIndex]--; 
+        index_t nullIndex = indices[colStartIndex]; 
+        *(columns + nullIndex) = '\0'; 
+        dataframe.colNames = (char*)malloc(nullIndex + 1);
+        strcpy(dataframe.colNames, columns);
+        index_t nBytes = sizeof(size_t) * (colStartIndex + 1);
+        dataframe.colIndices = (size_t*)malloc(nBytes);
+        memcpy(dataframe.colIndices, indices, nBytes);
+        ncol = colStartIndex;
+    }
+    else
+    {   dataframe.colNames = NULL; dataframe.colIndices = NULL; }
+    
+    //memAlloc is only the starting capacity. The data grows geometrically and
+    //is trimmed to its final size, so it never has to be overestimated.
+    size_t capacity = memAlloc ? memAlloc : 1024;
+    float* data = (float*)malloc(sizeof(float) * capacity);
+    size_t elemCounter = 0, nrow = 0, rowWidth;
+    char line[MAX_BUFFER]; char* token;
+    while (fgets(line, MAX_BUFFER, file_p) != NULL)
+    {   
+        rowWidth = 0;
+        token = strtok(line, ",");
+        while (token != NULL)
+        {   
+            if (!isBlankToken(token))
+            {
+                if (elemCounter == capacity)
+                {
+                    capacity *= 2;
+                    data = (float*)realloc(data, sizeof(float) * capacity);
+                }
+                *(data + elemCounter) = strtof(token, NULL);
+                elemCounter++;
+                rowWidth++;
+            }
+            token = strtok(NULL, ",");
+        }
+        if (rowWidth == 0)
+        {   continue;   }
+        //Without a header, the first row sets the width.
+        if (ncol == 0)
+        {   ncol = rowWidth;    }
+        checkRowWidth(fileName, nrow, rowWidth, ncol);
+        nrow++;
+    }
+    fclose(file_p);
+    if (elemCounter)
+    {   data = (float*)realloc(data, sizeof(float) * elemCounter);  }
+
+    dataframe.data = data;
+    dataframe.nrow = nrow; dataframe.ncol = ncol;
+    setRowMajor(&dataframe);
+    return dataframe;
+}
+
+//Rows in [start, stop) of a mapping that ends at 'end', parsed by one thread
+//into its own buffer and then copied to 'slice', its part of the final data.
+//Every row must have ncol fields; parsing stops at the first one that does
+//not, and badWidth records its width.
+typedef struct csv_chunk
+{
+    const char* start;
+    const char* stop;
+    const char* end;
+    size_t ncol;
+    float* data;
+    size_t nElements;
+    size_t nrow;
+    size_t badWidth;
+    float* slice;
+} csv_chunk_t;
+
+//Parse the rows of a chunk into a row-major array of floats. Blank lines are
+//not counted as rows. A chunk starts at the beginning of a line and ends just
+//after a newline or at the end of the mapping.
+static void parseChunk(csv_chunk_t* chunk_p)
+{
+    const char* p = chunk_p->start;
+    const char* end = chunk_p->stop;
+    //Assume about 8 bytes per field and grow geometrically from there.
+    size_t capacity = (end - p) / 8 + 1024, elemCounter = 0, nrow = 0, rowStart = 0;
+    chunk_p->badWidth = 0;
+    float* data = (float*)malloc(sizeof(float) * capacity);
+
+    csv_scanner_t scanner;
+    csv_initScanner(&scanner, p, end);
+    bool rowHasData = false;
+    while (p < end)
+    {
+        const char* stop = csv_nextDelimiter(&scanner);
+        const char* start = csv_skipBlanks(p, stop);
+        if (!csv_isEmptyField(start, stop))
+        {
+            if (elemCounter == capacity)
+            {
+                capacity *= 2;
+                data = (float*)realloc(data, sizeof(float) * capacity);
+            }
+            *(data + elemCounter) = csv_parseFloat(start, stop, chunk_p->end);
+            elemCounter++;
+            rowHasData = true;
+        }
+        if (stop == end || *stop == '\n')
+        {
+            if (rowHasData)
+            {
+                if (elemCounter - rowStart != chunk_p->ncol)
+                {
+                    chunk_p->badWidth = elemCounter - rowStart;
+                    elemCounter = rowStart;
+                    break;
+                }
+                rowStart = elemCounter;
+                nrow++;
+            }
+            rowHasData = false;
+        }
+        p = stop + 1;
+    }
+
+    chunk_p->data = data;
+    chunk_p->nElements = elemCounter;
+    chunk_p->nrow = nrow;
+}
+
+static void* parseChunkThread(void* chunk_p)
+{
+    parseChunk((csv_chunk_t*)chunk_p);
+    return NULL;
+}
+
+static void* copyChunkThread(void* chunk_p)
+{
+    csv_chunk_t* chunk = (csv_chunk_t*)chunk_p;
+    memcpy(chunk->slice, chunk->data, sizeof(float) * chunk->nElements);
+    free(chunk->data);
+    return NULL;
+}
+
+//Parse the rows in [p, end) on nThreads threads. The range is cut into equal
+//byte ranges, each moved forward to the start of the next line, so that every
+//row belongs to exactly one chunk. A prefix sum over the element counts of the
+//chunks gives the slice of the data each one is copied to, in row order.
+static void parseRows(f32_dataframe_t* dataframe, const char* fileName, const char* p, const char* end, size_t ncol, unsigned nThreads)
+{
+    if (nThreads <= 1)
+    {
+        csv_chunk_t chunk = { p, end, end, ncol, NULL, 0, 0, 0, NULL };
+        parseChunk(&chunk);
+        if (chunk.badWidth)
+        {   checkRowWidth(fileName, chunk.nrow, chunk.badWidth, ncol);  }
+        if (chunk.nElements)
+        {   chunk.data = (float*)realloc(chunk.data, sizeof(float) * chunk.nElements);  }
+        dataframe->data = chunk.data;
+        dataframe->nrow = chunk.nrow;
+        dataframe->ncol = ncol;
+        setRowMajor(dataframe);
+        return;
+    }
+
+    csv_chunk_t* chunks = (csv_chunk_t*)malloc(sizeof(csv_chunk_t) * nThreads);
+    pthread_t* threads = (pthread_t*)malloc(sizeof(pthread_t) * nThreads);
+    const size_t nBytes = end - p;
+    const char* chunkStart = p;
+    for (unsigned i = 0; i < nThreads; i++)
+    {
+        const char* chunkStop = end;
+        if (i + 1 < nThreads)
+        {
+            chunkStop = p + nBytes / nThreads * (i + 1);
+            if (chunkStop < chunkStart)
+            {   chunkStop = chunkStart; }
+            const char* newline = (const char*)memchr(chunkStop, '\n', end - chunkStop);
+            chunkStop = newline ? newline + 1 : end;
+        }
+        (chunks + i)->start = chunkStart;
+        (chunks + i)->stop = chunkStop;
+        (chunks + i)->end = end;
+        (chunks + i)->ncol = ncol;
+        pthread_create(threads + i, NULL, parseChunkThread, chunks + i);
+        chunkStart = chunkStop;
+    }
+    for (unsigned i = 0; i < nThreads; i++)
+    {   pthread_join(*(threads + i), NULL);   }
+
+    size_t nElements = 0, nrow = 0;
+    for (unsigned i = 0; i < nThreads; i++)
+    {
+        if ((chunks + i)->badWidth)
+        {   checkRowWidth(fileName, nrow + (chunks + i)->nrow, (chunks + i)->badWidth, ncol); }
+        nElements += (chunks + i)->nElements;
+        nrow += (chunks + i)->nrow;
+    }
+    float* data = (float*)malloc(sizeof(float) * (nElements ? nElements : 1));
+    float* slice = data;
+    for (unsigned i = 0; i < nThreads; i++)
+    {
+        (chunks + i)->slice = slice;
+        slice += (chunks + i)->nElements;
+        pthread_create(threads + i, NULL, copyChunkThread, chunks + i);
+    }
+    for (unsigned i = 0; i < nThreads; i++)
+    {   pthread_join(*(threads + i), NULL);   }
+
+    dataframe->data = data;
+    dataframe->nrow = nrow;
+    dataframe->ncol = ncol;
+    setRowMajor(dataframe);
+    free(chunks);
+    free(threads);
+}
+
+f32_dataframe_t f32_mapCSV(const char* fileName, bool hasHeader)
+{
+    return f32_mapCSVParallel(fileName, hasHeader, 1);
+}
+
+f32_dataframe_t f32_mapCSVParallel(const char* fileName, bool hasHeader, unsigned nThreads)
+{
+    if (nThreads == 0)
+    {   nThreads = (unsigned)sysconf(_SC_NPROCESSORS_ONLN); }
+
+    int fd = open(fileName, O_RDONLY);
+    struct stat fileStat;
+    if (fd < 0 || fstat(fd, &fileStat) != 0)
+    {
+        printf("%s failed to open. \n", fileName);
+        exit(1);
+    }
+
+    f32_dataframe_t dataframe;
+    dataframe.colNames = NULL; dataframe.colIndices = NULL;
+    dataframe.mapping = NULL; dataframe.mappedBytes = 0;
+    const size_t fileSize = (size_t)fileStat.st_size;
+    if (fileSize == 0)
+    {
+        close(fd);
+        dataframe.data = NULL;
+        dataframe.nrow = 0; dataframe.ncol = 0;
+        setRowMajor(&dataframe);
+        return dataframe;
+    }
+
+    const char* map = (const char*)mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED)
+    {
+        printf("%s failed to map. \n", fileName);
+        exit(1);
+    }
+    madvise((void*)map, fileSize, nThreads > 1 ? MADV_WILLNEED : MADV_SEQUENTIAL);
+
+    const char* p = map;
+    const char* end = map + fileSize;
+    size_t ncol;
+    if (hasHeader)
+    {   p = csv_parseHeader(p, end, &dataframe.colNames, &dataframe.colIndices, &ncol);   }
+    else
+    {   ncol = csv_firstRowWidth(p, end);   }
+    parseRows(&dataframe, fileName, p, end, ncol, nThreads);
+
+    munmap((void*)map, fileSize);
+    close(fd);
+    return dataframe;
+}
+
+//Text is read STREAM_TEXT_BYTES at a time, or more for a longer line.
+#define STREAM_TEXT_BYTES (1 << 22)
+
+//The stream owns two batches. A background thread reads and parses the next
+//batch into one of them while the caller works on the other, and the two
+//swap roles on every call to f32_nextBatch.
+struct f32_csvStream
+{
+    char* fileName;
+    int fd;
+    size_t ncol;
+    size_t batchRows;
+    char* colNames;
+    size_t* colIndices;
+
+    //Bytes [textStart, textEnd) of text are read but not parsed yet.
+    char* text;
+    size_t textCapacity;
+    size_t textStart;
+    size_t textEnd;
+    bool endOfFile;
+    size_t nrow;
+
+    //A batch is ready once parsed, until the caller is done with it. A ready
+    //batch of no rows marks the end of the file.
+    float* batches[2];
+    size_t batchNrow[2];
+    bool ready[2];
+    size_t nextRead;
+    bool holding;
+    bool closing;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+};
+
+//Move the unparsed text to the front of the buffer, growing it if a line fills
+//all of it, and read more after it.
+static void readText(f32_csvStream_t* stream_p)
+{
+    const size_t unparsed = stream_p->textEnd - stream_p->textStart;
+    memmove(stream_p->text, stream_p->text + stream_p->textStart, unparsed);
+    stream_p->textStart = 0;
+    stream_p->textEnd = unparsed;
+    if (unparsed == stream_p->textCapacity)
+    {
+        stream_p->textCapacity *= 2;
+        stream_p->text = (char*)realloc(stream_p->text, stream_p->textCapacity);
+    }
+
+    const ssize_t nBytes = read(stream_p->fd, stream_p->text + unparsed, stream_p->textCapacity - unparsed);
+    if (nBytes < 0)
+    {
+        printf("%s failed to read. \n", stream_p->fileName);
+        exit(1);
+    }
+    stream_p->textEnd += (size_t)nBytes;
+    stream_p->endOfFile = nBytes == 0;
+}
+
+//True once [p, end) holds a newline after a line with a field in it, so that
+//the header or the first row can be parsed from it.
+static bool hasCompleteRow(const char* p, const char* end)
+{
+    bool lineHasData = false;
+    for (; p < end; p++)
+    {
+        if (*p == '\n' && lineHasData)
+        {   return true;    }
+        lineHasData = *p == '\n' ? false : lineHasData || (*p != ' ' && *p != '\t' && *p != '\r' && *p != ',');
+    }
+    return false;
+}
+
+//Parse at most maxRows rows of [p, end) into out, row-major, and return the
+//position after the last one. The rows parsed are added to stream_p->nrow.
+static const char* parseBatchRows(f32_csvStream_t* stream_p, const char* p, const char* end, float* out, size_t maxRows)
+{
+    const size_t ncol = stream_p->ncol;
+    size_t nrow = 0, rowWidth = 0;
+    csv_scanner_t scanner;
+    csv_initScanner(&scanner, p, end);
+    while (p < end && nrow < maxRows)
+    {
+        const char* stop = csv_nextDelimiter(&scanner);
+        const char* start = csv_skipBlanks(p, stop);
+        if (!csv_isEmptyField(start, stop))
+        {
+            if (rowWidth < ncol)
+            {   *(out + nrow * ncol + rowWidth) = csv_parseFloat(start, stop, end); }
+            rowWidth++;
+        }
+        if ((stop == end || *stop == '\n') && rowWidth)
+        {
+            checkRowWidth(stream_p->fileName, stream_p->nrow, rowWidth, ncol);
+            stream_p->nrow++;
+            nrow++;
+            rowWidth = 0;
+        }
+        p = stop + 1;
+    }
+    return p < end ? p : end;
+}
+
+//Parse the next batchRows rows, or the rest of the file, into out. Only whole
+//lines are parsed until the end of the file. Returns the number of rows.
+static size_t parseBatch(f32_csvStream_t* stream_p, float* out)
+{
+    const size_t nrowBefore = stream_p->nrow;
+    size_t nrow = 0;
+    while (true)
+    {
+        const char* p = stream_p->text + stream_p->textStart;
+        const char* end = stream_p->text + stream_p->textEnd;
+        if (!stream_p->endOfFile)
+        {
+            while (end > p && *(end - 1) != '\n')
+            {   end--;  }
+        }
+        p = parseBatchRows(stream_p, p, end, out + nrow * stream_p->ncol, stream_p->batchRows - nrow);
+        stream_p->textStart = p - stream_p->text;
+        nrow = stream_p->nrow - nrowBefore;
+        if (nrow == stream_p->batchRows || stream_p->endOfFile)
+        {   return nrow;    }
+        readText(stream_p);
+    }
+}
+
+static void* streamThread(void* stream_v)
+{
+    f32_csvStream_t* stream_p = (f32_csvStream_t*)stream_v;
+    size_t slot = 0;
+    while (true)
+    {
+        pthread_mutex_lock(&stream_p->lock);
+        while (stream_p->ready[slot] && !stream_p->closing)
+        {   pthread_cond_wait(&stream_p->changed, &stream_p->lock);  }
+        const bool closing = stream_p->closing;
+        pthread_mutex_unlock(&stream_p->lock);
+        if (closing)
+        {   return NULL;    }
+
+        const size_t nrow = parseBatch(stream_p, stream_p->batches[slot]);
+
+        pthread_mutex_lock(&stream_p->lock);
+        stream_p->batchNrow[slot] = nrow;
+        stream_p->ready[slot] = true;
+        pthread_cond_broadcast(&stream_p->changed);
+        pthread_mutex_unlock(&stream_p->lock);
+        if (nrow == 0)
+        {   return NULL;    }
+        slot ^= 1;
+    }
+}
+
+f32_csvStream_t* f32_openStream(const char* fileName, bool hasHeader, size_t batchRows)
+{
+    int fd = open(fileName, O_RDONLY);
+    if (fd < 0)
+    {
+        printf("%s failed to open. \n", fileName);
+        exit(1);
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    f32_csvStream_t* stream_p = (f32_csvStream_t*)calloc(1, sizeof(f32_csvStream_t));
+    stream_p->fileName = (char*)malloc(strlen(fileName) + 1);
+    strcpy(stream_p->fileName, fileName);
+    stream_p->fd = fd;
+    stream_p->textCapacity = STREAM_TEXT_BYTES;
+    stream_p->text = (char*)malloc(stream_p->textCapacity);
+
+    //Read until the header or the first row is whole, which tells the width.
+    do
+    {   readText(stream_p); }
+    while (!stream_p->endOfFile && !hasCompleteRow(stream_p->text, stream_p->text + stream_p->textEnd));
+    const char* p = stream_p->text;
+    const char* end = stream_p->text + stream_p->textEnd;
+    if (hasHeader && p < end)
+    {
+        p = csv_parseHeader(p, end, &stream_p->colNames, &stream_p->colIndices, &stream_p->ncol);
+        stream_p->textStart = p - stream_p->text;
+    }
+    else
+    {   stream_p->ncol = csv_firstRowWidth(p, end); }
+
+    stream_p->batchRows = batchRows;
+    if (batchRows == 0)
+    {
+        stream_p->batchRows = F32_STREAM_BATCH_ROWS;
+        if (stream_p->ncol > F32_STREAM_BATCH_FLOATS / F32_STREAM_BATCH_ROWS)
+        {   stream_p->batchRows = F32_STREAM_BATCH_FLOATS / stream_p->ncol ? F32_STREAM_BATCH_FLOATS / stream_p->ncol : 1;  }
+    }
+    for (size_t i = 0; i < 2; i++)
+    {   stream_p->batches[i] = (float*)malloc(sizeof(float) * (stream_p->batchRows * stream_p->ncol + 1));   }
+    pthread_mutex_init(&stream_p->lock, NULL);
+    pthread_cond_init(&stream_p->changed, NULL);
+    pthread_create(&stream_p->thread, NULL, streamThread, stream_p);
+    return stream_p;
+}
+
+bool f32_nextBatch(f32_csvStream_t* stream_p, f32_dataframe_t* batch_p)
+{
+    pthread_mutex_lock(&stream_p->lock);
+    if (stream_p->holding)
+    {
+        //Hand the batch the caller is done with back to the thread.
+        stream_p->ready[stream_p->nextRead ^ 1] = false;
+        stream_p->holding = false;
+        pthread_cond_broadcast(&stream_p->changed);
+    }
+    const size_t slot = stream_p->nextRead;
+    while (!stream_p->ready[slot])
+    {   pthread_cond_wait(&stream_p->changed, &stream_p->lock);  }
+    const size_t nrow = stream_p->batchNrow[slot];
+    if (nrow)
+    {
+        stream_p->holding = true;
+        stream_p->nextRead ^= 1;
+    }
+    pthread_mutex_unlock(&stream_p->lock);
+
+    batch_p->colNames = stream_p->colNames;
+    batch_p->colIndices = stream_p->colIndices;
+    batch_p->data = stream_p->batches[slot];
+    batch_p->nrow = nrow;
+    batch_p->ncol = stream_p->ncol;
+    setRowMajor(batch_p);
+    batch_p->mapping = NULL; batch_p->mappedBytes = 0;
+    return nrow != 0;
+}
+
+size_t f32_streamColumns(f32_csvStream_t* stream_p)
+{
+    return stream_p->ncol;
+}
+
+void f32_closeStream(f32_csvStream_t* stream_p)
+{
+    pthread_mutex_lock(&stream_p->lock);
+    stream_p->closing = true;
+    pthread_cond_broadcast(&stream_p->changed);
+    pthread_mutex_unlock(&stream_p->lock);
+    pthread_join(stream_p->thread, NULL);
+
+    pthread_mutex_destroy(&stream_p->lock);
+    pthread_cond_destroy(&stream_p->changed);
+    close(stream_p->fd);
+    free(stream_p->batches[0]);
+    free(stream_p->batches[1]);
+    free(stream_p->text);
+    free(stream_p->colNames);
+    free(stream_p->colIndices);
+    free(stream_p->fileName);
+    free(stream_p);
+}
+
+f32_dataframe_t f32_newDataframe(const size_t nrow, const size_t ncol, f32_layout_t layout)
+{
+    f32_dataframe_t dataframe;
+    dataframe.colNames = NULL; dataframe.colIndices = NULL;
+    dataframe.mapping = NULL; dataframe.mappedBytes = 0;
+    dataframe.nrow = nrow; dataframe.ncol = ncol;
+    if (layout == F32_ROW_MAJOR)
+    {
+        dataframe.data = (float*)calloc(nrow * ncol + 1, sizeof(float));
+        setRowMajor(&dataframe);
+        return dataframe;
+    }
+
+    const size_t nBytes = sizeof(float) * paddedRows(nrow) * ncol;
+    dataframe.data = (float*)aligned_alloc(32, nBytes ? nBytes : 32);
+    memset(dataframe.data, 0, nBytes);
+    dataframe.layout = F32_COLUMN_MAJOR;
+    dataframe.rowStride = 1;
+    dataframe.colStride = paddedRows(nrow);
+    return dataframe;
+}
+
+//Free the data, or unmap it if it was loaded from a binary file.
+static void releaseData(f32_dataframe_t* data_p)
+{
+    if (data_p->mapping != NULL)
+    {   munmap(data_p->mapping, data_p->mappedBytes);    }
+    else
+    {   free(data_p->data); }
+    data_p->mapping = NULL;
+    data_p->mappedBytes = 0;
+}
+
+//Copy the data of src into dst, which has the same shape, blocks of rows at a
+//time so that both the rows and the columns being touched stay in cache.
+static void copyData(f32_dataframe_t* dst, f32_dataframe_t* src)
+{
+    const size_t blockRows = 64;
+    for (size_t i0 = 0; i0 < src->nrow; i0 += blockRows)
+    {
+        const size_t i1 = i0 + blockRows < src->nrow ? i0 + blockRows : src->nrow;
+        for (size_t j = 0; j < src->ncol; j++)
+        {
+            const float* from = src->data + j * src->colStride;
+            float* to = dst->data + j * dst->colStride;
+            for (size_t i = i0; i < i1; i++)
+            {   *(to + i * dst->rowStride) = *(from + i * src->rowStride);  }
+        }
+    }
+}
+
+//Replace the data of data_p with a copy in the given layout.
+static void convertLayout(f32_dataframe_t* data_p, f32_layout_t layout)
+{
+    if (data_p->layout == layout)
+    {   return; }
+    f32_dataframe_t converted = f32_newDataframe(data_p->nrow, data_p->ncol, layout);
+    copyData(&converted, data_p);
+    releaseData(data_p);
+    data_p->data = converted.data;
+    data_p->layout = converted.layout;
+    data_p->rowStride = converted.rowStride;
+    data_p->colStride = converted.colStride;
+}
+
+void f32_toColumnMajor(f32_dataframe_t* data_p)
+{
+    convertLayout(data_p, F32_COLUMN_MAJOR);
+}
+
+void f32_toRowMajor(f32_dataframe_t* data_p)
+{
+    convertLayout(data_p, F32_ROW_MAJOR);
+}
+
+const float* f32_colPointer(f32_dataframe_t* data_p, const size_t col)
+{
+    if (data_p->layout != F32_COLUMN_MAJOR || col >= data_p->ncol)
+    {   return NULL;    }
+    return data_p->data + col * data_p->colStride;
+}
+
+void f32_freeCSV(f32_dataframe_t* data_p)
+{
+    free(data_p->colNames);
+    free(data_p->colIndices);
+    releaseData(data_p);
+}
+
+void f32_printColumnNames(f32_dataframe_t* data_p)
+{
+    size_t start, end;
+    for (size_t i = 0; i < data_p->ncol; i++)
+    {   
+        start = *(data_p->colIndices + i); end = *(data_p->colIndices + i + 1); 
+        for (size_t j = start; j < end; j++)
+        {   printf("%c", *(data_p->colNames + j));  }
+        printf(" ");
+    } 
+    NEW_LINE;
+}
+
+void f32_printData(f32_dataframe_t* data_p)
+{
+    for (size_t i = 0; i < data_p->nrow; i++)
+    {   
+        for (size_t j = 0; j < data_p->ncol; j++)
+        {   printf("%f ", *(data_p->data + i*data_p->rowStride + j*data_p->colStride));  }
+        NEW_LINE;
+    }
+}
+
+f32_view_t f32_rowView(f32_dataframe_t* data_p, const size_t row)
+{
+    f32_view_t view = { NULL, 0, 1 };
+    if (row < data_p->nrow)
+    {
+        view.data = data_p->data + row * data_p->rowStride;
+        view.length = data_p->ncol;
+        view.stride = data_p->colStride;
+    }
+    return view;
+}
+
+f32_view_t f32_colView(f32_dataframe_t* data_p, const size_t col)
+{
+    f32_view_t view = { NULL, 0, 1 };
+    if (col < data_p->ncol)
+    {
+        view.data = data_p->data + col * data_p->colStride;
+        view.length = data_p->nrow;
+        view.stride = data_p->rowStride;
+    }
+    return view;
+}
+
+f32_view_t f32_viewSlice(const f32_view_t view, size_t first, size_t length)
+{
+    f32_view_t slice = view;
+    if (first > view.length)
+    {   first = view.length;    }
+    if (length > view.length - first)
+    {   length = view.length - first;   }
+    if (view.data)
+    {   slice.data = view.data + first * view.stride;   }
+    slice.length = length;
+    return slice;
+}
+
+void f32_viewCopyTo(const f32_view_t view, float* dst)
+{
+    if (view.stride == 1)
+    {
+        memcpy(dst, view.data, sizeof(float) * view.length);
+        return;
+    }
+    for (size_t i = 0; i < view.length; i++)
+    {   dst[i] = f32_viewAt(view, i);   }
+}
+
+//A copy of a view that the caller frees, or NULL for an empty view.
+static float* copyView(const f32_view_t view)
+{
+    if (view.data == NULL)
+    {   return NULL;    }
+    float* copy = (float*)malloc(sizeof(float) * (view.length ? view.length : 1));
+    f32_viewCopyTo(view, copy);
+    return copy;
+}
+
+float* f32_getRow(f32_dataframe_t* data_p, const size_t row)
+{
+    return copyView(f32_rowView(data_p, row));
+}
+
+float* f32_getCol(f32_dataframe_t* data_p, const size_t col)
+{
+    return copyView(f32_colView(data_p, col));
+}
@@ -0,0 +1,120 @@
+#ifndef READCSV_H
+#define READCSV_H
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<stdbool.h>
+
+#define NEW_LINE printf("\n");
+
+//Adjust according to .csv row size.
+//Not enforced in the program.
+#define MAX_BUFFER 10000
+#define MAX_COLUMNS 1000
+typedef const unsigned int index_t;
+
+//Row-major data stores each row contiguously, as the readers produce it.
+//Column-major data stores each column contiguously, 32-byte aligned and
+//padded with zeros to a multiple of F32_COLUMN_PAD floats for AVX.
+#define F32_COLUMN_PAD 8
+typedef enum f32_layout
+{
+    F32_ROW_MAJOR,
+    F32_COLUMN_MAJOR
+} f32_layout_t;
+
+typedef struct f32_dataframe
+{
+    char* colNames;
+    size_t* colIndices;
+    float* data;
+    size_t nrow;
+    size_t ncol;
+    f32_layout_t layout;
+    //Element (i, j) is at data + i*rowStride + j*colStride.
+    size_t rowStride;
+    size_t colStride;
+    //Non-NULL when data lies inside a memory mapping of mappedBytes bytes,
+    //as loaded by f32_loadBinary, rather than in its own allocation.
+    void* mapping;
+    size_t mappedBytes;
+} f32_dataframe_t;
+
+//Read a .csv file line by line. memAlloc is the number of floats to allocate
+//up front, or 0 to start small; the data grows as needed either way.
+//The number of columns comes from the header, or from the first row if there
+//is none, and every row must have that many fields.
+f32_dataframe_t f32_readCSV(const char* fileName, index_t memAlloc, bool hasHeader);
+
+//Read a .csv file by parsing it in place from a memory mapping.
+//Rows may be of any length and are checked as in f32_readCSV.
+f32_dataframe_t f32_mapCSV(const char* fileName, bool hasHeader);
+
+//As f32_mapCSV, with the rows split into nThreads chunks that are parsed
+//concurrently. Passing 0 uses one thread per online CPU.
+f32_dataframe_t f32_mapCSVParallel(const char* fileName, bool hasHeader, unsigned nThreads);
+
+//Rows of a .csv file in batches of batchRows rows, so that files larger than
+//memory can be processed. Passing 0 uses F32_STREAM_BATCH_ROWS rows, or fewer
+//for rows so wide that a batch would hold over F32_STREAM_BATCH_FLOATS floats.
+//Memory use depends on the batch size and not on the file. The next batch is
+//read and parsed on a background thread while the caller works on the current
+//one. Rows are checked as in f32_mapCSV.
+#define F32_STREAM_BATCH_ROWS 65536
+#define F32_STREAM_BATCH_FLOATS (1 << 22)
+typedef struct f32_csvStream f32_csvStream_t;
+
+f32_csvStream_t* f32_openStream(const char* fileName, bool hasHeader, size_t batchRows);
+
+//Point batch_p at the next rows as a row-major dataframe, or return false at
+//the end of the file. The batch, names included, belongs to the stream: it is
+//valid until the next call or f32_closeStream, and is not passed to f32_freeCSV.
+bool f32_nextBatch(f32_csvStream_t* stream_p, f32_dataframe_t* batch_p);
+
+size_t f32_streamColumns(f32_csvStream_t* stream_p);
+void f32_closeStream(f32_csvStream_t* stream_p);
+
+//A dataframe of zeros without column names.
+f32_dataframe_t f32_newDataframe(const size_t nrow, const size_t ncol, f32_layout_t layout);
+
+//Convert the data to the other layout in place.
+void f32_toColumnMajor(f32_dataframe_t* data_p);
+void f32_toRowMajor(f32_dataframe_t* data_p);
+
+//Pointer to the contiguous data of a column of a column-major dataframe,
+//without copying. Returns NULL for row-major data or a column out of range.
+const float* f32_colPointer(f32_dataframe_t* data_p, const size_t col);
+
+void f32_freeCSV(f32_dataframe_t* data_p);
+void f32_printColumnNames(f32_dataframe_t* data_p);
+void f32_printData(f32_dataframe_t* data_p);
+//A row or column borrowed from a dataframe: element i is at data + i*stride.
+//A view stays valid until the dataframe is freed or converted to another layout.
+typedef struct f32_view
+{
+    const float* data;
+    size_t length;
+    size_t stride;
+} f32_view_t;
+
+//Views of a row or column. Out of range, the view is empty with data NULL.
+f32_view_t f32_rowView(f32_dataframe_t* data_p, const size_t row);
+f32_view_t f32_colView(f32_dataframe_t* data_p, const size_t col);
+
+static inline float f32_viewAt(const f32_view_t view, const size_t i)
+{
+    return *(view.data + i * view.stride);
+}
+
+//The elements [first, first + length) of a view, clamped to its end.
+f32_view_t f32_viewSlice(const f32_view_t view, size_t first, size_t length);
+
+//Copy the elements of a view into dst, which must hold view.length floats.
+void f32_viewCopyTo(const f32_view_t view, float* dst);
+
+//Copies of a row or column, in either layout. The caller frees them.
+float* f32_getRow(f32_dataframe_t* data_p, const size_t row);
+float* f32_getCol(f32_dataframe_t* data_p, const size_t col);
+
+#endif /* READCSV_H */
@@ -0,0 +1,67 @@
+#include "readCSV.h"
+#include "csvParse.h"
+#include "benchmarkUtils.h"
+
+#define BENCHMARK_FILE "readCSV_benchmark.csv"
+#define BENCHMARK_COLUMNS 10
+
+static bool sameDataframe(f32_dataframe_t* a, f32_dataframe_t* b)
+{
+    if (a->nrow != b->nrow || a->ncol != b->ncol)
+    {   return false;   }
+    if (strcmp(a->colNames, b->colNames) != 0)
+    {   return false;   }
+    if (memcmp(a->colIndices, b->colIndices, sizeof(size_t) * (a->ncol + 1)) != 0)
+    {   return false;   }
+    return memcmp(a->data, b->data, sizeof(float) * a->nrow * a->ncol) == 0;
+}
+
+//Takes the size of the generated file in MB and the largest number of threads
+//for f32_mapCSVParallel as optional arguments.
+int main(int argc, char** argv)
+{
+    const size_t megaBytes = argc > 1 ? (size_t)atol(argv[1]) : 1024;
+    const unsigned maxThreads = argc > 2 ? (unsigned)atoi(argv[2]) : 32;
+    writeNumbersFile(BENCHMARK_FILE, megaBytes, BENCHMARK_COLUMNS, true);
+
+    FILE* file_p = fopen(BENCHMARK_FILE, "r");
+    fseek(file_p, 0, SEEK_END);
+    const double gigaBytes = ftell(file_p) / 1e9;
+    fclose(file_p);
+
+    double start = seconds();
+    f32_dataframe_t lines = f32_readCSV(BENCHMARK_FILE, 0, true);
+    const double fgetsTime = seconds() - start;
+
+    csv_useAVX2(false);
+    start = seconds();
+    f32_dataframe_t scalar = f32_mapCSV(BENCHMARK_FILE, true);
+    const double scalarTime = seconds() - start;
+
+    const bool hasAVX2 = csv_useAVX2(true);
+    start = seconds();
+    f32_dataframe_t mapped = f32_mapCSV(BENCHMARK_FILE, true);
+    const double mmapTime = seconds() - start;
+
+    printf("%.3f GB, %zu rows x %zu columns \n", gigaBytes, mapped.nrow, mapped.ncol);
+    printf("fgets + strtok + strtof: %.3f GB/s \n", gigaBytes / fgetsTime);
+    printf("mmap, scalar scan:       %.3f GB/s \n", gigaBytes / scalarTime);
+    printf("mmap, %-6s scan:       %.3f GB/s \n", hasAVX2 ? "AVX2" : "scalar", gigaBytes / mmapTime);
+    printf("Results %s \n", sameDataframe(&lines, &scalar) && sameDataframe(&lines, &mapped) ? "match" : "DIFFER");
+
+    printf("threads  GB/s \n");
+    for (unsigned nThreads = 1; nThreads <= maxThreads; nThreads *= 2)
+    {
+        start = seconds();
+        f32_dataframe_t parallel = f32_mapCSVParallel(BENCHMARK_FILE, true, nThreads);
+        const double parallelTime = seconds() - start;
+        printf("%-8u %.3f %s\n", nThreads, gigaBytes / parallelTime, sameDataframe(&lines, &parallel) ? "" : "(results DIFFER)");
+        f32_freeCSV(&parallel);
+    }
+
+    f32_freeCSV(&lines);
+    f32_freeCSV(&scalar);
+    f32_freeCSV(&mapped);
+    remove(BENCHMARK_FILE);
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include "readCSV.h"
+
+int main(int argc, char** argv)
+{   
+    const char* fileName = argc > 1 ? argv[1] : "numbers.txt";
+    bool hasHeader = true;
+    
+    f32_dataframe_t data = f32_mapCSV(fileName, hasHeader);
+    
+    f32_printColumnNames(&data);
+
+    f32_printData(&data);
+
+    f32_view_t row1 = f32_rowView(&data, 1);
+    if (row1.data)
+    {   
+        printf("Row 1: \n");
+        for (size_t i = 0; i < row1.length; i++)
+        {   printf("%f ", f32_viewAt(row1, i)); }
+        NEW_LINE;
+    }
+
+    f32_view_t col4 = f32_colView(&data, 4);
+    if (col4.data)
+    {
+        printf("Column 4: \n");
+        for (size_t i = 0; i < col4.length; i++)
+        {   printf("%f ", f32_viewAt(col4, i)); }
+        NEW_LINE;
+    }
+
+    //Views borrow from the data, so they are taken again after a conversion.
+    f32_toColumnMajor(&data);
+    col4 = f32_colView(&data, 4);
+    if (col4.data)
+    {
+        printf("Column 4, column-major, stride %zu: \n", col4.stride);
+        for (size_t i = 0; i < col4.length; i++)
+        {   printf("%f ", f32_viewAt(col4, i)); }
+        NEW_LINE;
+    }
+
+    //A copy that outlives the dataframe.
+    float* row1Copy = f32_getRow(&data, 1);
+    f32_freeCSV(&data);
+    if (row1Copy)
+    {   printf("Copy of row 1 starts with %f \n", row1Copy[0]);  }
+    free(row1Copy);
+    
+    return 0;
+}
@@ -0,0 +1,19 @@
+#include "typedCSV.h"
+
+int main(int argc, char** argv)
+{
+    const char* fileName = argc > 1 ? argv[1] : "numbers.txt";
+    bool hasHeader = true;
+
+    tdf_dataframe_t data = tdf_mapCSV(fileName, hasHeader);
+
+    tdf_printColumnTypes(&data);
+
+    tdf_printData(&data);
+
+    printf("%zu rows x %zu columns in %zu bytes \n", data.nrow, data.ncol, tdf_dataBytes(&data));
+
+    tdf_freeDataframe(&data);
+
+    return 0;
+}
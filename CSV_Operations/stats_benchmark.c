@@ -0,0 +1,137 @@
+#include "dataframeStats.h"
+#include <math.h>
+#include "benchmarkUtils.h"
+#include <unistd.h>
+
+#define BENCHMARK_COLUMNS 16
+
+//Floating point operations counted per element: a sum, and a subtraction,
+//multiplication and addition for the squared deviation. The comparisons for
+//min and max are not counted.
+static double statsFlops(f32_dataframe_t* data_p)
+{
+    return 4.0 * data_p->nrow * data_p->ncol;
+}
+
+//The statistics pass for the means, then a subtraction per element and a
+//multiplication and addition per element of every pair of columns.
+static double covarianceFlops(f32_dataframe_t* data_p)
+{
+    return statsFlops(data_p) + 1.0 * data_p->nrow * data_p->ncol
+           + 2.0 * data_p->nrow * data_p->ncol * (data_p->ncol + 1) / 2;
+}
+
+static double timeStats(f32_dataframe_t* data_p, f32_colStats_t* stats, unsigned nThreads)
+{
+    const double start = seconds();
+    f32_columnStats(data_p, stats, nThreads);
+    return statsFlops(data_p) / (seconds() - start) / 1e9;
+}
+
+static double timeCovariance(f32_dataframe_t* data_p, double* cov, unsigned nThreads)
+{
+    const double start = seconds();
+    f32_covariance(data_p, cov, nThreads);
+    return covarianceFlops(data_p) / (seconds() - start) / 1e9;
+}
+
+static double relativeError(double value, long double reference)
+{
+    if (reference == 0.0L)
+    {   return fabs(value); }
+    return (double)fabsl((value - reference) / reference);
+}
+
+//Two-pass means and covariances in long double, and the largest relative errors
+//of the means, variances and covariances against them.
+static void checkAccuracy(f32_dataframe_t* data_p, f32_colStats_t* stats, double* cov)
+{
+    const size_t nrow = data_p->nrow, ncol = data_p->ncol;
+    long double* means = (long double*)calloc(ncol, sizeof(long double));
+    long double* comoments = (long double*)calloc(ncol * ncol, sizeof(long double));
+    for (size_t i = 0; i < nrow; i++)
+    {
+        for (size_t j = 0; j < ncol; j++)
+        {   means[j] += *(data_p->data + i * data_p->rowStride + j * data_p->colStride);  }
+    }
+    for (size_t j = 0; j < ncol; j++)
+    {   means[j] /= nrow;   }
+    for (size_t i = 0; i < nrow; i++)
+    {
+        for (size_t j = 0; j < ncol; j++)
+        {
+            const long double a = *(data_p->data + i * data_p->rowStride + j * data_p->colStride) - means[j];
+            for (size_t k = j; k < ncol; k++)
+            {   comoments[j * ncol + k] += a * (*(data_p->data + i * data_p->rowStride + k * data_p->colStride) - means[k]);   }
+        }
+    }
+
+    double meanError = 0.0, varianceError = 0.0, covarianceError = 0.0;
+    for (size_t j = 0; j < ncol; j++)
+    {
+        meanError = fmax(meanError, relativeError(stats[j].mean, means[j]));
+        varianceError = fmax(varianceError, relativeError(stats[j].variance, comoments[j * ncol + j] / (nrow - 1)));
+        for (size_t k = j; k < ncol; k++)
+        {   covarianceError = fmax(covarianceError, relativeError(cov[j * ncol + k], comoments[j * ncol + k] / (nrow - 1)));  }
+    }
+    printf("Largest relative error against long double: mean %.2e, variance %.2e, covariance %.2e \n",
+           meanError, varianceError, covarianceError);
+    free(means);
+    free(comoments);
+}
+
+//Takes the number of rows and the largest number of threads as optional arguments.
+int main(int argc, char** argv)
+{
+    const size_t nrow = argc > 1 ? (size_t)atol(argv[1]) : 2000000;
+    const unsigned maxThreads = argc > 2 ? (unsigned)atoi(argv[2]) : (unsigned)sysconf(_SC_NPROCESSORS_ONLN);
+
+    //Columns far from zero with a small spread, where a one-pass sum of squares
+    //would lose most of its digits. Odd columns follow the column before them.
+    f32_dataframe_t data = f32_newDataframe(nrow, BENCHMARK_COLUMNS, F32_ROW_MAJOR);
+    srand(9999);
+    for (size_t i = 0; i < nrow; i++)
+    {
+        for (size_t j = 0; j < BENCHMARK_COLUMNS; j++)
+        {
+            const float noise = (float)(rand() % 1000) / 100.0f;
+            float* element = data.data + i * data.rowStride + j;
+            *element = j % 2 ? *(element - 1) * 0.5f + noise : 10000.0f * (j + 1) + noise;
+        }
+    }
+
+    f32_colStats_t* stats = (f32_colStats_t*)malloc(sizeof(f32_colStats_t) * BENCHMARK_COLUMNS);
+    double* cov = (double*)malloc(sizeof(double) * BENCHMARK_COLUMNS * BENCHMARK_COLUMNS);
+    printf("%zu rows x %d columns \n", nrow, BENCHMARK_COLUMNS);
+
+    f32_statsUseAVX2(false);
+    const double scalarStats = timeStats(&data, stats, 1);
+    const double scalarCovariance = timeCovariance(&data, cov, 1);
+    const bool hasAVX2 = f32_statsUseAVX2(true);
+    const double rowStats = timeStats(&data, stats, 1);
+    const double rowCovariance = timeCovariance(&data, cov, 1);
+    checkAccuracy(&data, stats, cov);
+
+    f32_toColumnMajor(&data);
+    const double columnStats = timeStats(&data, stats, 1);
+    const double columnCovariance = timeCovariance(&data, cov, 1);
+    checkAccuracy(&data, stats, cov);
+
+    printf("GFLOP/s on 1 thread          column stats  covariance \n");
+    printf("  scalar, row-major          %-13.3f %.3f \n", scalarStats, scalarCovariance);
+    printf("  %-6s, row-major          %-13.3f %.3f \n", hasAVX2 ? "AVX2" : "scalar", rowStats, rowCovariance);
+    printf("  %-6s, column-major       %-13.3f %.3f \n", hasAVX2 ? "AVX2" : "scalar", columnStats, columnCovariance);
+
+    printf("threads  GFLOP/s, column-major \n");
+    for (unsigned nThreads = 1; nThreads <= maxThreads; nThreads *= 2)
+    {
+        const double statsRate = timeStats(&data, stats, nThreads);
+        const double covarianceRate = timeCovariance(&data, cov, nThreads);
+        printf("%-8u %-13.3f %.3f \n", nThreads, statsRate, covarianceRate);
+    }
+
+    free(stats);
+    free(cov);
+    f32_freeCSV(&data);
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include "dataframeStats.h"
+#include <math.h>
+#include <sys/resource.h>
+#include "benchmarkUtils.h"
+
+#define SMALL_FILE "stream_benchmark_small.csv"
+#define LARGE_FILE "stream_benchmark_large.csv"
+#define BENCHMARK_COLUMNS 10
+
+//Largest resident set of the process so far, in MB.
+static double peakMegaBytes(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0;
+}
+
+static double fileGigaBytes(const char* fileName)
+{
+    FILE* file_p = fopen(fileName, "r");
+    fseek(file_p, 0, SEEK_END);
+    const double gigaBytes = ftell(file_p) / 1e9;
+    fclose(file_p);
+    return gigaBytes;
+}
+
+//Column statistics of a file, merged over the batches of a stream.
+static void streamStats(const char* fileName, f32_colStats_t* stats)
+{
+    f32_csvStream_t* stream_p = f32_openStream(fileName, true, 0);
+    f32_colStats_t* batchStats = (f32_colStats_t*)malloc(sizeof(f32_colStats_t) * f32_streamColumns(stream_p));
+    memset(stats, 0, sizeof(f32_colStats_t) * f32_streamColumns(stream_p));
+    f32_dataframe_t batch;
+    while (f32_nextBatch(stream_p, &batch))
+    {
+        f32_columnStats(&batch, batchStats, 1);
+        f32_mergeColStats(stats, batchStats, batch.ncol);
+    }
+    free(batchStats);
+    f32_closeStream(stream_p);
+}
+
+static void report(const char* name, const char* fileName, double time)
+{
+    printf("%-32s %8.3f GB/s, peak memory %8.1f MB \n", name, fileGigaBytes(fileName) / time, peakMegaBytes());
+}
+
+//Takes the size of the larger generated file in MB as an optional argument.
+//The smaller file is a quarter of it. Peak memory only ever grows, so the runs
+//go from the least memory to the most.
+int main(int argc, char** argv)
+{
+    const size_t megaBytes = argc > 1 ? (size_t)atol(argv[1]) : 512;
+    writeNumbersFile(SMALL_FILE, megaBytes / 4, BENCHMARK_COLUMNS, false);
+    writeNumbersFile(LARGE_FILE, megaBytes, BENCHMARK_COLUMNS, false);
+    printf("Column statistics of %.3f GB and %.3f GB CSV files \n", fileGigaBytes(SMALL_FILE), fileGigaBytes(LARGE_FILE));
+
+    f32_colStats_t streamed[BENCHMARK_COLUMNS], loaded[BENCHMARK_COLUMNS];
+    double start = seconds();
+    streamStats(SMALL_FILE, streamed);
+    report("stream, small file:", SMALL_FILE, seconds() - start);
+
+    start = seconds();
+    streamStats(LARGE_FILE, streamed);
+    report("stream, large file:", LARGE_FILE, seconds() - start);
+
+    start = seconds();
+    f32_dataframe_t data = f32_mapCSV(LARGE_FILE, true);
+    f32_columnStats(&data, loaded, 1);
+    report("f32_mapCSV, large file:", LARGE_FILE, seconds() - start);
+
+    bool same = true;
+    for (size_t j = 0; j < BENCHMARK_COLUMNS; j++)
+    {
+        same = same && streamed[j].count == loaded[j].count && streamed[j].min == loaded[j].min && streamed[j].max == loaded[j].max;
+        same = same && fabs(streamed[j].mean - loaded[j].mean) <= 1e-9 * fabs(loaded[j].mean) + 1e-9;
+        same = same && fabs(streamed[j].variance - loaded[j].variance) <= 1e-9 * loaded[j].variance;
+    }
+    printf("Results %s \n", same ? "match" : "DIFFER");
+
+    f32_freeCSV(&data);
+    remove(SMALL_FILE);
+    remove(LARGE_FILE);
+    return 0;
+}
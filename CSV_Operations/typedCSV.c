@@ -0,0 +1,504 @@
+#include "typedCSV.h"
+#include "csvParse.h"
+#include<fcntl.h>
+#include<float.h>
+#include<math.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
+
+//What the fields of a column seen so far need.
+typedef struct column_scan
+{
+    bool text;          //A field is not a number.
+    bool fraction;      //A number has a decimal point or an exponent.
+    bool wide;          //An integer does not fit in 32 bits.
+    bool overflow;      //An integer does not fit in 64 bits.
+    bool precise;       //A number has more digits than a float keeps, or is out of its range.
+} column_scan_t;
+
+//A string column while it is parsed: the dictionary so far, a hash table of
+//codes + 1 (0 for an empty slot) and the length of each string.
+typedef struct string_table
+{
+    tdf_dictionary_t dictionary;
+    size_t charCapacity;
+    size_t stringCapacity;
+    uint32_t* slots;
+    size_t slotCapacity;
+    size_t* lengths;
+} string_table_t;
+
+//Classify the number in [start, stop), or mark the column as text. Numbers are
+//in decimal notation with an optional sign, decimal point and exponent.
+static void scanField(const char* start, const char* stop, column_scan_t* scan_p)
+{
+    const char* p = start;
+    bool negative = false;
+    if (p < stop && (*p == '-' || *p == '+'))
+    {   negative = *p == '-'; p++;  }
+
+    //Significant digits run from the first nonzero digit to the last one,
+    //counted over the integer and fraction digits together.
+    uint64_t magnitude = 0;
+    bool isInteger = true, tooLarge = false;
+    int position = 0, first = -1, last = -1;
+    for (; p < stop && (unsigned)(*p - '0') < 10; p++, position++)
+    {
+        tooLarge = tooLarge || magnitude > (UINT64_MAX - 9) / 10;
+        magnitude = magnitude * 10 + (*p - '0');
+        if (*p != '0')
+        {
+            first = first < 0 ? position : first;
+            last = position;
+        }
+    }
+    const int integerDigits = position;
+    if (p < stop && *p == '.')
+    {
+        isInteger = false;
+        for (p++; p < stop && (unsigned)(*p - '0') < 10; p++, position++)
+        {
+            if (*p != '0')
+            {
+                first = first < 0 ? position : first;
+                last = position;
+            }
+        }
+    }
+    bool anyDigits = position > 0;
+    int exponent = 0;
+    if (anyDigits && p < stop && (*p == 'e' || *p == 'E'))
+    {
+        p++;
+        bool negativeExponent = false;
+        if (p < stop && (*p == '-' || *p == '+'))
+        {   negativeExponent = *p == '-'; p++;  }
+        if (p == stop || (unsigned)(*p - '0') >= 10)
+        {   anyDigits = false;  }
+        while (p < stop && (unsigned)(*p - '0') < 10)
+        {
+            exponent = exponent < 100000 ? exponent * 10 + (*p - '0') : exponent;
+            p++;
+        }
+        exponent = negativeExponent ? -exponent : exponent;
+        isInteger = false;
+    }
+    while (p < stop && (*p == ' ' || *p == '\t' || *p == '\r'))
+    {   p++;    }
+    if (!anyDigits || p < stop)
+    {
+        scan_p->text = true;
+        return;
+    }
+
+    if (isInteger)
+    {
+        const uint64_t limit64 = negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+        const uint64_t limit32 = negative ? (uint64_t)INT32_MAX + 1 : (uint64_t)INT32_MAX;
+        scan_p->overflow = scan_p->overflow || tooLarge || magnitude > limit64;
+        scan_p->wide = scan_p->wide || tooLarge || magnitude > limit32;
+    }
+    else
+    {   scan_p->fraction = true;    }
+    if (first >= 0)
+    {
+        const int leadExponent = integerDigits - 1 - first + exponent;
+        if (last - first + 1 > FLT_DIG || leadExponent < FLT_MIN_10_EXP || leadExponent >= FLT_MAX_10_EXP)
+        {   scan_p->precise = true; }
+    }
+}
+
+static tdf_type_t columnType(const column_scan_t* scan_p)
+{
+    if (scan_p->text)
+    {   return TDF_STRING;  }
+    if (!scan_p->fraction)
+    {   return scan_p->overflow ? TDF_DOUBLE : scan_p->wide ? TDF_INT64 : TDF_INT32;   }
+    return scan_p->precise ? TDF_DOUBLE : TDF_FLOAT;
+}
+
+static size_t typeBytes(tdf_type_t type)
+{
+    switch (type)
+    {
+        case TDF_INT32: return sizeof(int32_t);
+        case TDF_INT64: return sizeof(int64_t);
+        case TDF_FLOAT: return sizeof(float);
+        case TDF_DOUBLE: return sizeof(double);
+        default: return sizeof(uint32_t);
+    }
+}
+
+//Integer in [start, stop), which scanField has checked fits in 64 bits.
+static int64_t parseInteger(const char* start, const char* stop)
+{
+    const char* p = start;
+    bool negative = false;
+    if (p < stop && (*p == '-' || *p == '+'))
+    {   negative = *p == '-'; p++;  }
+    uint64_t magnitude = 0;
+    while (p < stop && (unsigned)(*p - '0') < 10)
+    {
+        magnitude = magnitude * 10 + (*p - '0');
+        p++;
+    }
+    return negative ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+}
+
+//FNV-1a.
+static uint32_t hashString(const char* p, size_t length)
+{
+    uint32_t hash = 2166136261U;
+    for (size_t i = 0; i < length; i++)
+    {   hash = (hash ^ (unsigned char)*(p + i)) * 16777619U;  }
+    return hash;
+}
+
+//Code of the string [p, p + length), added to the dictionary if it is new.
+static uint32_t internString(string_table_t* table_p, const char* p, size_t length)
+{
+    tdf_dictionary_t* dictionary = &table_p->dictionary;
+    size_t slot = hashString(p, length) & (table_p->slotCapacity - 1);
+    while (*(table_p->slots + slot))
+    {
+        const uint32_t code = *(table_p->slots + slot) - 1;
+        if (*(table_p->lengths + code) == length && memcmp(dictionary->chars + *(dictionary->offsets + code), p, length) == 0)
+        {   return code;    }
+        slot = (slot + 1) & (table_p->slotCapacity - 1);
+    }
+
+    const uint32_t code = (uint32_t)dictionary->nstrings;
+    if (dictionary->nstrings == table_p->stringCapacity)
+    {
+        table_p->stringCapacity *= 2;
+        dictionary->offsets = (size_t*)realloc(dictionary->offsets, sizeof(size_t) * table_p->stringCapacity);
+        table_p->lengths = (size_t*)realloc(table_p->lengths, sizeof(size_t) * table_p->stringCapacity);
+    }
+    const size_t offset = dictionary->nstrings ? *(dictionary->offsets + code - 1) + *(table_p->lengths + code - 1) + 1 : 0;
+    while (offset + length + 1 > table_p->charCapacity)
+    {
+        table_p->charCapacity *= 2;
+        dictionary->chars = (char*)realloc(dictionary->chars, table_p->charCapacity);
+    }
+    memcpy(dictionary->chars + offset, p, length);
+    *(dictionary->chars + offset + length) = '\0';
+    *(dictionary->offsets + code) = offset;
+    *(table_p->lengths + code) = length;
+    *(table_p->slots + slot) = code + 1;
+    dictionary->nstrings++;
+
+    //Keep the table at most half full.
+    if (dictionary->nstrings * 2 > table_p->slotCapacity)
+    {
+        const size_t capacity = table_p->slotCapacity * 2;
+        uint32_t* slots = (uint32_t*)calloc(capacity, sizeof(uint32_t));
+        for (size_t i = 0; i < dictionary->nstrings; i++)
+        {
+            size_t s = hashString(dictionary->chars + *(dictionary->offsets + i), *(table_p->lengths + i)) & (capacity - 1);
+            while (*(slots + s))
+            {   s = (s + 1) & (capacity - 1);   }
+            *(slots + s) = (uint32_t)i + 1;
+        }
+        free(table_p->slots);
+        table_p->slots = slots;
+        table_p->slotCapacity = capacity;
+    }
+    return code;
+}
+
+//Store the codes of a string column in as few bytes as its dictionary allows.
+static void narrowCodes(tdf_column_t* column_p, size_t nrow)
+{
+    const uint32_t* codes = (const uint32_t*)column_p->data;
+    const size_t nstrings = column_p->dictionary.nstrings;
+    column_p->codeBytes = nstrings <= 256 ? 1 : nstrings <= 65536 ? 2 : 4;
+    if (column_p->codeBytes == 4)
+    {   return; }
+
+    void* narrow = malloc(column_p->codeBytes * nrow + 1);
+    for (size_t i = 0; i < nrow; i++)
+    {
+        if (column_p->codeBytes == 1)
+        {   *((uint8_t*)narrow + i) = (uint8_t)*(codes + i);   }
+        else
+        {   *((uint16_t*)narrow + i) = (uint16_t)*(codes + i);  }
+    }
+    free(column_p->data);
+    column_p->data = narrow;
+}
+
+//Field [start, stop) without its leading blanks and trailing carriage return.
+static size_t trimField(const char** start_p, const char* stop)
+{
+    const char* start = csv_skipBlanks(*start_p, stop);
+    *start_p = start;
+    return stop > start && *(stop - 1) == '\r' ? stop - start - 1 : stop - start;
+}
+
+//First pass: the number of rows and what each column needs.
+static size_t scanRows(const char* fileName, const char* p, const char* end, size_t ncol, column_scan_t* scans)
+{
+    size_t nrow = 0, rowWidth = 0;
+    csv_scanner_t scanner;
+    csv_initScanner(&scanner, p, end);
+    while (p < end)
+    {
+        const char* stop = csv_nextDelimiter(&scanner);
+        const char* start = csv_skipBlanks(p, stop);
+        if (!csv_isEmptyField(start, stop))
+        {
+            //A text column cannot become anything else.
+            if (rowWidth < ncol && !(scans + rowWidth)->text)
+            {   scanField(start, stop, scans + rowWidth);   }
+            rowWidth++;
+        }
+        if ((stop == end || *stop == '\n') && rowWidth)
+        {
+            if (rowWidth != ncol)
+            {
+                printf("%s: row %zu has %zu columns instead of %zu. \n", fileName, nrow, rowWidth, ncol);
+                exit(1);
+            }
+            nrow++;
+            rowWidth = 0;
+        }
+        p = stop + 1;
+    }
+    return nrow;
+}
+
+//Second pass: parse every field into its column.
+static void parseTypedRows(tdf_dataframe_t* dataframe, const char* p, const char* end, string_table_t* tables)
+{
+    size_t row = 0, col = 0;
+    csv_scanner_t scanner;
+    csv_initScanner(&scanner, p, end);
+    while (p < end)
+    {
+        const char* stop = csv_nextDelimiter(&scanner);
+        const char* start = csv_skipBlanks(p, stop);
+        if (!csv_isEmptyField(start, stop))
+        {
+            tdf_column_t* column = dataframe->columns + col;
+            switch (column->type)
+            {
+                case TDF_INT32:
+                    *((int32_t*)column->data + row) = (int32_t)parseInteger(start, stop);
+                    break;
+                case TDF_INT64:
+                    *((int64_t*)column->data + row) = parseInteger(start, stop);
+                    break;
+                case TDF_FLOAT:
+                    *((float*)column->data + row) = csv_parseFloat(start, stop, end);
+                    break;
+                case TDF_DOUBLE:
+                    *((double*)column->data + row) = csv_parseDouble(start, stop, end);
+                    break;
+                case TDF_STRING:
+                {
+                    const size_t length = trimField(&start, stop);
+                    *((uint32_t*)column->data + row) = internString(tables + col, start, length);
+                    break;
+                }
+            }
+            col++;
+        }
+        if ((stop == end || *stop == '\n') && col)
+        {
+            row++;
+            col = 0;
+        }
+        p = stop + 1;
+    }
+}
+
+tdf_dataframe_t tdf_mapCSV(const char* fileName, bool hasHeader)
+{
+    int fd = open(fileName, O_RDONLY);
+    struct stat fileStat;
+    if (fd < 0 || fstat(fd, &fileStat) != 0)
+    {
+        printf("%s failed to open. \n", fileName);
+        exit(1);
+    }
+
+    tdf_dataframe_t dataframe;
+    dataframe.colNames = NULL; dataframe.colIndices = NULL;
+    dataframe.columns = NULL;
+    dataframe.nrow = 0; dataframe.ncol = 0;
+    const size_t fileSize = (size_t)fileStat.st_size;
+    if (fileSize == 0)
+    {
+        close(fd);
+        return dataframe;
+    }
+
+    const char* map = (const char*)mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED)
+    {
+        printf("%s failed to map. \n", fileName);
+        exit(1);
+    }
+    madvise((void*)map, fileSize, MADV_SEQUENTIAL);
+
+    const char* p = map;
+    const char* end = map + fileSize;
+    if (hasHeader)
+    {   p = csv_parseHeader(p, end, &dataframe.colNames, &dataframe.colIndices, &dataframe.ncol); }
+    else
+    {   dataframe.ncol = csv_firstRowWidth(p, end);    }
+
+    const size_t ncol = dataframe.ncol;
+    column_scan_t* scans = (column_scan_t*)calloc(ncol + 1, sizeof(column_scan_t));
+    dataframe.nrow = scanRows(fileName, p, end, ncol, scans);
+
+    dataframe.columns = (tdf_column_t*)calloc(ncol + 1, sizeof(tdf_column_t));
+    string_table_t* tables = (string_table_t*)calloc(ncol + 1, sizeof(string_table_t));
+    for (size_t j = 0; j < ncol; j++)
+    {
+        tdf_column_t* column = dataframe.columns + j;
+        column->type = columnType(scans + j);
+        column->codeBytes = typeBytes(column->type);
+        column->data = malloc(column->codeBytes * dataframe.nrow + 1);
+        if (column->type == TDF_STRING)
+        {
+            string_table_t* table = tables + j;
+            table->charCapacity = 256;
+            table->stringCapacity = 16;
+            table->slotCapacity = 64;
+            table->dictionary.chars = (char*)malloc(table->charCapacity);
+            table->dictionary.offsets = (size_t*)malloc(sizeof(size_t) * table->stringCapacity);
+            table->lengths = (size_t*)malloc(sizeof(size_t) * table->stringCapacity);
+            table->slots = (uint32_t*)calloc(table->slotCapacity, sizeof(uint32_t));
+        }
+    }
+    parseTypedRows(&dataframe, p, end, tables);
+
+    for (size_t j = 0; j < ncol; j++)
+    {
+        tdf_column_t* column = dataframe.columns + j;
+        if (column->type != TDF_STRING)
+        {   continue;   }
+        column->dictionary = (tables + j)->dictionary;
+        free((tables + j)->slots);
+        free((tables + j)->lengths);
+        narrowCodes(column, dataframe.nrow);
+    }
+    free(tables);
+    free(scans);
+    munmap((void*)map, fileSize);
+    close(fd);
+    return dataframe;
+}
+
+//Dictionary code of row i of a string column.
+static size_t stringCode(const tdf_column_t* column_p, size_t row)
+{
+    if (column_p->codeBytes == 1)
+    {   return *((const uint8_t*)column_p->data + row);  }
+    if (column_p->codeBytes == 2)
+    {   return *((const uint16_t*)column_p->data + row); }
+    return *((const uint32_t*)column_p->data + row);
+}
+
+double tdf_getNumber(tdf_dataframe_t* data_p, const size_t row, const size_t col)
+{
+    if (row >= data_p->nrow || col >= data_p->ncol)
+    {   return NAN; }
+    const tdf_column_t* column = data_p->columns + col;
+    switch (column->type)
+    {
+        case TDF_INT32: return *((const int32_t*)column->data + row);
+        case TDF_INT64: return (double)*((const int64_t*)column->data + row);
+        case TDF_FLOAT: return *((const float*)column->data + row);
+        case TDF_DOUBLE: return *((const double*)column->data + row);
+        default: return NAN;
+    }
+}
+
+const char* tdf_getString(tdf_dataframe_t* data_p, const size_t row, const size_t col)
+{
+    if (row >= data_p->nrow || col >= data_p->ncol || (data_p->columns + col)->type != TDF_STRING)
+    {   return NULL;    }
+    const tdf_column_t* column = data_p->columns + col;
+    return column->dictionary.chars + *(column->dictionary.offsets + stringCode(column, row));
+}
+
+size_t tdf_dataBytes(tdf_dataframe_t* data_p)
+{
+    size_t nBytes = 0;
+    for (size_t j = 0; j < data_p->ncol; j++)
+    {
+        const tdf_column_t* column = data_p->columns + j;
+        nBytes += column->codeBytes * data_p->nrow;
+        if (column->type == TDF_STRING && column->dictionary.nstrings)
+        {
+            const size_t last = column->dictionary.nstrings - 1;
+            const size_t lastOffset = *(column->dictionary.offsets + last);
+            nBytes += lastOffset + strlen(column->dictionary.chars + lastOffset) + 1;
+            nBytes += sizeof(size_t) * column->dictionary.nstrings;
+        }
+    }
+    return nBytes;
+}
+
+const char* tdf_typeName(tdf_type_t type)
+{
+    switch (type)
+    {
+        case TDF_INT32: return "int32";
+        case TDF_INT64: return "int64";
+        case TDF_FLOAT: return "float";
+        case TDF_DOUBLE: return "double";
+        default: return "string";
+    }
+}
+
+void tdf_printColumnTypes(tdf_dataframe_t* data_p)
+{
+    for (size_t j = 0; j < data_p->ncol; j++)
+    {
+        if (data_p->colIndices)
+        {
+            const size_t start = *(data_p->colIndices + j), end = *(data_p->colIndices + j + 1);
+            printf("%.*s:", (int)(end - start), data_p->colNames + start);
+        }
+        printf("%s ", tdf_typeName((data_p->columns + j)->type));
+    }
+    printf("\n");
+}
+
+//Floats and doubles are printed with the digits each type keeps.
+void tdf_printData(tdf_dataframe_t* data_p)
+{
+    for (size_t i = 0; i < data_p->nrow; i++)
+    {
+        for (size_t j = 0; j < data_p->ncol; j++)
+        {
+            const tdf_column_t* column = data_p->columns + j;
+            switch (column->type)
+            {
+                case TDF_INT32: printf("%d ", *((const int32_t*)column->data + i)); break;
+                case TDF_INT64: printf("%lld ", (long long)*((const int64_t*)column->data + i)); break;
+                case TDF_FLOAT: printf("%.*g ", FLT_DIG, *((const float*)column->data + i)); break;
+                case TDF_DOUBLE: printf("%.*g ", DBL_DIG, *((const double*)column->data + i)); break;
+                case TDF_STRING: printf("%s ", tdf_getString(data_p, i, j)); break;
+            }
+        }
+        printf("\n");
+    }
+}
+
+void tdf_freeDataframe(tdf_dataframe_t* data_p)
+{
+    for (size_t j = 0; j < data_p->ncol; j++)
+    {
+        free((data_p->columns + j)->data);
+        free((data_p->columns + j)->dictionary.chars);
+        free((data_p->columns + j)->dictionary.offsets);
+    }
+    free(data_p->columns);
+    free(data_p->colNames);
+    free(data_p->colIndices);
+}
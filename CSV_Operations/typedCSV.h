@@ -0,0 +1,76 @@
+#ifndef TYPEDCSV_H
+#define TYPEDCSV_H
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<stdbool.h>
+#include<stdint.h>
+
+//Column types, from the narrowest. A column takes the narrowest type that
+//holds every one of its fields exactly:
+//  TDF_INT32, TDF_INT64  integers without a decimal point or exponent;
+//  TDF_FLOAT             numbers of at most 6 significant digits, which a
+//                        float reproduces, within the float range;
+//  TDF_DOUBLE            any other number in decimal notation;
+//  TDF_STRING            anything else, such as names or categories.
+typedef enum tdf_type
+{
+    TDF_INT32,
+    TDF_INT64,
+    TDF_FLOAT,
+    TDF_DOUBLE,
+    TDF_STRING
+} tdf_type_t;
+
+//The distinct strings of a column, '\0'-terminated and back to back in chars.
+//String i starts at chars + offsets[i].
+typedef struct tdf_dictionary
+{
+    char* chars;
+    size_t* offsets;
+    size_t nstrings;
+} tdf_dictionary_t;
+
+//A column stores its values contiguously, in the C type of its type. A string
+//column stores an index into its dictionary for each row, in codeBytes bytes:
+//1, 2 or 4 depending on the number of distinct strings.
+typedef struct tdf_column
+{
+    tdf_type_t type;
+    void* data;
+    size_t codeBytes;
+    tdf_dictionary_t dictionary;
+} tdf_column_t;
+
+typedef struct tdf_dataframe
+{
+    char* colNames;
+    size_t* colIndices;
+    tdf_column_t* columns;
+    size_t nrow;
+    size_t ncol;
+} tdf_dataframe_t;
+
+//Read a .csv file with a type for each column. The file is memory-mapped and
+//read twice: once to infer the types, once to parse each field straight into
+//its type, so integers never go through a float. Rows are checked and blank
+//fields skipped as in f32_mapCSV.
+tdf_dataframe_t tdf_mapCSV(const char* fileName, bool hasHeader);
+
+//Value at (row, col) of a numeric column as a double, or NAN for a string
+//column or a cell out of range.
+double tdf_getNumber(tdf_dataframe_t* data_p, const size_t row, const size_t col);
+
+//String at (row, col) of a string column, or NULL otherwise.
+const char* tdf_getString(tdf_dataframe_t* data_p, const size_t row, const size_t col);
+
+//Bytes held by the columns, dictionaries included.
+size_t tdf_dataBytes(tdf_dataframe_t* data_p);
+
+const char* tdf_typeName(tdf_type_t type);
+void tdf_printColumnTypes(tdf_dataframe_t* data_p);
+void tdf_printData(tdf_dataframe_t* data_p);
+void tdf_freeDataframe(tdf_dataframe_t* data_p);
+
+#endif /* TYPEDCSV_H */
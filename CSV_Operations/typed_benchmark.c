@@ -0,0 +1,85 @@
+#include "readCSV.h"
+#include "typedCSV.h"
+#include "benchmarkUtils.h"
+
+#define NUMERIC_FILE "typed_benchmark_numbers.csv"
+#define MIXED_FILE "typed_benchmark_mixed.csv"
+
+static const char* categories[] = { "red", "green", "blue", "cyan", "magenta", "yellow", "black", "white" };
+
+//Write nrow rows of an id, a millisecond timestamp, a quantity, a price with
+//2 decimals and an amount with 4, and with strings, a category.
+static void writeFile(const char* fileName, const size_t nrow, bool withStrings)
+{
+    FILE* file_p = fopen(fileName, "w");
+    if (file_p == NULL)
+    {
+        printf("%s failed to open. \n", fileName);
+        exit(1);
+    }
+
+    fprintf(file_p, withStrings ? "id,timestamp,quantity,price,amount,category\n" : "id,timestamp,quantity,price,amount\n");
+    srand(9999);
+    for (size_t i = 0; i < nrow; i++)
+    {
+        fprintf(file_p, "%zu,%lld,%d,%d.%02d,%d.%04d", i, 1700000000000LL + (long long)i * 1000 + rand() % 1000,
+                rand() % 1000, rand() % 1000, rand() % 100, rand() % 10000000, rand() % 10000);
+        if (withStrings)
+        {   fprintf(file_p, ",%s", categories[rand() % 8]); }
+        fprintf(file_p, "\n");
+    }
+    fclose(file_p);
+}
+
+//Cells of the float dataframe that differ from the value in the file, which
+//the typed dataframe holds exactly.
+static size_t inexactCells(f32_dataframe_t* floats, tdf_dataframe_t* typed)
+{
+    size_t nInexact = 0;
+    for (size_t i = 0; i < floats->nrow; i++)
+    {
+        for (size_t j = 0; j < floats->ncol; j++)
+        {
+            if ((double)*(floats->data + i * floats->rowStride + j) != tdf_getNumber(typed, i, j))
+            {   nInexact++; }
+        }
+    }
+    return nInexact;
+}
+
+//Takes the number of rows as an optional argument.
+int main(int argc, char** argv)
+{
+    const size_t nrow = argc > 1 ? (size_t)atol(argv[1]) : 2000000;
+    writeFile(NUMERIC_FILE, nrow, false);
+    writeFile(MIXED_FILE, nrow, true);
+
+    double start = seconds();
+    f32_dataframe_t floats = f32_mapCSV(NUMERIC_FILE, true);
+    const double floatTime = seconds() - start;
+
+    start = seconds();
+    tdf_dataframe_t typed = tdf_mapCSV(NUMERIC_FILE, true);
+    const double typedTime = seconds() - start;
+
+    start = seconds();
+    tdf_dataframe_t mixed = tdf_mapCSV(MIXED_FILE, true);
+    const double mixedTime = seconds() - start;
+
+    printf("%zu rows \n", nrow);
+    printf("Numeric file, types: ");
+    tdf_printColumnTypes(&typed);
+    printf("  f32_mapCSV: %8.3f ms, %8.1f MB, %zu of %zu cells inexact \n", floatTime * 1e3,
+           sizeof(float) * floats.nrow * floats.ncol / 1e6, inexactCells(&floats, &typed), floats.nrow * floats.ncol);
+    printf("  tdf_mapCSV: %8.3f ms, %8.1f MB \n", typedTime * 1e3, tdf_dataBytes(&typed) / 1e6);
+    printf("With a string column, types: ");
+    tdf_printColumnTypes(&mixed);
+    printf("  tdf_mapCSV: %8.3f ms, %8.1f MB \n", mixedTime * 1e3, tdf_dataBytes(&mixed) / 1e6);
+
+    f32_freeCSV(&floats);
+    tdf_freeDataframe(&typed);
+    tdf_freeDataframe(&mixed);
+    remove(NUMERIC_FILE);
+    remove(MIXED_FILE);
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include "readCSV.h"
+#include "benchmarkUtils.h"
+
+#define BENCHMARK_ROWS 100000
+#define BENCHMARK_COLUMNS 16
+
+//Takes the number of row accesses as an optional argument. Rows are picked at
+//random and their elements summed, once through a malloc'd copy from
+//f32_getRow and once through a view; columns the same way with one access
+//per 10000 row accesses.
+int main(int argc, char** argv)
+{
+    const size_t nAccesses = argc > 1 ? (size_t)atol(argv[1]) : 10000000;
+    const size_t nColAccesses = nAccesses / 10000;
+
+    f32_dataframe_t data = f32_newDataframe(BENCHMARK_ROWS, BENCHMARK_COLUMNS, F32_ROW_MAJOR);
+    for (size_t i = 0; i < BENCHMARK_ROWS * BENCHMARK_COLUMNS; i++)
+    {   *(data.data + i) = (float)(i % 1000);    }
+
+    size_t* rows = (size_t*)malloc(sizeof(size_t) * nAccesses);
+    srand(9999);
+    for (size_t i = 0; i < nAccesses; i++)
+    {   rows[i] = rand() % BENCHMARK_ROWS;  }
+
+    double copySum = 0.0, viewSum = 0.0;
+    double start = seconds();
+    for (size_t i = 0; i < nAccesses; i++)
+    {
+        float* row = f32_getRow(&data, rows[i]);
+        for (size_t j = 0; j < data.ncol; j++)
+        {   copySum += row[j];  }
+        free(row);
+    }
+    const double copyTime = seconds() - start;
+
+    start = seconds();
+    for (size_t i = 0; i < nAccesses; i++)
+    {
+        f32_view_t row = f32_rowView(&data, rows[i]);
+        for (size_t j = 0; j < row.length; j++)
+        {   viewSum += f32_viewAt(row, j);  }
+    }
+    const double viewTime = seconds() - start;
+
+    double colCopySum = 0.0, colViewSum = 0.0;
+    start = seconds();
+    for (size_t i = 0; i < nColAccesses; i++)
+    {
+        float* col = f32_getCol(&data, i % BENCHMARK_COLUMNS);
+        for (size_t j = 0; j < data.nrow; j++)
+        {   colCopySum += col[j];   }
+        free(col);
+    }
+    const double colCopyTime = seconds() - start;
+
+    start = seconds();
+    for (size_t i = 0; i < nColAccesses; i++)
+    {
+        f32_view_t col = f32_colView(&data, i % BENCHMARK_COLUMNS);
+        for (size_t j = 0; j < col.length; j++)
+        {   colViewSum += f32_viewAt(col, j);   }
+    }
+    const double colViewTime = seconds() - start;
+
+    printf("%zu random row accesses of %d floats, ns per access: \n", nAccesses, BENCHMARK_COLUMNS);
+    printf("  f32_getRow + free: %.1f (%zu mallocs) \n", copyTime / nAccesses * 1e9, nAccesses);
+    printf("  f32_rowView:       %.1f (0 mallocs) \n", viewTime / nAccesses * 1e9);
+    printf("%zu column accesses of %d floats, us per access: \n", nColAccesses, BENCHMARK_ROWS);
+    printf("  f32_getCol + free: %.1f (%zu mallocs of %zu bytes) \n", colCopyTime / nColAccesses * 1e6, nColAccesses, sizeof(float) * BENCHMARK_ROWS);
+    printf("  f32_colView:       %.1f (0 mallocs) \n", colViewTime / nColAccesses * 1e6);
+    printf("Sums %s \n", copySum == viewSum && colCopySum == colViewSum ? "match" : "DIFFER");
+
+    free(rows);
+    f32_freeCSV(&data);
+    return 0;
+}
@@ -1,318 +1,154 @@
-#include <iostream>
-#include <vector>
-#include <forward_list>
+#include "AVL_tree.h"
 #include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
 
-template <typename K, typename V>
-struct bt_node {
-    bt_node<K, V> *parent, *left, *right;
-    size_t height;
-    K key;
-    V *object;
-};
-
-template <typename K, typename V>
-class AVL_tree {
-
-    private:
-
-        size_t alloc_size; unsigned alloc_exp;
-        bt_node<K, V> *root, *free_store;
-        std::forward_list< bt_node<K, V>* > released;
-        std::vector< bt_node<K, V>* > allocations;
-        size_t nodes_remaining, nodes_in_tree;
-        
-        AVL_tree(const AVL_tree<V, K>&);
-        AVL_tree<K, V>& operator=(const AVL_tree<K, V>&);
-
-        void allocate_nodes() {
-            
-            this->free_store = new bt_node<K, V>[ this->alloc_size ];
-            this->allocations.push_back( this->free_store );
-            this->nodes_remaining = this->alloc_size;
-            this->alloc_size *= this->alloc_exp;
-        }
-
-        bt_node<K, V>* get_node() {
-
-            if( ! this->released.empty() ) {
-                bt_node<K, V> *new_node = this->released.front();
-                this->released.pop_front();
-                return new_node;
-            }
-
-            if( ! this->nodes_remaining ) allocate_nodes();
-            
-            this->nodes_remaining--;
-            return this->free_store++;
-        }
-
-        void delete_node(bt_node<K, V> *node) {
-            this->released.push_front(node);
-        }
-
-        bt_node<K, V>* leftmost_node(bt_node<K, V> *root) {
-
-            bt_node<K, V> *tmp_node = root;
-            while( tmp_node->left ) tmp_node = tmp_node->left;
-
-            return tmp_node;
-        }
-
-        bt_node<K, V>* rightmost_node(bt_node<K, V> *root) {
-
-            bt_node<K, V> *tmp_node = root;
-            while( tmp_node->right ) tmp_node = tmp_node->right;
-
-            return tmp_node;
-        }
-
-        void swap_node_contents(bt_node<K, V> *node1, bt_node<K, V> *node2) {
-
-            K tmp_key = node1->key; V *tmp_value = node1->object;
-            node1->key = node2->key; node1->object = node2->object;
-            node2->key = tmp_key; node2->object = tmp_value;
-        }
-
-        void height_bubble_up(bt_node<K, V> *root) {
-            
-            size_t height_l = 0UL, height_r = 0UL;
-            while( root ) {
-                if( root->left ) height_l = root->left->height;
-                if( root->right ) height_r = root->right->height;
-                root->height = 1 + std::max<size_t>(height_l, height_r);
-                root = root->parent;
-            }   
-        }
-
-        int skew(bt_node<K, V> *node) {
-
-            size_t height_l = 0UL, height_r = 0UL;
-            if( node->left ) height_l = node->left->height;
-            if( node->right ) height_r = node->right->height;
-            return height_r - height_l;
-        }
-
-        void left_rotation(bt_node<K, V> *root) {
-            
-            if( root->parent ) {
-                if( root->parent->left == root ) root->parent->left = root->right;
-                else root->parent->right = root->right;
-            } else this->root = root->right;
-
-            root->right->parent = root->parent;
-            root->parent = root->right;
-            root->right = root->parent->left;
-            if( root->right ) root->right->parent = root;
-            root->parent->left = root;
-            this->height_bubble_up(root);
-        }
-
-        void right_rotation(bt_node<K, V> *root) {
-            
-            if( root->parent ) {
-                if( root->parent->left == root ) root->parent->left = root->left;
-                else root->parent->right = root->left;
-            } else this->root = root->left;
-
-            root->left->parent = root->parent;
-            root->parent = root->left;
-            root->left = root->parent->right;
-            if( root->left ) root->left->parent = root;
-            root->parent->right = root;
-            this->height_bubble_up(root);
-        }
-
-        void balance_tree(bt_node<K, V> *root) {
-
-            this->height_bubble_up(root);
-            while( root ) {
-                int skew = this->skew(root);
-                if( skew > 1 ) {
-                    if( this->skew(root->right) > -1 ) this->left_rotation(root);
-                    else {
-                        this->right_rotation(root->right);
-                        this->left_rotation(root);
-                    }
-                } else if( skew < -1 ) {
-                    if( this->skew(root->left) < 1 ) this->right_rotation(root);
-                    else {
-                        this->left_rotation(root->left);
-                        this->right_rotation(root);
-                    }
-                }
-                root = root->parent;
-            } 
-        } 
-
-    public:
-
-        AVL_tree(size_t alloc_size = 10, unsigned alloc_exp = 2)
-            : alloc_size(alloc_size), alloc_exp(alloc_exp) {
-
-                this->root = NULL;
-                this->nodes_in_tree = this->nodes_remaining = 0;
-            }
-
-        ~AVL_tree() {
-            for(const auto &mem_address : this->allocations ) {
-                delete[] mem_address;
-            }
-        }
-
-        bt_node<K, V>* previous(bt_node<K, V> *node) {
-
-            if( node->left ) return this->rightmost_node( node->left );
-            if( node == this->leftmost_node(this->root) ) return NULL;
-
-            bt_node<K, V> *tmp_node = node;
-            while( tmp_node->parent->right != tmp_node ) tmp_node = tmp_node->parent;
-
-            return tmp_node->parent;
-        }
-
-        bt_node<K, V>* next(bt_node<K, V> *node) {
-
-            if( node->right ) return this->leftmost_node( node->right );
-            if( node == this->rightmost_node(this->root) ) return NULL;
-
-            bt_node<K, V> *tmp_node = node;
-            while( tmp_node->parent->left != tmp_node ) tmp_node = tmp_node->parent;
-            
-            return tmp_node->parent;
-        }
-
-        void insert_previous(bt_node<K, V> *anchor_node, bt_node<K, V> *new_node) {
-            
-            if( ! anchor_node->left ) {
-                anchor_node->left = new_node;
-                new_node->parent = anchor_node;
-                this->balance_tree(anchor_node);
-                this->nodes_in_tree++;
-                return;
-            }
-
-            anchor_node = this->previous(anchor_node);
-            anchor_node->right = new_node;
-            new_node->parent = anchor_node;
-            this->balance_tree(anchor_node);
-            this->nodes_in_tree++;
-        }
-
-        void insert_next(bt_node<K, V> *anchor_node, bt_node<K, V> *new_node) {
-
-            if( ! anchor_node->right ) {
-                anchor_node->right = new_node;
-                new_node->parent = anchor_node;
-                this->balance_tree(anchor_node);
-                this->nodes_in_tree++;
-            }
-
-            anchor_node = this->next(anchor_node);
-            anchor_node->left = new_node;
-            new_node->parent = anchor_node;
-            this->balance_tree(anchor_node);
-            this->nodes_in_tree++;
-        }
-
-        bt_node<K, V>* find(const K key) {
-
-            bt_node<K, V> *tmp_node = this->root;
-            while( tmp_node ) {
-                if( key < tmp_node->key ) tmp_node = tmp_node->left;
-                else if ( key > tmp_node->key ) tmp_node = tmp_node->right;
-                else return tmp_node;
-            }
-
-            return NULL;
-        } 
-
-        bt_node<K, V>* insert(const K key, V *value) {
+// Checks heights, sizes, balance, parent links and key order below 'node', and
+// appends the keys in order to 'keys'. Returns the subtree height, or -1 if
+// an invariant is broken.
+template <typename M>
+long check_subtree(bt_node<int, int, M> *node, bt_node<int, int, M> *parent, std::vector<int> &keys) {
+
+    if( ! node ) return 0;
+    if( node->parent != parent ) return -1;
+    long left = check_subtree(node->left, node, keys);
+    keys.push_back(node->key);
+    long right = check_subtree(node->right, node, keys);
+    if( left < 0 || right < 0 || left - right > 1 || right - left > 1 ) return -1;
+    if( (long)node->height != 1 + std::max(left, right) ) return -1;
+    size_t size = 1 + (node->left ? node->left->size : 0) + (node->right ? node->right->size : 0);
+    if( node->size != size ) return -1;
+    return node->height;
+}
 
-            bt_node<K, V> *new_node = this->get_node(), *tmp_node = this->root, *prev_node;
-            new_node->key = key; new_node->object = value;
-            new_node->height = 1UL;
-            new_node->left = new_node->right = NULL;
+template <typename Alloc, typename M>
+bool tree_matches(AVL_tree<int, int, Alloc, M> &tree, const std::set<int> &expected) {
 
-            if( ! this->root ) {
-                this->root = new_node;
-                new_node->parent = NULL;
-                this->nodes_in_tree++;
-                return new_node;
-            }
+    std::vector<int> keys;
+    if( check_subtree<M>(tree.get_root(), NULL, keys) < 0 ) return false;
+    return tree.size() == expected.size() && std::equal(keys.begin(), keys.end(), expected.begin(), expected.end());
+}
 
-            while( tmp_node ) {
-                prev_node = tmp_node;
-                if( key < tmp_node->key ) tmp_node = tmp_node->left;
-                else if( key > tmp_node->key ) tmp_node = tmp_node->right;
-                else return NULL;
-            }
+// Runs the bulk-load and set operations on random key sets and compares the
+// results with std::set, sequentially and on a thread pool.
+bool check_set_operations(thread_pool *pool) {
+
+    std::mt19937 rng(9999);
+    static int value = 0;
+    slab_allocator< bt_node<int, int> > shared(64, 2);
+
+    for( int round = 0; round < 20; round++ ) {
+        std::set<int> a_keys, b_keys;
+        size_t n = 1 + rng() % 50000;
+        while( a_keys.size() < n ) a_keys.insert(rng() % 100000);
+        while( b_keys.size() < n / 2 + 1 ) b_keys.insert(rng() % 100000);
+
+        std::vector< std::pair<int, int*> > a_entries, b_entries;
+        for( int key : a_keys ) a_entries.push_back(std::make_pair(key, &value));
+        for( int key : b_keys ) b_entries.push_back(std::make_pair(key, &value));
+
+        std::set<int> expected;
+        AVL_tree<int, int> a(shared), b(shared), c;
+        a.build_from_sorted(a_entries.begin(), a_entries.end());
+        if( ! tree_matches(a, a_keys) ) return false;
+
+        // 'c' has its own allocator, so its nodes are copied rather than moved.
+        b.build_from_sorted(b_entries.begin(), b_entries.end());
+        c.build_from_sorted(b_entries.begin(), b_entries.end());
+        a.union_with(b, pool);
+        std::set_union(a_keys.begin(), a_keys.end(), b_keys.begin(), b_keys.end(), std::inserter(expected, expected.end()));
+        if( ! tree_matches(a, expected) || b.size() ) return false;
+
+        a.build_from_sorted(a_entries.begin(), a_entries.end());
+        a.intersect_with(c, pool);
+        expected.clear();
+        std::set_intersection(a_keys.begin(), a_keys.end(), b_keys.begin(), b_keys.end(), std::inserter(expected, expected.end()));
+        if( ! tree_matches(a, expected) || c.size() ) return false;
+
+        a.build_from_sorted(a_entries.begin(), a_entries.end());
+        b.build_from_sorted(b_entries.begin(), b_entries.end());
+        a.subtract(b, pool);
+        expected.clear();
+        std::set_difference(a_keys.begin(), a_keys.end(), b_keys.begin(), b_keys.end(), std::inserter(expected, expected.end()));
+        if( ! tree_matches(a, expected) ) return false;
+
+        a.build_from_sorted(a_entries.begin(), a_entries.end());
+        int pivot = rng() % 100000;
+        a.split(pivot, c);
+        std::set<int> lower(a_keys.begin(), a_keys.upper_bound(pivot)), upper(a_keys.upper_bound(pivot), a_keys.end());
+        if( ! tree_matches(a, lower) || ! tree_matches(c, upper) ) return false;
+
+        // A tree combined with itself.
+        a.build_from_sorted(a_entries.begin(), a_entries.end());
+        a.union_with(a, pool);
+        if( ! tree_matches(a, a_keys) ) return false;
+        a.intersect_with(a, pool);
+        if( ! tree_matches(a, a_keys) ) return false;
+        a.subtract(a, pool);
+        if( ! tree_matches(a, std::set<int>()) ) return false;
+    }
+    return true;
+}
 
-            if( key < prev_node->key ) prev_node->left = new_node;
-            else prev_node->right = new_node;
-            new_node->parent = prev_node;
-            this->balance_tree(prev_node);
-            this->nodes_in_tree++;
-            return new_node;
-        }
+// Inserts and removes random keys in a tree with a sum monoid and compares
+// select, rank, range_count, range_reduce and the iterators with a brute-force
+// scan of std::set.
+bool check_order_statistics() {
 
-        int remove(const K key) {
-            
-            bt_node<K, V> *node_to_remove, *tmp_node;
-            node_to_remove = this->find(key);
-            if( ! node_to_remove ) return 0;
+    typedef AVL_tree<int, int, slab_allocator< bt_node<int, int, sum_of_values<int, int> > >, sum_of_values<int, int> > sum_tree;
 
-            while( node_to_remove->left || node_to_remove->right ) {
-                if( node_to_remove->left ) tmp_node = this->previous( node_to_remove );
-                else tmp_node = this->next( node_to_remove );
-                this->swap_node_contents(node_to_remove, tmp_node);
-                node_to_remove = tmp_node;
-            }
+    std::mt19937 rng(9999);
+    std::vector<int> values(2000);
+    for( int i = 0; i < 2000; i++ ) values[i] = i % 7 - 3;
 
-            if( ! node_to_remove->parent ) this->root = NULL;
-            else {
-                if( node_to_remove == node_to_remove->parent->left ) node_to_remove->parent->left = NULL;
-                else node_to_remove->parent->right = NULL;
-                this->balance_tree(node_to_remove->parent);
-            }
-            this->delete_node(node_to_remove);
-            this->nodes_in_tree--;
-            return 1;
+    sum_tree tree;
+    std::set<int> keys;
+    for( int round = 0; round < 5000; round++ ) {
+        int key = rng() % 2000;
+        if( rng() % 3 ) {
+            tree.insert(key, &values[key]);
+            keys.insert(key);
+        } else {
+            tree.remove(key);
+            keys.erase(key);
         }
 
-        size_t height() {
-            if( this->root ) return this->root->height;
-            return 0UL;
-        }
+        if( round % 50 ) continue;
+        if( ! tree_matches(tree, keys) ) return false;
 
-        size_t size() {
-            return this->nodes_in_tree;
-        }
+        std::vector<int> in_order;
+        for( sum_tree::iterator it = tree.begin(); it != tree.end(); ++it ) in_order.push_back(it.key());
+        if( ! std::equal(in_order.begin(), in_order.end(), keys.begin(), keys.end()) ) return false;
 
-        bt_node<K, V>* get_root() {
-            return this->root;
+        for( size_t k = 0; k <= in_order.size(); k++ ) {
+            bt_node<int, int, sum_of_values<int, int> > *node = tree.select(k);
+            if( k == in_order.size() ? node != NULL : ! node || node->key != in_order[k] ) return false;
         }
 
-        void print() {
-
-            if( ! this->root ) return;
-
-            std::cout << "Size: " << this->size() << " ";
-            std::cout << "Height: " << this->height() << " ";
-            std::cout << "Skew: " << this->skew(this->root) << "\n";
-
-            bt_node<K, V> *tmp_node = this->leftmost_node(this->root);
-            while( tmp_node ) {
-                std::cout << *( tmp_node->object ) << " ";
-                tmp_node = this->next(tmp_node);
+        for( int probe = 0; probe < 20; probe++ ) {
+            int lo = (int)(rng() % 2100) - 50, hi = (int)(rng() % 2100) - 50;
+            size_t count = 0, less = 0;
+            int sum = 0;
+            for( int k : keys ) {
+                if( k < lo ) less++;
+                if( lo <= k && k < hi ) { count++; sum += values[k]; }
             }
-            std::cout << std::endl;
-        }
-
-};
-
-
-
+            sum_tree::iterator first = tree.lower_bound(lo);
+            std::set<int>::iterator expected_first = keys.lower_bound(lo);
+            if( (first == tree.end()) != (expected_first == keys.end()) ) return false;
+            if( first != tree.end() && first.key() != *expected_first ) return false;
+            if( tree.rank(lo) != less || tree.range_count(lo, hi) != count ) return false;
+            if( tree.range_reduce(lo, hi) != sum ) return false;
+        }
+
+        int total = 0;
+        for( int k : keys ) total += values[k];
+        if( tree.reduce() != total ) return false;
+    }
+    return true;
+}
 
 int main() {
 
@@ -338,4 +174,9 @@ int main() {
 
     //bt_node<int, double> *node = my_tree.find(5);
     //std::cout << node->parent->key << std::endl;
+
+    std::cout << "Set operations: " << (check_set_operations(NULL) ? "passed" : "FAILED") << std::endl;
+    thread_pool pool(4);
+    std::cout << "Parallel set operations: " << (check_set_operations(&pool) ? "passed" : "FAILED") << std::endl;
+    std::cout << "Order statistics: " << (check_order_statistics() ? "passed" : "FAILED") << std::endl;
 }
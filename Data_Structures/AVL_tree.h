@@ -0,0 +1,953 @@
+#ifndef AVL_TREE_H
+#define AVL_TREE_H
+
+#include "slab_allocator.h"
+#include "work_stealing.h"
+#include <iostream>
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+
+// Node of an AVL_tree. 'size' is the number of nodes in the subtree rooted at
+// the node, and 'aggregate' combines the entries of that subtree, in key order,
+// with the monoid M. Trees without a monoid use the specialization below.
+template <typename K, typename V, typename M = void>
+struct bt_node {
+    bt_node<K, V, M> *parent, *left, *right;
+    size_t height, size;
+    K key;
+    V *object;
+    typename M::value_type aggregate;
+};
+
+template <typename K, typename V>
+struct bt_node<K, V, void> {
+    bt_node<K, V> *parent, *left, *right;
+    size_t height, size;
+    K key;
+    V *object;
+};
+
+// Monoid summing the values of a subtree. A monoid provides an identity, the
+// value of a single entry, and an associative 'combine'.
+template <typename K, typename V>
+struct sum_of_values {
+    typedef V value_type;
+    static V identity() { return V(); }
+    static V of(const K&, V *object) { return *object; }
+    static V combine(const V &a, const V &b) { return a + b; }
+};
+
+template <typename K, typename V, typename Alloc = slab_allocator< bt_node<K, V> >, typename M = void>
+class AVL_tree {
+
+    private:
+
+        typedef typename std::allocator_traits<Alloc>::template rebind_alloc< bt_node<K, V, M> > node_allocator;
+        typedef std::allocator_traits<node_allocator> node_traits;
+
+        node_allocator alloc;
+        // Released is the head of a singly-linked list of discarded nodes,
+        // linked through their 'parent' pointers.
+        bt_node<K, V, M> *root, *released;
+        size_t nodes_in_tree;
+        
+        AVL_tree(const AVL_tree&) = delete;
+        AVL_tree& operator=(const AVL_tree&) = delete;
+
+        bt_node<K, V, M>* get_node() {
+
+            if( this->released ) {
+                bt_node<K, V, M> *new_node = this->released;
+                this->released = new_node->parent;
+                return new_node;
+            }
+
+            bt_node<K, V, M> *new_node = node_traits::allocate(this->alloc, 1);
+            node_traits::construct(this->alloc, new_node);
+            return new_node;
+        }
+
+        void delete_node(bt_node<K, V, M> *node) {
+            node->parent = this->released;
+            this->released = node;
+        }
+
+        void free_node(bt_node<K, V, M> *node) {
+            node_traits::destroy(this->alloc, node);
+            node_traits::deallocate(this->alloc, node, 1);
+        }
+
+        // Returns every node of the subtree rooted at 'root' to the allocator.
+        void free_subtree(bt_node<K, V, M> *root) {
+
+            if( ! root ) return;
+            this->free_subtree(root->left);
+            this->free_subtree(root->right);
+            this->free_node(root);
+        }
+
+        bt_node<K, V, M>* leftmost_node(bt_node<K, V, M> *root) {
+
+            bt_node<K, V, M> *tmp_node = root;
+            while( tmp_node->left ) tmp_node = tmp_node->left;
+
+            return tmp_node;
+        }
+
+        bt_node<K, V, M>* rightmost_node(bt_node<K, V, M> *root) {
+
+            bt_node<K, V, M> *tmp_node = root;
+            while( tmp_node->right ) tmp_node = tmp_node->right;
+
+            return tmp_node;
+        }
+
+        void swap_node_contents(bt_node<K, V, M> *node1, bt_node<K, V, M> *node2) {
+
+            K tmp_key = node1->key; V *tmp_value = node1->object;
+            node1->key = node2->key; node1->object = node2->object;
+            node2->key = tmp_key; node2->object = tmp_value;
+        }
+
+        void height_bubble_up(bt_node<K, V, M> *root) {
+            
+            while( root ) {
+                update_node(root);
+                root = root->parent;
+            }   
+        }
+
+        int skew(bt_node<K, V, M> *node) {
+
+            size_t height_l = 0UL, height_r = 0UL;
+            if( node->left ) height_l = node->left->height;
+            if( node->right ) height_r = node->right->height;
+            return height_r - height_l;
+        }
+
+        void left_rotation(bt_node<K, V, M> *root) {
+            
+            if( root->parent ) {
+                if( root->parent->left == root ) root->parent->left = root->right;
+                else root->parent->right = root->right;
+            } else this->root = root->right;
+
+            root->right->parent = root->parent;
+            root->parent = root->right;
+            root->right = root->parent->left;
+            if( root->right ) root->right->parent = root;
+            root->parent->left = root;
+            this->height_bubble_up(root);
+        }
+
+        void right_rotation(bt_node<K, V, M> *root) {
+            
+            if( root->parent ) {
+                if( root->parent->left == root ) root->parent->left = root->left;
+                else root->parent->right = root->left;
+            } else this->root = root->left;
+
+            root->left->parent = root->parent;
+            root->parent = root->left;
+            root->left = root->parent->right;
+            if( root->left ) root->left->parent = root;
+            root->parent->right = root;
+            this->height_bubble_up(root);
+        }
+
+        // Subtrees at least this tall are processed in parallel by the set
+        // operations when they are given a thread pool.
+        static const size_t PARALLEL_HEIGHT = 14;
+
+        // Nodes discarded by a set operation, linked through their 'parent'
+        // pointers like the released list so that they can be spliced onto it.
+        struct node_list {
+            bt_node<K, V, M> *head, *tail;
+            size_t length;
+
+            node_list() : head(NULL), tail(NULL), length(0UL) {}
+
+            void push(bt_node<K, V, M> *node) {
+                node->parent = this->head;
+                this->head = node;
+                if( ! this->tail ) this->tail = node;
+                this->length++;
+            }
+
+            void push_subtree(bt_node<K, V, M> *root) {
+                if( ! root ) return;
+                this->push_subtree(root->left);
+                this->push_subtree(root->right);
+                this->push(root);
+            }
+
+            void splice(node_list &other) {
+                if( ! other.head ) return;
+                other.tail->parent = this->head;
+                this->head = other.head;
+                if( ! this->tail ) this->tail = other.tail;
+                this->length += other.length;
+                other.head = other.tail = NULL;
+                other.length = 0UL;
+            }
+        };
+
+        static size_t node_height(bt_node<K, V, M> *node) {
+            return node ? node->height : 0UL;
+        }
+
+        static size_t node_size(bt_node<K, V, M> *node) {
+            return node ? node->size : 0UL;
+        }
+
+        template <typename M2 = M>
+        static typename M2::value_type node_aggregate(bt_node<K, V, M> *node) {
+            return node ? node->aggregate : M2::identity();
+        }
+
+        // Recomputes the height, size and aggregate of 'node' from its children.
+        static void update_node(bt_node<K, V, M> *node) {
+            node->height = 1 + std::max<size_t>(node_height(node->left), node_height(node->right));
+            node->size = 1 + node_size(node->left) + node_size(node->right);
+            if constexpr ( ! std::is_void<M>::value ) {
+                node->aggregate = M::combine(M::combine(node_aggregate(node->left),
+                    M::of(node->key, node->object)), node_aggregate(node->right));
+            }
+        }
+
+        // In-order successor of 'node', or NULL for the largest key. Amortized O(1)
+        // over a full scan, since every edge is climbed at most once.
+        static bt_node<K, V, M>* successor(bt_node<K, V, M> *node) {
+
+            if( node->right ) {
+                node = node->right;
+                while( node->left ) node = node->left;
+                return node;
+            }
+            while( node->parent && node->parent->right == node ) node = node->parent;
+            return node->parent;
+        }
+
+        static bt_node<K, V, M>* predecessor(bt_node<K, V, M> *node) {
+
+            if( node->left ) {
+                node = node->left;
+                while( node->right ) node = node->right;
+                return node;
+            }
+            while( node->parent && node->parent->left == node ) node = node->parent;
+            return node->parent;
+        }
+
+        static void set_left(bt_node<K, V, M> *node, bt_node<K, V, M> *child) {
+            node->left = child;
+            if( child ) child->parent = node;
+        }
+
+        static void set_right(bt_node<K, V, M> *node, bt_node<K, V, M> *child) {
+            node->right = child;
+            if( child ) child->parent = node;
+        }
+
+        // Rotations on a detached subtree. They return the new subtree root and
+        // leave linking it to a parent to the caller.
+        static bt_node<K, V, M>* rotate_left(bt_node<K, V, M> *root) {
+            bt_node<K, V, M> *new_root = root->right;
+            set_right(root, new_root->left);
+            set_left(new_root, root);
+            update_node(root);
+            update_node(new_root);
+            return new_root;
+        }
+
+        static bt_node<K, V, M>* rotate_right(bt_node<K, V, M> *root) {
+            bt_node<K, V, M> *new_root = root->left;
+            set_left(root, new_root->right);
+            set_right(new_root, root);
+            update_node(root);
+            update_node(new_root);
+            return new_root;
+        }
+
+        // Join of a taller 'left' with 'middle' and 'right', descending the right spine of 'left'.
+        static bt_node<K, V, M>* join_right(bt_node<K, V, M> *left, bt_node<K, V, M> *middle, bt_node<K, V, M> *right) {
+
+            bt_node<K, V, M> *outer = left->left, *inner = left->right;
+            if( node_height(inner) <= node_height(right) + 1 ) {
+                set_left(middle, inner);
+                set_right(middle, right);
+                update_node(middle);
+                if( node_height(middle) <= node_height(outer) + 1 ) {
+                    set_right(left, middle);
+                    update_node(left);
+                    return left;
+                }
+                set_right(left, rotate_right(middle));
+                update_node(left);
+                return rotate_left(left);
+            }
+
+            bt_node<K, V, M> *joined = join_right(inner, middle, right);
+            set_right(left, joined);
+            update_node(left);
+            if( node_height(joined) <= node_height(outer) + 1 ) return left;
+            return rotate_left(left);
+        }
+
+        static bt_node<K, V, M>* join_left(bt_node<K, V, M> *left, bt_node<K, V, M> *middle, bt_node<K, V, M> *right) {
+
+            bt_node<K, V, M> *outer = right->right, *inner = right->left;
+            if( node_height(inner) <= node_height(left) + 1 ) {
+                set_left(middle, left);
+                set_right(middle, inner);
+                update_node(middle);
+                if( node_height(middle) <= node_height(outer) + 1 ) {
+                    set_left(right, middle);
+                    update_node(right);
+                    return right;
+                }
+                set_left(right, rotate_left(middle));
+                update_node(right);
+                return rotate_right(right);
+            }
+
+            bt_node<K, V, M> *joined = join_left(left, middle, inner);
+            set_left(right, joined);
+            update_node(right);
+            if( node_height(joined) <= node_height(outer) + 1 ) return right;
+            return rotate_right(right);
+        }
+
+        // Balanced tree holding 'left', then 'middle', then 'right', where every
+        // key of 'left' is below middle's key and every key of 'right' above it.
+        // Runs in O(|height(left) - height(right)|).
+        static bt_node<K, V, M>* join(bt_node<K, V, M> *left, bt_node<K, V, M> *middle, bt_node<K, V, M> *right) {
+
+            bt_node<K, V, M> *root;
+            if( node_height(left) > node_height(right) + 1 ) root = join_right(left, middle, right);
+            else if( node_height(right) > node_height(left) + 1 ) root = join_left(left, middle, right);
+            else {
+                set_left(middle, left);
+                set_right(middle, right);
+                update_node(middle);
+                root = middle;
+            }
+            root->parent = NULL;
+            return root;
+        }
+
+        // Detaches the largest node of 'root' and returns the remaining tree.
+        static bt_node<K, V, M>* split_last(bt_node<K, V, M> *root, bt_node<K, V, M> *&last) {
+
+            if( ! root->right ) {
+                last = root;
+                if( root->left ) root->left->parent = NULL;
+                return root->left;
+            }
+            bt_node<K, V, M> *rest = split_last(root->right, last);
+            return join(root->left, root, rest);
+        }
+
+        // Join of 'left' and 'right' without a middle node.
+        static bt_node<K, V, M>* join2(bt_node<K, V, M> *left, bt_node<K, V, M> *right) {
+
+            if( ! left ) return right;
+            bt_node<K, V, M> *last;
+            left = split_last(left, last);
+            return join(left, last, right);
+        }
+
+        // Splits 'root' into the keys below 'key' (returned through 'left'), the
+        // node holding 'key' if any (returned), and the keys above it ('right').
+        static bt_node<K, V, M>* split(bt_node<K, V, M> *root, const K &key, bt_node<K, V, M> *&left, bt_node<K, V, M> *&right) {
+
+            if( ! root ) {
+                left = right = NULL;
+                return NULL;
+            }
+
+            bt_node<K, V, M> *l = root->left, *r = root->right, *found;
+            if( l ) l->parent = NULL;
+            if( r ) r->parent = NULL;
+
+            if( key < root->key ) {
+                found = split(l, key, left, l);
+                right = join(l, root, r);
+            } else if( key > root->key ) {
+                found = split(r, key, r, right);
+                left = join(l, root, r);
+            } else {
+                left = l; right = r;
+                root->left = root->right = NULL;
+                return root;
+            }
+            return found;
+        }
+
+        // Runs 'first' and 'second', in parallel when 'pool' is given and the
+        // subtree is tall enough to be worth it.
+        template <typename F1, typename F2>
+        static void fork(thread_pool *pool, size_t height, F1 first, F2 second) {
+
+            if( pool && height >= PARALLEL_HEIGHT ) {
+                pool->parallel_for(0, 2, 1, [&](size_t branch, size_t) {
+                    if( branch ) second(); else first();
+                });
+            } else {
+                first();
+                second();
+            }
+        }
+
+        static bt_node<K, V, M>* union_of(bt_node<K, V, M> *a, bt_node<K, V, M> *b, node_list &discarded, thread_pool *pool) {
+
+            if( ! a ) return b;
+            if( ! b ) return a;
+
+            bt_node<K, V, M> *b_left, *b_right, *a_left = a->left, *a_right = a->right;
+            bt_node<K, V, M> *duplicate = split(b, a->key, b_left, b_right);
+            if( duplicate ) discarded.push(duplicate);
+            if( a_left ) a_left->parent = NULL;
+            if( a_right ) a_right->parent = NULL;
+
+            node_list right_discarded;
+            bt_node<K, V, M> *left, *right;
+            fork(pool, a->height,
+                [&]() { left = union_of(a_left, b_left, discarded, pool); },
+                [&]() { right = union_of(a_right, b_right, right_discarded, pool); });
+            discarded.splice(right_discarded);
+            return join(left, a, right);
+        }
+
+        static bt_node<K, V, M>* intersection_of(bt_node<K, V, M> *a, bt_node<K, V, M> *b, node_list &discarded, thread_pool *pool) {
+
+            if( ! a || ! b ) {
+                discarded.push_subtree(a);
+                discarded.push_subtree(b);
+                return NULL;
+            }
+
+            bt_node<K, V, M> *b_left, *b_right, *a_left = a->left, *a_right = a->right;
+            bt_node<K, V, M> *match = split(b, a->key, b_left, b_right);
+            if( a_left ) a_left->parent = NULL;
+            if( a_right ) a_right->parent = NULL;
+
+            node_list right_discarded;
+            bt_node<K, V, M> *left, *right;
+            fork(pool, a->height,
+                [&]() { left = intersection_of(a_left, b_left, discarded, pool); },
+                [&]() { right = intersection_of(a_right, b_right, right_discarded, pool); });
+            discarded.splice(right_discarded);
+
+            if( match ) {
+                discarded.push(match);
+                return join(left, a, right);
+            }
+            discarded.push(a);
+            return join2(left, right);
+        }
+
+        static bt_node<K, V, M>* difference_of(bt_node<K, V, M> *a, bt_node<K, V, M> *b, node_list &discarded, thread_pool *pool) {
+
+            if( ! a || ! b ) {
+                discarded.push_subtree(b);
+                return a;
+            }
+
+            bt_node<K, V, M> *b_left, *b_right, *a_left = a->left, *a_right = a->right;
+            bt_node<K, V, M> *match = split(b, a->key, b_left, b_right);
+            if( a_left ) a_left->parent = NULL;
+            if( a_right ) a_right->parent = NULL;
+
+            node_list right_discarded;
+            bt_node<K, V, M> *left, *right;
+            fork(pool, a->height,
+                [&]() { left = difference_of(a_left, b_left, discarded, pool); },
+                [&]() { right = difference_of(a_right, b_right, right_discarded, pool); });
+            discarded.splice(right_discarded);
+
+            if( match ) {
+                discarded.push(match);
+                discarded.push(a);
+                return join2(left, right);
+            }
+            return join(left, a, right);
+        }
+
+        // Builds a perfectly balanced subtree from the sorted entries [first, last).
+        template <typename RandomIt>
+        bt_node<K, V, M>* build_subtree(RandomIt first, RandomIt last, bt_node<K, V, M> *parent) {
+
+            if( first == last ) return NULL;
+            RandomIt middle = first + (last - first) / 2;
+            bt_node<K, V, M> *node = this->get_node();
+            node->key = middle->first; node->object = middle->second;
+            node->parent = parent;
+            node->left = this->build_subtree(first, middle, node);
+            node->right = this->build_subtree(middle + 1, last, node);
+            update_node(node);
+            return node;
+        }
+
+        // Copies the subtree rooted at 'root' into nodes from this tree's allocator.
+        bt_node<K, V, M>* clone_subtree(bt_node<K, V, M> *root, bt_node<K, V, M> *parent) {
+
+            if( ! root ) return NULL;
+            bt_node<K, V, M> *node = this->get_node();
+            node->key = root->key; node->object = root->object;
+            node->parent = parent;
+            node->left = this->clone_subtree(root->left, node);
+            node->right = this->clone_subtree(root->right, node);
+            update_node(node);
+            return node;
+        }
+
+        // Takes every node of 'other', leaving it empty. The nodes are moved
+        // when both trees share an allocator and copied otherwise.
+        bt_node<K, V, M>* adopt(AVL_tree &other) {
+
+            bt_node<K, V, M> *adopted;
+            if( this->alloc == other.alloc ) adopted = other.root;
+            else {
+                adopted = this->clone_subtree(other.root, NULL);
+                other.free_subtree(other.root);
+            }
+            other.root = NULL;
+            other.nodes_in_tree = 0;
+            return adopted;
+        }
+
+        // Installs 'root' as the tree and recycles the discarded nodes.
+        void finish_set_operation(bt_node<K, V, M> *root, size_t total_nodes, node_list &discarded) {
+
+            this->root = root;
+            if( root ) root->parent = NULL;
+            this->nodes_in_tree = total_nodes - discarded.length;
+            if( discarded.head ) {
+                discarded.tail->parent = this->released;
+                this->released = discarded.head;
+            }
+        }
+
+        void balance_tree(bt_node<K, V, M> *root) {
+
+            this->height_bubble_up(root);
+            while( root ) {
+                int skew = this->skew(root);
+                if( skew > 1 ) {
+                    if( this->skew(root->right) > -1 ) this->left_rotation(root);
+                    else {
+                        this->right_rotation(root->right);
+                        this->left_rotation(root);
+                    }
+                } else if( skew < -1 ) {
+                    if( this->skew(root->left) < 1 ) this->right_rotation(root);
+                    else {
+                        this->left_rotation(root->left);
+                        this->right_rotation(root);
+                    }
+                }
+                root = root->parent;
+            } 
+        } 
+
+    public:
+
+        // Nodes come from a private arena whose blocks start at 'alloc_size'
+        // nodes and grow by a factor of 'alloc_exp'.
+        AVL_tree(size_t alloc_size = 10, unsigned alloc_exp = 2)
+            : alloc(alloc_size, alloc_exp) {
+
+                this->root = this->released = NULL;
+                this->nodes_in_tree = 0;
+            }
+
+        // Nodes come from 'alloc', which may be shared with other containers.
+        explicit AVL_tree(const Alloc &alloc)
+            : alloc(alloc) {
+
+                this->root = this->released = NULL;
+                this->nodes_in_tree = 0;
+            }
+
+        ~AVL_tree() {
+            this->free_subtree(this->root);
+            this->shrink_to_fit();
+        }
+
+        node_allocator get_allocator() {
+            return this->alloc;
+        }
+
+        // Returns the released nodes to the allocator so that it can reuse or trim them.
+        void shrink_to_fit() {
+
+            bt_node<K, V, M> *next_node;
+            while( this->released ) {
+                next_node = this->released->parent;
+                this->free_node(this->released);
+                this->released = next_node;
+            }
+        }
+
+        // Replaces the contents of the tree with the entries in [first, last),
+        // which must be sorted by strictly increasing key. Each entry is a pair of
+        // a key and a pointer to its value. Runs in O(n) with no rotations.
+        template <typename RandomIt>
+        void build_from_sorted(RandomIt first, RandomIt last) {
+
+            node_list old_nodes;
+            old_nodes.push_subtree(this->root);
+            this->finish_set_operation(NULL, old_nodes.length, old_nodes);
+
+            size_t n = last - first;
+            if( ! this->released ) reserve_blocks(this->alloc, n);
+            this->root = this->build_subtree(first, last, NULL);
+            this->nodes_in_tree = n;
+        }
+
+        // Adds every key of 'other' that is not already in this tree, leaving
+        // 'other' empty. Values of this tree win on duplicate keys.
+        // Subtrees are merged in parallel on 'pool' when one is given.
+        // A tree united or intersected with itself is unchanged.
+        void union_with(AVL_tree &other, thread_pool *pool = NULL) {
+
+            if( &other == this ) return;
+            size_t total_nodes = this->nodes_in_tree + other.nodes_in_tree;
+            bt_node<K, V, M> *other_root = this->adopt(other);
+            node_list discarded;
+            bt_node<K, V, M> *root = union_of(this->root, other_root, discarded, pool);
+            this->finish_set_operation(root, total_nodes, discarded);
+        }
+
+        // Keeps only the keys that are also in 'other', leaving 'other' empty.
+        void intersect_with(AVL_tree &other, thread_pool *pool = NULL) {
+
+            if( &other == this ) return;
+            size_t total_nodes = this->nodes_in_tree + other.nodes_in_tree;
+            bt_node<K, V, M> *other_root = this->adopt(other);
+            node_list discarded;
+            bt_node<K, V, M> *root = intersection_of(this->root, other_root, discarded, pool);
+            this->finish_set_operation(root, total_nodes, discarded);
+        }
+
+        // Removes every key that is in 'other', leaving 'other' empty. A tree
+        // subtracted from itself becomes empty.
+        void subtract(AVL_tree &other, thread_pool *pool = NULL) {
+
+            if( &other == this ) {
+                node_list old_nodes;
+                old_nodes.push_subtree(this->root);
+                this->finish_set_operation(NULL, old_nodes.length, old_nodes);
+                return;
+            }
+            size_t total_nodes = this->nodes_in_tree + other.nodes_in_tree;
+            bt_node<K, V, M> *other_root = this->adopt(other);
+            node_list discarded;
+            bt_node<K, V, M> *root = difference_of(this->root, other_root, discarded, pool);
+            this->finish_set_operation(root, total_nodes, discarded);
+        }
+
+        // Moves every key greater than 'key' into 'greater', which must be empty,
+        // and keeps the rest. 'greater' takes on this tree's allocator.
+        void split(const K key, AVL_tree &greater) {
+
+            if( greater.root ) exit(EXIT_FAILURE);
+            greater.shrink_to_fit();
+            greater.alloc = this->alloc;
+
+            bt_node<K, V, M> *left, *right;
+            bt_node<K, V, M> *match = split(this->root, key, left, right);
+            if( match ) left = join(left, match, NULL);
+
+            size_t n_greater = node_size(right);
+
+            this->root = left;
+            greater.root = right;
+            greater.nodes_in_tree = n_greater;
+            this->nodes_in_tree -= n_greater;
+        }
+
+        bt_node<K, V, M>* previous(bt_node<K, V, M> *node) {
+            return predecessor(node);
+        }
+
+        bt_node<K, V, M>* next(bt_node<K, V, M> *node) {
+            return successor(node);
+        }
+
+        void insert_previous(bt_node<K, V, M> *anchor_node, bt_node<K, V, M> *new_node) {
+
+            new_node->left = new_node->right = NULL;
+            update_node(new_node);
+            
+            if( ! anchor_node->left ) {
+                anchor_node->left = new_node;
+                new_node->parent = anchor_node;
+                this->balance_tree(anchor_node);
+                this->nodes_in_tree++;
+                return;
+            }
+
+            anchor_node = this->previous(anchor_node);
+            anchor_node->right = new_node;
+            new_node->parent = anchor_node;
+            this->balance_tree(anchor_node);
+            this->nodes_in_tree++;
+        }
+
+        void insert_next(bt_node<K, V, M> *anchor_node, bt_node<K, V, M> *new_node) {
+
+            new_node->left = new_node->right = NULL;
+            update_node(new_node);
+
+            if( ! anchor_node->right ) {
+                anchor_node->right = new_node;
+                new_node->parent = anchor_node;
+                this->balance_tree(anchor_node);
+                this->nodes_in_tree++;
+                return;
+            }
+
+            anchor_node = this->next(anchor_node);
+            anchor_node->left = new_node;
+            new_node->parent = anchor_node;
+            this->balance_tree(anchor_node);
+            this->nodes_in_tree++;
+        }
+
+        bt_node<K, V, M>* find(const K key) {
+
+            bt_node<K, V, M> *tmp_node = this->root;
+            while( tmp_node ) {
+                if( key < tmp_node->key ) tmp_node = tmp_node->left;
+                else if ( key > tmp_node->key ) tmp_node = tmp_node->right;
+                else return tmp_node;
+            }
+
+            return NULL;
+        } 
+
+        bt_node<K, V, M>* insert(const K key, V *value) {
+
+            bt_node<K, V, M> *new_node = this->get_node(), *tmp_node = this->root, *prev_node;
+            new_node->key = key; new_node->object = value;
+            new_node->left = new_node->right = NULL;
+            update_node(new_node);
+
+            if( ! this->root ) {
+                this->root = new_node;
+                new_node->parent = NULL;
+                this->nodes_in_tree++;
+                return new_node;
+            }
+
+            while( tmp_node ) {
+                prev_node = tmp_node;
+                if( key < tmp_node->key ) tmp_node = tmp_node->left;
+                else if( key > tmp_node->key ) tmp_node = tmp_node->right;
+                else return NULL;
+            }
+
+            if( key < prev_node->key ) prev_node->left = new_node;
+            else prev_node->right = new_node;
+            new_node->parent = prev_node;
+            this->balance_tree(prev_node);
+            this->nodes_in_tree++;
+            return new_node;
+        }
+
+        int remove(const K key) {
+            
+            bt_node<K, V, M> *node_to_remove, *tmp_node;
+            node_to_remove = this->find(key);
+            if( ! node_to_remove ) return 0;
+
+            while( node_to_remove->left || node_to_remove->right ) {
+                if( node_to_remove->left ) tmp_node = this->previous( node_to_remove );
+                else tmp_node = this->next( node_to_remove );
+                this->swap_node_contents(node_to_remove, tmp_node);
+                node_to_remove = tmp_node;
+            }
+
+            if( ! node_to_remove->parent ) this->root = NULL;
+            else {
+                if( node_to_remove == node_to_remove->parent->left ) node_to_remove->parent->left = NULL;
+                else node_to_remove->parent->right = NULL;
+                this->balance_tree(node_to_remove->parent);
+            }
+            this->delete_node(node_to_remove);
+            this->nodes_in_tree--;
+            return 1;
+        }
+
+        size_t height() {
+            if( this->root ) return this->root->height;
+            return 0UL;
+        }
+
+        size_t size() {
+            return this->nodes_in_tree;
+        }
+
+        bt_node<K, V, M>* get_root() {
+            return this->root;
+        }
+
+        // Returns the node with the k-th smallest key, counting from 0, or NULL
+        // if 'k' is not less than the size of the tree.
+        bt_node<K, V, M>* select(size_t k) {
+
+            bt_node<K, V, M> *tmp_node = this->root;
+            while( tmp_node ) {
+                size_t left_size = node_size(tmp_node->left);
+                if( k < left_size ) tmp_node = tmp_node->left;
+                else if( k > left_size ) {
+                    k -= left_size + 1;
+                    tmp_node = tmp_node->right;
+                }
+                else return tmp_node;
+            }
+
+            return NULL;
+        }
+
+        // Returns the number of keys less than 'key'.
+        size_t rank(const K key) {
+
+            size_t n_less = 0UL;
+            bt_node<K, V, M> *tmp_node = this->root;
+            while( tmp_node ) {
+                if( tmp_node->key < key ) {
+                    n_less += node_size(tmp_node->left) + 1;
+                    tmp_node = tmp_node->right;
+                }
+                else tmp_node = tmp_node->left;
+            }
+
+            return n_less;
+        }
+
+        // Returns the number of keys in [lo, hi).
+        size_t range_count(const K lo, const K hi) {
+
+            if( ! (lo < hi) ) return 0UL;
+            return this->rank(hi) - this->rank(lo);
+        }
+
+        // Combines the entries with keys in [lo, hi), in key order, with the
+        // tree's monoid. Only available when the tree has one.
+        template <typename M2 = M>
+        typename M2::value_type range_reduce(const K lo, const K hi) {
+
+            if( ! (lo < hi) ) return M2::identity();
+
+            // Find the highest node inside the range; every other node in the
+            // range is below it.
+            bt_node<K, V, M> *split_node = this->root;
+            while( split_node ) {
+                if( split_node->key < lo ) split_node = split_node->right;
+                else if( ! (split_node->key < hi) ) split_node = split_node->left;
+                else break;
+            }
+            if( ! split_node ) return M2::identity();
+
+            // Keys >= lo in the left subtree: take whole right subtrees on the way down.
+            typename M2::value_type left_part = M2::identity();
+            bt_node<K, V, M> *tmp_node = split_node->left;
+            while( tmp_node ) {
+                if( tmp_node->key < lo ) tmp_node = tmp_node->right;
+                else {
+                    left_part = M2::combine(M2::combine(M2::of(tmp_node->key, tmp_node->object),
+                        node_aggregate(tmp_node->right)), left_part);
+                    tmp_node = tmp_node->left;
+                }
+            }
+
+            // Keys < hi in the right subtree: take whole left subtrees on the way down.
+            typename M2::value_type right_part = M2::identity();
+            tmp_node = split_node->right;
+            while( tmp_node ) {
+                if( ! (tmp_node->key < hi) ) tmp_node = tmp_node->left;
+                else {
+                    right_part = M2::combine(right_part, M2::combine(node_aggregate(tmp_node->left),
+                        M2::of(tmp_node->key, tmp_node->object)));
+                    tmp_node = tmp_node->right;
+                }
+            }
+
+            return M2::combine(M2::combine(left_part, M2::of(split_node->key, split_node->object)), right_part);
+        }
+
+        // Aggregate of the whole tree.
+        template <typename M2 = M>
+        typename M2::value_type reduce() {
+            return node_aggregate(this->root);
+        }
+
+        // In-order iterator. Incrementing costs O(1) amortized, so a full scan is O(n).
+        class iterator {
+
+            bt_node<K, V, M> *current;
+
+            public:
+
+                iterator(bt_node<K, V, M> *node = NULL) : current(node) {}
+
+                const K& key() const { return this->current->key; }
+                V* value() const { return this->current->object; }
+                bt_node<K, V, M>* get_node() const { return this->current; }
+
+                iterator& operator++() {
+                    this->current = successor(this->current);
+                    return *this;
+                }
+
+                bool operator==(const iterator &other) const { return this->current == other.current; }
+                bool operator!=(const iterator &other) const { return this->current != other.current; }
+        };
+
+        iterator begin() {
+            if( ! this->root ) return iterator();
+            return iterator(this->leftmost_node(this->root));
+        }
+
+        iterator end() {
+            return iterator();
+        }
+
+        // Returns an iterator to the first key not less than 'key'.
+        iterator lower_bound(const K key) {
+
+            bt_node<K, V, M> *tmp_node = this->root, *candidate = NULL;
+            while( tmp_node ) {
+                if( tmp_node->key < key ) tmp_node = tmp_node->right;
+                else {
+                    candidate = tmp_node;
+                    tmp_node = tmp_node->left;
+                }
+            }
+
+            return iterator(candidate);
+        }
+
+        void print() {
+
+            if( ! this->root ) return;
+
+            std::cout << "Size: " << this->size() << " ";
+            std::cout << "Height: " << this->height() << " ";
+            std::cout << "Skew: " << this->skew(this->root) << "\n";
+
+            bt_node<K, V, M> *tmp_node = this->leftmost_node(this->root);
+            while( tmp_node ) {
+                std::cout << *( tmp_node->object ) << " ";
+                tmp_node = this->next(tmp_node);
+            }
+            std::cout << std::endl;
+        }
+
+};
+
+#endif /* AVL_TREE_H */
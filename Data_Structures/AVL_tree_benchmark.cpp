@@ -0,0 +1,203 @@
+#include "AVL_tree.h"
+#include <chrono>
+#include <new>
+#include <vector>
+
+// Every call to the global allocation functions is counted, so that the
+// churn loop can show that recycling released nodes never reaches the heap.
+static size_t n_news = 0, n_deletes = 0;
+
+__attribute__((noinline)) void* operator new(size_t bytes) {
+    n_news++;
+    void *p = malloc(bytes ? bytes : 1);
+    if ( ! p ) throw std::bad_alloc();
+    return p;
+}
+
+__attribute__((noinline)) void operator delete(void *p) noexcept {
+    if (p) n_deletes++;
+    free(p);
+}
+
+__attribute__((noinline)) void operator delete(void *p, size_t) noexcept {
+    if (p) n_deletes++;
+    free(p);
+}
+
+// Counts the calls the tree makes to its node allocator.
+template <typename T>
+class counting_allocator : public slab_allocator<T>
+{
+    public:
+
+        static size_t n_allocate, n_deallocate;
+
+        counting_allocator(size_t alloc_size, unsigned alloc_exp) : slab_allocator<T>(alloc_size, alloc_exp) {}
+
+        template <typename U>
+        counting_allocator(const counting_allocator<U> &other) : slab_allocator<T>(other) {}
+
+        template <typename U>
+        struct rebind { typedef counting_allocator<U> other; };
+
+        T* allocate(size_t n) { n_allocate++; return slab_allocator<T>::allocate(n); }
+        void deallocate(T *p, size_t n) { n_deallocate++; slab_allocator<T>::deallocate(p, n); }
+};
+
+template <typename T> size_t counting_allocator<T>::n_allocate = 0;
+template <typename T> size_t counting_allocator<T>::n_deallocate = 0;
+
+// Returns the time in seconds taken by 'f'.
+template <typename F>
+double seconds(F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Compares building a tree from sorted keys with repeated insert, and the
+// join-based set operations with the equivalent insert/remove loops.
+void bulk_and_set_operations() {
+
+    typedef AVL_tree<int, double> tree;
+    typedef slab_allocator< bt_node<int, double> > allocator;
+    const int n = 1000000;
+    double value = 1.0;
+
+    // Even keys for 'a', multiples of 3 for 'b'.
+    std::vector< std::pair<int, double*> > a_entries, b_entries;
+    for (int i = 0; i < n; i++) {
+        a_entries.push_back(std::make_pair(2 * i, &value));
+        b_entries.push_back(std::make_pair(3 * i, &value));
+    }
+
+    std::cout << "Build from " << n << " sorted keys:" << std::endl;
+    {
+        tree inserted, built;
+        double insert_s = seconds([&]() { for (const auto &entry : a_entries) inserted.insert(entry.first, entry.second); });
+        double build_s = seconds([&]() { built.build_from_sorted(a_entries.begin(), a_entries.end()); });
+        std::cout << "  repeated insert " << insert_s * 1e3 << " ms, build_from_sorted " << build_s * 1e3
+                  << " ms (heights " << inserted.height() << " and " << built.height() << ")" << std::endl;
+    }
+
+    thread_pool pool;
+    std::cout << "Set operations on two trees of " << n << " keys (insert loop / join-based / join-based on "
+              << pool.size() << " threads), ms:" << std::endl;
+
+    const char *names[] = {"union", "intersection", "difference"};
+    for (int op = 0; op < 3; op++) {
+        double times[3];
+        for (int mode = 0; mode < 3; mode++) {
+            allocator shared(1024, 2);
+            tree a(shared), b(shared);
+            a.build_from_sorted(a_entries.begin(), a_entries.end());
+            b.build_from_sorted(b_entries.begin(), b_entries.end());
+            thread_pool *p = mode == 2 ? &pool : NULL;
+
+            times[mode] = seconds([&]() {
+                if (mode == 0) {
+                    if (op == 0) for (const auto &entry : b_entries) a.insert(entry.first, entry.second);
+                    if (op == 1) for (const auto &entry : a_entries) { if ( ! b.find(entry.first) ) a.remove(entry.first); }
+                    if (op == 2) for (const auto &entry : b_entries) a.remove(entry.first);
+                } else {
+                    if (op == 0) a.union_with(b, p);
+                    if (op == 1) a.intersect_with(b, p);
+                    if (op == 2) a.subtract(b, p);
+                }
+            });
+        }
+        std::cout << "  " << names[op] << ": " << times[0] * 1e3 << " / " << times[1] * 1e3 << " / " << times[2] * 1e3 << std::endl;
+    }
+}
+
+// Compares an in-order scan with the iterator against indexing every key with
+// select, and the O(log n) range queries against walking the range.
+void order_statistics() {
+
+    typedef sum_of_values<int, long> sum;
+    typedef AVL_tree<int, long, slab_allocator< bt_node<int, long, sum> >, sum> tree;
+    const int n = 1000000, n_queries = 10000;
+
+    std::vector<long> values(n);
+    std::vector< std::pair<int, long*> > entries;
+    for (int i = 0; i < n; i++) {
+        values[i] = i % 100;
+        entries.push_back(std::make_pair(2 * i, &values[i]));
+    }
+    tree t;
+    t.build_from_sorted(entries.begin(), entries.end());
+
+    long iterator_sum = 0, select_sum = 0;
+    double iterator_s = seconds([&]() { for (tree::iterator it = t.begin(); it != t.end(); ++it) iterator_sum += *it.value(); });
+    double select_s = seconds([&]() { for (size_t k = 0; k < t.size(); k++) select_sum += *t.select(k)->object; });
+    std::cout << "In-order scan of " << n << " keys: iterator " << iterator_s * 1e3 << " ms, select(k) "
+              << select_s * 1e3 << " ms (sums " << iterator_sum << ", " << select_sum << ")" << std::endl;
+
+    // Ranges of up to n / 100 keys.
+    std::vector<int> lows(n_queries), highs(n_queries);
+    for (int i = 0; i < n_queries; i++) {
+        lows[i] = (int)((i * 7919UL) % (2UL * n));
+        highs[i] = lows[i] + (int)((i * 104729UL) % (n / 50));
+    }
+
+    long walk_sum = 0, reduce_sum = 0;
+    size_t walk_count = 0, query_count = 0;
+    double walk_s = seconds([&]() {
+        for (int i = 0; i < n_queries; i++) {
+            for (tree::iterator it = t.lower_bound(lows[i]); it != t.end() && it.key() < highs[i]; ++it) {
+                walk_count++;
+                walk_sum += *it.value();
+            }
+        }
+    });
+    double query_s = seconds([&]() {
+        for (int i = 0; i < n_queries; i++) {
+            query_count += t.range_count(lows[i], highs[i]);
+            reduce_sum += t.range_reduce(lows[i], highs[i]);
+        }
+    });
+    std::cout << n_queries << " range count and sum queries: walking the range " << walk_s * 1e3
+              << " ms, range_count + range_reduce " << query_s * 1e3 << " ms (counts " << walk_count << ", "
+              << query_count << ", sums " << walk_sum << ", " << reduce_sum << ")" << std::endl;
+}
+
+int main() {
+
+    typedef bt_node<int, double> node;
+    typedef counting_allocator<node> allocator;
+
+    const int n_keys = 100000;
+    const size_t n_cycles = 2000000UL;
+    double value = 1.0;
+
+    AVL_tree<int, double, allocator> tree( (allocator(10, 2)) );
+    for (int i = 0; i < n_keys; i++) tree.insert(i, &value);
+
+    // Keys are removed and inserted again in a scrambled order.
+    std::vector<int> keys(n_cycles);
+    for (size_t i = 0; i < n_cycles; i++) keys[i] = (int)((i * 7919UL) % n_keys);
+
+    // Warm-up: the first cycle fills the released list.
+    tree.remove(keys[0]); tree.insert(keys[0], &value);
+
+    size_t news = n_news, deletes = n_deletes;
+    size_t allocs = allocator::n_allocate, deallocs = allocator::n_deallocate;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n_cycles; i++) {
+        tree.remove(keys[i]);
+        tree.insert(keys[i], &value);
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Remove/insert churn on " << n_keys << " keys, " << n_cycles << " cycles:" << std::endl;
+    std::cout << "  " << n_cycles / elapsed / 1e6 << " M cycles/s" << std::endl;
+    std::cout << "  node allocator calls: " << allocator::n_allocate - allocs << " allocate, "
+              << allocator::n_deallocate - deallocs << " deallocate" << std::endl;
+    std::cout << "  global operator new/delete calls: " << n_news - news << " new, "
+              << n_deletes - deletes << " delete" << std::endl;
+    std::cout << "  tree size " << tree.size() << ", height " << tree.height() << std::endl;
+
+    bulk_and_set_operations();
+    order_statistics();
+}
@@ -0,0 +1,72 @@
+#include "BP_tree.h"
+#include <map>
+#include <random>
+#include <string>
+
+// Applies the same random inserts and removes to a BP_tree and a std::map and
+// checks after each phase that lookups and in-order iteration agree.
+template <typename K, unsigned N, typename MakeKey>
+bool check_against_map(MakeKey make_key, int n_ops, int key_range) {
+
+    BP_tree<K, int, N> tree;
+    std::map<K, int*> reference;
+    static int values[100000];
+    std::mt19937 rng(9999);
+
+    for (int phase = 0; phase < 4; phase++) {
+        for (int op = 0; op < n_ops; op++) {
+            int k = rng() % key_range;
+            K key = make_key(k);
+            // Bias towards inserting in even phases and removing in odd ones.
+            if (rng() % 4 != (unsigned)(phase % 2) * 3) {
+                int inserted = tree.insert(key, &values[k]);
+                if (inserted != (int)reference.emplace(key, &values[k]).second) return false;
+            } else {
+                if (tree.remove(key) != (int)reference.erase(key)) return false;
+            }
+        }
+
+        if (tree.size() != reference.size()) return false;
+        auto it = tree.begin();
+        for (const auto &entry : reference) {
+            if (it == tree.end() || it.key() != entry.first || it.value() != entry.second) return false;
+            ++it;
+        }
+        if (it != tree.end()) return false;
+        for (int k = 0; k < key_range; k++) {
+            auto entry = reference.find(make_key(k));
+            if (tree.find(make_key(k)) != (entry == reference.end() ? NULL : entry->second)) return false;
+        }
+    }
+
+    // Empty the tree completely.
+    for (const auto &entry : reference) {
+        if ( ! tree.remove(entry.first) ) return false;
+    }
+    return tree.size() == 0 && tree.begin() == tree.end();
+}
+
+// For testing.
+int main() {
+
+    BP_tree<int, double, 4> my_tree;
+
+    double one=1.1, two=2.2, three=3.3, four=4.4, five=5.5, six=6.6, seven=7.7;
+    my_tree.insert(1, &one);
+    my_tree.insert(2, &two);
+    my_tree.insert(3, &three);
+    my_tree.insert(5, &five);
+    my_tree.insert(6, &six);
+    my_tree.insert(4, &four);
+    my_tree.insert(7, &seven);
+    my_tree.remove(5);
+
+    my_tree.print();
+    std::cout << "Lower bound of 5: " << my_tree.lower_bound(5).key() << std::endl;
+
+    auto int_key = [](int k) { return k; };
+    auto string_key = [](int k) { return "key" + std::to_string(k); };
+    std::cout << "int keys, 4 per node: " << (check_against_map<int, 4>(int_key, 20000, 5000) ? "passed" : "FAILED") << std::endl;
+    std::cout << "int keys, default node: " << (check_against_map<int, bp_default_fanout<int>()>(int_key, 50000, 20000) ? "passed" : "FAILED") << std::endl;
+    std::cout << "string keys, 6 per node: " << (check_against_map<std::string, 6>(string_key, 20000, 5000) ? "passed" : "FAILED") << std::endl;
+}
@@ -0,0 +1,444 @@
+#ifndef BP_TREE_H
+#define BP_TREE_H
+
+#include "slab_allocator.h"
+#include <iostream>
+#include <algorithm>
+#include <memory>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+// Bytes per node, a whole number of cache lines. Nodes start on a cache line
+// with their keys, so that a lookup touches one short, contiguous run of memory
+// per level, and fit one of the cache-line size classes of slab_arena.
+#define BP_CACHE_LINE 64
+#define BP_NODE_BYTES 768
+
+// Default number of keys per node for keys of type K: as many as fit in
+// BP_NODE_BYTES along with a pointer per key, the extra child, the leaf link
+// and the count, rounded to an even number between 4 and 64.
+template <typename K>
+constexpr unsigned bp_default_fanout() {
+    return std::max(4U, std::min(64U, (unsigned)((BP_NODE_BYTES - 3 * sizeof(void*)) / (sizeof(K) + sizeof(void*))) & ~1U));
+}
+
+// Node of a B+ tree. Leaves hold up to N keys with their objects and are
+// chained in key order; inner nodes hold up to N separator keys and N + 1
+// children, where children[i] holds the keys below keys[i] and
+// children[i + 1] the keys at or above it.
+template <typename K, typename V, unsigned N>
+struct alignas(BP_CACHE_LINE) bp_node {
+    K keys[N];
+    union {
+        V *objects[N];
+        bp_node<K, V, N> *children[N + 1];
+    };
+    bp_node<K, V, N> *next;
+    unsigned count;
+    bool leaf;
+};
+
+// Number of keys in keys[0, n) that are less than 'key'.
+template <typename K>
+unsigned bp_count_less(const K *keys, unsigned n, const K &key) {
+    return std::lower_bound(keys, keys + n, key) - keys;
+}
+
+// Number of keys in keys[0, n) that are less than or equal to 'key'.
+template <typename K>
+unsigned bp_count_not_greater(const K *keys, unsigned n, const K &key) {
+    return std::upper_bound(keys, keys + n, key) - keys;
+}
+
+#ifdef __AVX2__
+// int keys are compared 8 at a time. Counting every key below 'key' is
+// branch-free and, for node sizes of a few cache lines, beats a binary search.
+inline unsigned bp_count_less(const int *keys, unsigned n, const int &key) {
+
+    __m256i needle = _mm256_set1_epi32(key);
+    unsigned i = 0, count = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(keys + i));
+        __m256i less = _mm256_cmpgt_epi32(needle, block);
+        count += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(less)));
+    }
+    for (; i < n; i++) count += keys[i] < key;
+    return count;
+}
+
+inline unsigned bp_count_not_greater(const int *keys, unsigned n, const int &key) {
+
+    __m256i needle = _mm256_set1_epi32(key);
+    unsigned i = 0, count = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(keys + i));
+        __m256i greater = _mm256_cmpgt_epi32(block, needle);
+        count += 8 - __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(greater)));
+    }
+    for (; i < n; i++) count += keys[i] <= key;
+    return count;
+}
+#endif
+
+// Ordered map from keys to pointers to values, stored as a B+ tree. It offers
+// the same find/insert/remove semantics as AVL_tree, with ordered iteration
+// along the chain of leaves.
+template <typename K, typename V, unsigned N = bp_default_fanout<K>(), typename Alloc = slab_allocator<K> >
+class BP_tree {
+
+    static_assert(N >= 4 && N % 2 == 0, "BP_tree nodes need an even number of at least 4 keys");
+
+    public:
+
+        typedef bp_node<K, V, N> node;
+
+        // Position of one key in the chain of leaves.
+        class iterator {
+
+            friend class BP_tree;
+
+            node *leaf; unsigned index;
+
+            iterator(node *leaf, unsigned index) : leaf(leaf), index(index) {
+                // Step over the end of a leaf onto the next one.
+                if( this->leaf && this->index == this->leaf->count ) {
+                    this->leaf = this->leaf->next;
+                    this->index = 0;
+                }
+            }
+
+            public:
+
+                const K& key() const { return this->leaf->keys[this->index]; }
+                V* value() const { return this->leaf->objects[this->index]; }
+
+                iterator& operator++() {
+                    if( ++this->index == this->leaf->count ) {
+                        this->leaf = this->leaf->next;
+                        this->index = 0;
+                    }
+                    return *this;
+                }
+
+                bool operator==(const iterator &other) const {
+                    return this->leaf == other.leaf && this->index == other.index;
+                }
+
+                bool operator!=(const iterator &other) const {
+                    return ! (*this == other);
+                }
+        };
+
+    private:
+
+        typedef typename std::allocator_traits<Alloc>::template rebind_alloc<node> node_allocator;
+        typedef std::allocator_traits<node_allocator> node_traits;
+
+        static const unsigned MIN_KEYS = N / 2;
+
+        node_allocator alloc;
+        node *root;
+        size_t nodes_in_tree, levels;
+
+        BP_tree(const BP_tree&);
+        BP_tree& operator=(const BP_tree&);
+
+        node* get_node(bool leaf) {
+
+            node *new_node = node_traits::allocate(this->alloc, 1);
+            node_traits::construct(this->alloc, new_node);
+            new_node->count = 0;
+            new_node->leaf = leaf;
+            new_node->next = NULL;
+            return new_node;
+        }
+
+        void free_node(node *old_node) {
+            node_traits::destroy(this->alloc, old_node);
+            node_traits::deallocate(this->alloc, old_node, 1);
+        }
+
+        void free_subtree(node *root) {
+
+            if( ! root->leaf ) {
+                for( unsigned i = 0; i <= root->count; i++ ) this->free_subtree(root->children[i]);
+            }
+            this->free_node(root);
+        }
+
+        // Inserts 'key' below 'current'. If 'current' splits, its upper half is
+        // returned through 'right' along with the separator key to add to the parent.
+        int insert_into(node *current, const K &key, V *value, K &separator, node *&right) {
+
+            right = NULL;
+
+            if( current->leaf ) {
+                unsigned i = bp_count_less(current->keys, current->count, key);
+                if( i < current->count && ! (key < current->keys[i]) ) return 0;
+
+                if( current->count == N ) {
+                    // Split, keeping the lower half in 'current'.
+                    right = this->get_node(true);
+                    unsigned half = (N + 1) / 2;
+                    right->count = N - half;
+                    std::move(current->keys + half, current->keys + N, right->keys);
+                    std::copy(current->objects + half, current->objects + N, right->objects);
+                    current->count = half;
+                    right->next = current->next;
+                    current->next = right;
+                    if( i > half ) { current = right; i -= half; }
+                }
+
+                std::move_backward(current->keys + i, current->keys + current->count, current->keys + current->count + 1);
+                std::copy_backward(current->objects + i, current->objects + current->count, current->objects + current->count + 1);
+                current->keys[i] = key;
+                current->objects[i] = value;
+                current->count++;
+                if( right ) separator = right->keys[0];
+                return 1;
+            }
+
+            unsigned c = bp_count_not_greater(current->keys, current->count, key);
+            K child_separator; node *child_right;
+            if( ! this->insert_into(current->children[c], key, value, child_separator, child_right) ) return 0;
+            if( ! child_right ) return 1;
+
+            if( current->count < N ) {
+                std::move_backward(current->keys + c, current->keys + current->count, current->keys + current->count + 1);
+                std::copy_backward(current->children + c + 1, current->children + current->count + 1, current->children + current->count + 2);
+                current->keys[c] = child_separator;
+                current->children[c + 1] = child_right;
+                current->count++;
+                return 1;
+            }
+
+            // The node is full: lay out all N + 1 keys and N + 2 children, then
+            // keep the lower half, promote the middle key and move the rest right.
+            K keys[N + 1]; node *children[N + 2];
+            std::move(current->keys, current->keys + c, keys);
+            keys[c] = child_separator;
+            std::move(current->keys + c, current->keys + N, keys + c + 1);
+            std::copy(current->children, current->children + c + 1, children);
+            children[c + 1] = child_right;
+            std::copy(current->children + c + 1, current->children + N + 1, children + c + 2);
+
+            unsigned half = (N + 1) / 2;
+            right = this->get_node(false);
+            current->count = half;
+            right->count = N - half;
+            std::move(keys, keys + half, current->keys);
+            std::copy(children, children + half + 1, current->children);
+            separator = keys[half];
+            std::move(keys + half + 1, keys + N + 1, right->keys);
+            std::copy(children + half + 1, children + N + 2, right->children);
+            return 1;
+        }
+
+        // Restores the minimum occupancy of parent->children[c] by borrowing
+        // from a sibling or merging with one.
+        void fix_child(node *parent, unsigned c) {
+
+            node *child = parent->children[c];
+            node *left = c > 0 ? parent->children[c - 1] : NULL;
+            node *right = c < parent->count ? parent->children[c + 1] : NULL;
+
+            if( left && left->count > MIN_KEYS ) {
+                std::move_backward(child->keys, child->keys + child->count, child->keys + child->count + 1);
+                if( child->leaf ) {
+                    std::copy_backward(child->objects, child->objects + child->count, child->objects + child->count + 1);
+                    child->keys[0] = left->keys[left->count - 1];
+                    child->objects[0] = left->objects[left->count - 1];
+                    parent->keys[c - 1] = child->keys[0];
+                } else {
+                    std::copy_backward(child->children, child->children + child->count + 1, child->children + child->count + 2);
+                    child->keys[0] = parent->keys[c - 1];
+                    child->children[0] = left->children[left->count];
+                    parent->keys[c - 1] = left->keys[left->count - 1];
+                }
+                child->count++;
+                left->count--;
+                return;
+            }
+
+            if( right && right->count > MIN_KEYS ) {
+                if( child->leaf ) {
+                    child->keys[child->count] = right->keys[0];
+                    child->objects[child->count] = right->objects[0];
+                    std::move(right->keys + 1, right->keys + right->count, right->keys);
+                    std::copy(right->objects + 1, right->objects + right->count, right->objects);
+                    parent->keys[c] = right->keys[0];
+                } else {
+                    child->keys[child->count] = parent->keys[c];
+                    child->children[child->count + 1] = right->children[0];
+                    parent->keys[c] = right->keys[0];
+                    std::move(right->keys + 1, right->keys + right->count, right->keys);
+                    std::copy(right->children + 1, right->children + right->count + 1, right->children);
+                }
+                child->count++;
+                right->count--;
+                return;
+            }
+
+            // Neither sibling can spare a key: merge the pair (c - 1, c) or (c, c + 1).
+            if( ! right ) { right = child; child = left; c--; }
+            if( child->leaf ) {
+                std::move(right->keys, right->keys + right->count, child->keys + child->count);
+                std::copy(right->objects, right->objects + right->count, child->objects + child->count);
+                child->count += right->count;
+                child->next = right->next;
+            } else {
+                child->keys[child->count] = parent->keys[c];
+                std::move(right->keys, right->keys + right->count, child->keys + child->count + 1);
+                std::copy(right->children, right->children + right->count + 1, child->children + child->count + 1);
+                child->count += right->count + 1;
+            }
+            std::move(parent->keys + c + 1, parent->keys + parent->count, parent->keys + c);
+            std::copy(parent->children + c + 2, parent->children + parent->count + 1, parent->children + c + 1);
+            parent->count--;
+            this->free_node(right);
+        }
+
+        int remove_from(node *current, const K &key) {
+
+            if( current->leaf ) {
+                unsigned i = bp_count_less(current->keys, current->count, key);
+                if( i == current->count || key < current->keys[i] ) return 0;
+                std::move(current->keys + i + 1, current->keys + current->count, current->keys + i);
+                std::copy(current->objects + i + 1, current->objects + current->count, current->objects + i);
+                current->count--;
+                return 1;
+            }
+
+            unsigned c = bp_count_not_greater(current->keys, current->count, key);
+            if( ! this->remove_from(current->children[c], key) ) return 0;
+            if( current->children[c]->count < MIN_KEYS ) this->fix_child(current, c);
+            return 1;
+        }
+
+        node* find_leaf(const K &key) {
+
+            node *current = this->root;
+            while( ! current->leaf ) {
+                current = current->children[ bp_count_not_greater(current->keys, current->count, key) ];
+            }
+            return current;
+        }
+
+    public:
+
+        // Nodes come from a private arena whose blocks start at 'alloc_size'
+        // nodes and grow by a factor of 'alloc_exp'.
+        BP_tree(size_t alloc_size = 10, unsigned alloc_exp = 2)
+            : alloc(alloc_size, alloc_exp) {
+
+                this->root = NULL;
+                this->nodes_in_tree = this->levels = 0;
+            }
+
+        // Nodes come from 'alloc', which may be shared with other containers.
+        explicit BP_tree(const Alloc &alloc)
+            : alloc(alloc) {
+
+                this->root = NULL;
+                this->nodes_in_tree = this->levels = 0;
+            }
+
+        ~BP_tree() {
+            if( this->root ) this->free_subtree(this->root);
+        }
+
+        // Returns the object stored under 'key', or NULL if there is none.
+        V* find(const K &key) {
+
+            if( ! this->root ) return NULL;
+            node *leaf = this->find_leaf(key);
+            unsigned i = bp_count_less(leaf->keys, leaf->count, key);
+            if( i == leaf->count || key < leaf->keys[i] ) return NULL;
+            return leaf->objects[i];
+        }
+
+        // Stores 'value' under 'key'. Returns 0 if the key is already present.
+        int insert(const K &key, V *value) {
+
+            if( ! this->root ) {
+                this->root = this->get_node(true);
+                this->levels = 1;
+            }
+
+            K separator; node *right;
+            if( ! this->insert_into(this->root, key, value, separator, right) ) return 0;
+            if( right ) {
+                node *new_root = this->get_node(false);
+                new_root->count = 1;
+                new_root->keys[0] = separator;
+                new_root->children[0] = this->root;
+                new_root->children[1] = right;
+                this->root = new_root;
+                this->levels++;
+            }
+            this->nodes_in_tree++;
+            return 1;
+        }
+
+        // Removes 'key' from the tree. Returns 0 if the key is not present.
+        int remove(const K &key) {
+
+            if( ! this->root || ! this->remove_from(this->root, key) ) return 0;
+
+            if( ! this->root->count ) {
+                node *old_root = this->root;
+                this->root = old_root->leaf ? NULL : old_root->children[0];
+                this->free_node(old_root);
+                this->levels--;
+            }
+            this->nodes_in_tree--;
+            return 1;
+        }
+
+        // Returns an iterator to the smallest key.
+        iterator begin() {
+
+            node *current = this->root;
+            while( current && ! current->leaf ) current = current->children[0];
+            return iterator(current, 0);
+        }
+
+        iterator end() {
+            return iterator(NULL, 0);
+        }
+
+        // Returns an iterator to the smallest key not less than 'key'.
+        iterator lower_bound(const K &key) {
+
+            if( ! this->root ) return this->end();
+            node *leaf = this->find_leaf(key);
+            return iterator(leaf, bp_count_less(leaf->keys, leaf->count, key));
+        }
+
+        size_t height() {
+            return this->levels;
+        }
+
+        size_t size() {
+            return this->nodes_in_tree;
+        }
+
+        node_allocator get_allocator() {
+            return this->alloc;
+        }
+
+        void print() {
+
+            std::cout << "Size: " << this->size() << " ";
+            std::cout << "Height: " << this->height() << "\n";
+
+            for( iterator it = this->begin(); it != this->end(); ++it ) {
+                std::cout << *( it.value() ) << " ";
+            }
+            std::cout << std::endl;
+        }
+
+};
+
+#endif /* BP_TREE_H */
@@ -0,0 +1,85 @@
+#include "AVL_tree.h"
+#include "BP_tree.h"
+#include <chrono>
+#include <random>
+#include <vector>
+
+// Keys visited by each range scan.
+const size_t SCAN_LENGTH = 100UL;
+
+// Returns the time in seconds taken by 'f'.
+template <typename F>
+double seconds(F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct results {
+    double insert, lookup, scan;
+};
+
+// In-order scan of 'SCAN_LENGTH' keys starting at 'start'.
+long scan(AVL_tree<int, int> &tree, int start) {
+    long sum = 0L;
+    bt_node<int, int> *node = tree.find(start);
+    for (size_t i = 0; node && i < SCAN_LENGTH; i++, node = tree.next(node)) sum += node->key;
+    return sum;
+}
+
+long scan(BP_tree<int, int> &tree, int start) {
+    long sum = 0L;
+    auto it = tree.lower_bound(start);
+    for (size_t i = 0; it != tree.end() && i < SCAN_LENGTH; i++, ++it) sum += it.key();
+    return sum;
+}
+
+int* lookup(AVL_tree<int, int> &tree, int key) {
+    bt_node<int, int> *node = tree.find(key);
+    return node ? node->object : NULL;
+}
+
+int* lookup(BP_tree<int, int> &tree, int key) {
+    return tree.find(key);
+}
+
+// Inserts 'keys' in order, looks every key up in a different order, and runs
+// range scans from random starting keys. Rates are in millions of operations
+// (or scanned keys) per second.
+template <typename Tree>
+results run(const std::vector<int> &keys, const std::vector<int> &probes, long &checksum) {
+
+    Tree tree;
+    static int value = 1;
+    results r;
+    const size_t n = keys.size();
+    const size_t n_scans = std::min<size_t>(n, 100000UL);
+
+    r.insert = n / seconds([&]() { for (size_t i = 0; i < n; i++) tree.insert(keys[i], &value); }) / 1e6;
+    r.lookup = n / seconds([&]() { for (size_t i = 0; i < n; i++) checksum += *lookup(tree, probes[i]); }) / 1e6;
+    r.scan = n_scans * SCAN_LENGTH / seconds([&]() { for (size_t i = 0; i < n_scans; i++) checksum += scan(tree, probes[i]); }) / 1e6;
+    return r;
+}
+
+// Usage: BP_tree_benchmark [max_exponent], running 10^3 up to 10^max_exponent keys (default 6).
+int main(int argc, char **argv) {
+
+    int max_exponent = argc > 1 ? atoi(argv[1]) : 6;
+    std::mt19937 rng(9999);
+    long checksum = 0L;
+
+    std::cout << "keys        tree      insert   lookup   scan  (M ops/s, scan in M keys/s)" << std::endl;
+    size_t n = 1000UL;
+    for (int e = 3; e <= max_exponent; e++, n *= 10) {
+        std::vector<int> keys(n), probes(n);
+        for (size_t i = 0; i < n; i++) keys[i] = probes[i] = (int)i;
+        std::shuffle(keys.begin(), keys.end(), rng);
+        std::shuffle(probes.begin(), probes.end(), rng);
+
+        results avl = run< AVL_tree<int, int> >(keys, probes, checksum);
+        results bp = run< BP_tree<int, int> >(keys, probes, checksum);
+        std::cout << "1e" << e << "        AVL_tree  " << avl.insert << "  " << avl.lookup << "  " << avl.scan << std::endl;
+        std::cout << "1e" << e << "        BP_tree   " << bp.insert << "  " << bp.lookup << "  " << bp.scan << std::endl;
+    }
+    std::cout << "(checksum " << checksum << ")" << std::endl;
+}
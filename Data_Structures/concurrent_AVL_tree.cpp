@@ -0,0 +1,83 @@
+#include "concurrent_AVL_tree.h"
+#include <iostream>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+// Random inserts and removes on one thread, compared with std::set.
+bool check_sequential() {
+
+    concurrent_AVL_tree<int, int> tree;
+    std::set<int> expected;
+    std::vector<int> values(1000);
+    std::mt19937 rng(9999);
+
+    for (int round = 0; round < 100000; round++) {
+        int key = rng() % 1000;
+        if (rng() % 2) {
+            if (tree.insert(key, &values[key]) != (int)expected.insert(key).second) return false;
+        } else {
+            if (tree.remove(key) != (int)expected.erase(key)) return false;
+        }
+    }
+
+    std::vector<int> keys;
+    tree.for_each([&keys](int key, int*) { keys.push_back(key); });
+    if (keys.size() != expected.size() || tree.size() != expected.size()) return false;
+    if ( ! std::equal(keys.begin(), keys.end(), expected.begin()) ) return false;
+    for (int key = 0; key < 1000; key++) {
+        if (tree.find(key) != (expected.count(key) ? &values[key] : NULL)) return false;
+    }
+    // A tree of n keys is at most about 1.44 log2(n) high.
+    return tree.height() <= 15;
+}
+
+// Readers look up the even keys, which are never removed, while a writer keeps
+// inserting and removing the odd keys. Every even key must always be found
+// with its own value, and an odd key must never map to another key's value.
+bool stress_readers(unsigned n_readers) {
+
+    const int n_keys = 10000;
+    concurrent_AVL_tree<int, int> tree;
+    std::vector<int> values(n_keys);
+    for (int key = 0; key < n_keys; key++) {
+        values[key] = key;
+        if (key % 2 == 0) tree.insert(key, &values[key]);
+    }
+
+    std::atomic<bool> stop(false), ok(true);
+    std::vector<std::thread> readers;
+    for (unsigned r = 0; r < n_readers; r++) {
+        readers.emplace_back([&, r]() {
+            std::mt19937 rng(r);
+            while ( ! stop.load(std::memory_order_relaxed) ) {
+                int key = rng() % n_keys;
+                int *value = tree.find(key);
+                if (key % 2 == 0 && ( ! value || *value != key )) ok = false;
+                if (key % 2 == 1 && value && *value != key) ok = false;
+            }
+        });
+    }
+
+    std::mt19937 rng(9999);
+    for (int round = 0; round < 200000; round++) {
+        int key = 2 * (rng() % (n_keys / 2)) + 1;
+        if (rng() % 2) tree.insert(key, &values[key]);
+        else tree.remove(key);
+    }
+    stop = true;
+    for (auto &reader : readers) reader.join();
+
+    size_t n_even = 0;
+    tree.for_each([&n_even](int key, int*) { if (key % 2 == 0) n_even++; });
+    return ok && n_even == n_keys / 2;
+}
+
+// For testing.
+int main() {
+
+    std::cout << "Sequential: " << (check_sequential() ? "passed" : "FAILED") << std::endl;
+    std::cout << "1 reader, 1 writer: " << (stress_readers(1) ? "passed" : "FAILED") << std::endl;
+    std::cout << "4 readers, 1 writer: " << (stress_readers(4) ? "passed" : "FAILED") << std::endl;
+}
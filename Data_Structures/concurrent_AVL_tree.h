@@ -0,0 +1,439 @@
+#ifndef CONCURRENT_AVL_TREE_H
+#define CONCURRENT_AVL_TREE_H
+
+#include "slab_allocator.h"
+#include "concurrent_queue.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+// Number of readers that can be inside a concurrent_AVL_tree at the same
+// time. Further readers spin until a slot frees up.
+#define AVL_READER_SLOTS 128
+
+// Node of a concurrent_AVL_tree. A node is never modified once it is reachable
+// from the root: writers copy the path they change instead. 'version' is the
+// epoch in which the node was created, or in which it was retired once it has
+// been unlinked. 'next' links retired and released nodes.
+template <typename K, typename V>
+struct cow_node {
+    cow_node<K, V> *left, *right, *next;
+    size_t height, version;
+    K key;
+    V *object;
+};
+
+// AVL tree whose lookups take no locks. Writers are serialised by a mutex and
+// publish each change by swapping in a new root, copying only the nodes on the
+// changed path. Readers announce the epoch they started in, and replaced nodes
+// go back on the released list only once no reader can still be looking at
+// them, so they are recycled the same way as in AVL_tree.
+template <typename K, typename V, typename Alloc = slab_allocator< cow_node<K, V> > >
+class concurrent_AVL_tree {
+
+    private:
+
+        typedef typename std::allocator_traits<Alloc>::template rebind_alloc< cow_node<K, V> > node_allocator;
+        typedef std::allocator_traits<node_allocator> node_traits;
+
+        // Epoch a reader started in, or IDLE_SLOT. Each slot has its own cache
+        // line so that readers never write to a line another reader uses.
+        struct reader_slot {
+            alignas(CACHE_LINE) std::atomic<size_t> epoch;
+        };
+
+        static const size_t IDLE_SLOT = ~0UL;
+
+        alignas(CACHE_LINE) std::atomic< cow_node<K, V>* > root;
+        // Advanced by one at the end of every write.
+        std::atomic<size_t> epoch;
+        std::atomic<size_t> nodes_in_tree;
+        reader_slot readers[AVL_READER_SLOTS];
+
+        // Everything below is only touched while holding 'write_lock'.
+        alignas(CACHE_LINE) std::mutex write_lock;
+        node_allocator alloc;
+        // Retired nodes in the order they were unlinked, oldest first.
+        cow_node<K, V> *retired_head, *retired_tail;
+        cow_node<K, V> *released;
+
+        concurrent_AVL_tree(const concurrent_AVL_tree<K, V, Alloc>&);
+        concurrent_AVL_tree<K, V, Alloc>& operator=(const concurrent_AVL_tree<K, V, Alloc>&);
+
+        // Claims a free reader slot and records the current epoch in it. The
+        // slot must be written before the root is read, hence seq_cst; the
+        // root is then read with 'reader_root'.
+        reader_slot* enter() {
+
+            static std::atomic<unsigned> next_hint(0U);
+            static thread_local unsigned hint = next_hint.fetch_add(1U, std::memory_order_relaxed);
+
+            for( unsigned i = hint; ; i++ ) {
+                reader_slot *slot = &this->readers[i % AVL_READER_SLOTS];
+                size_t idle = IDLE_SLOT;
+                if( slot->epoch.load(std::memory_order_relaxed) == IDLE_SLOT &&
+                    slot->epoch.compare_exchange_strong(idle, this->epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst) ) {
+                    return slot;
+                }
+            }
+        }
+
+        void leave(reader_slot *slot) {
+            slot->epoch.store(IDLE_SLOT, std::memory_order_release);
+        }
+
+        cow_node<K, V>* get_node() {
+
+            cow_node<K, V> *new_node = this->released;
+            if( new_node ) this->released = new_node->next;
+            else {
+                new_node = node_traits::allocate(this->alloc, 1);
+                node_traits::construct(this->alloc, new_node);
+            }
+            new_node->version = this->epoch.load(std::memory_order_relaxed);
+            return new_node;
+        }
+
+        // The root as seen by a reader that has entered. A writer stores the
+        // root and then scans the slots, and a reader writes its slot and then
+        // loads the root. Only with both loads seq_cst can the reader not miss
+        // the new root while 'reclaim' misses its slot.
+        cow_node<K, V>* reader_root() {
+            return this->root.load(std::memory_order_seq_cst);
+        }
+
+        void free_node(cow_node<K, V> *node) {
+            node_traits::destroy(this->alloc, node);
+            node_traits::deallocate(this->alloc, node, 1);
+        }
+
+        // Nodes created by the current write have not been published yet and
+        // may be changed in place.
+        bool is_fresh(cow_node<K, V> *node) {
+            return node->version == this->epoch.load(std::memory_order_relaxed);
+        }
+
+        // Unlinks 'node' from the tree. Readers may still hold it unless it
+        // was created by the current write.
+        void discard(cow_node<K, V> *node) {
+
+            if( this->is_fresh(node) ) {
+                node->next = this->released;
+                this->released = node;
+                return;
+            }
+
+            node->version = this->epoch.load(std::memory_order_relaxed);
+            node->next = NULL;
+            if( this->retired_tail ) this->retired_tail->next = node;
+            else this->retired_head = node;
+            this->retired_tail = node;
+        }
+
+        // Returns a copy of 'node' that the current write may change.
+        cow_node<K, V>* writable(cow_node<K, V> *node) {
+
+            if( this->is_fresh(node) ) return node;
+            cow_node<K, V> *copy = this->get_node();
+            copy->left = node->left; copy->right = node->right;
+            copy->height = node->height;
+            copy->key = node->key; copy->object = node->object;
+            this->discard(node);
+            return copy;
+        }
+
+        // Moves the retired nodes that no reader can reach any more onto the
+        // released list. A node retired in epoch 'e' is safe once every active
+        // reader started after 'e'.
+        void reclaim() {
+
+            size_t oldest = IDLE_SLOT;
+            for( size_t i = 0; i < AVL_READER_SLOTS; i++ ) {
+                oldest = std::min(oldest, this->readers[i].epoch.load(std::memory_order_seq_cst));
+            }
+
+            while( this->retired_head && this->retired_head->version < oldest ) {
+                cow_node<K, V> *node = this->retired_head;
+                this->retired_head = node->next;
+                node->next = this->released;
+                this->released = node;
+            }
+            if( ! this->retired_head ) this->retired_tail = NULL;
+        }
+
+        // Publishes 'new_root' and closes the current write.
+        void publish(cow_node<K, V> *new_root) {
+
+            this->root.store(new_root, std::memory_order_seq_cst);
+            this->epoch.fetch_add(1UL, std::memory_order_seq_cst);
+            this->reclaim();
+        }
+
+        static size_t node_height(cow_node<K, V> *node) {
+            return node ? node->height : 0UL;
+        }
+
+        static void update_height(cow_node<K, V> *node) {
+            node->height = 1 + std::max<size_t>(node_height(node->left), node_height(node->right));
+        }
+
+        // Rotations take a writable node and return the writable root of the
+        // rotated subtree.
+        cow_node<K, V>* rotate_left(cow_node<K, V> *root) {
+
+            cow_node<K, V> *new_root = this->writable(root->right);
+            root->right = new_root->left;
+            update_height(root);
+            new_root->left = root;
+            update_height(new_root);
+            return new_root;
+        }
+
+        cow_node<K, V>* rotate_right(cow_node<K, V> *root) {
+
+            cow_node<K, V> *new_root = this->writable(root->left);
+            root->left = new_root->right;
+            update_height(root);
+            new_root->right = root;
+            update_height(new_root);
+            return new_root;
+        }
+
+        cow_node<K, V>* rebalance(cow_node<K, V> *node) {
+
+            update_height(node);
+            long skew = (long)node_height(node->right) - (long)node_height(node->left);
+            if( skew > 1 ) {
+                if( node_height(node->right->left) > node_height(node->right->right) ) {
+                    node->right = this->rotate_right(this->writable(node->right));
+                }
+                return this->rotate_left(node);
+            }
+            if( skew < -1 ) {
+                if( node_height(node->left->right) > node_height(node->left->left) ) {
+                    node->left = this->rotate_left(this->writable(node->left));
+                }
+                return this->rotate_right(node);
+            }
+            return node;
+        }
+
+        // Returns the new root of the subtree, or 'root' itself when 'key' is
+        // already present, in which case 'inserted' is left false.
+        cow_node<K, V>* insert_into(cow_node<K, V> *root, const K &key, V *value, bool &inserted) {
+
+            if( ! root ) {
+                cow_node<K, V> *new_node = this->get_node();
+                new_node->left = new_node->right = NULL;
+                new_node->height = 1UL;
+                new_node->key = key; new_node->object = value;
+                inserted = true;
+                return new_node;
+            }
+
+            cow_node<K, V> *child;
+            if( key < root->key ) {
+                child = this->insert_into(root->left, key, value, inserted);
+                if( ! inserted ) return root;
+                root = this->writable(root);
+                root->left = child;
+            } else if( key > root->key ) {
+                child = this->insert_into(root->right, key, value, inserted);
+                if( ! inserted ) return root;
+                root = this->writable(root);
+                root->right = child;
+            } else return root;
+
+            return this->rebalance(root);
+        }
+
+        // Unlinks the smallest node below 'root' and copies its entry out.
+        cow_node<K, V>* remove_min(cow_node<K, V> *root, K &key, V *&value) {
+
+            if( ! root->left ) {
+                key = root->key; value = root->object;
+                cow_node<K, V> *right = root->right;
+                this->discard(root);
+                return right;
+            }
+
+            cow_node<K, V> *left = this->remove_min(root->left, key, value);
+            root = this->writable(root);
+            root->left = left;
+            return this->rebalance(root);
+        }
+
+        cow_node<K, V>* remove_from(cow_node<K, V> *root, const K &key, bool &removed) {
+
+            if( ! root ) return NULL;
+
+            cow_node<K, V> *child;
+            if( key < root->key ) {
+                child = this->remove_from(root->left, key, removed);
+                if( ! removed ) return root;
+                root = this->writable(root);
+                root->left = child;
+            } else if( key > root->key ) {
+                child = this->remove_from(root->right, key, removed);
+                if( ! removed ) return root;
+                root = this->writable(root);
+                root->right = child;
+            } else {
+                removed = true;
+                if( ! root->left || ! root->right ) {
+                    child = root->left ? root->left : root->right;
+                    this->discard(root);
+                    return child;
+                }
+                // Replace the entry with its successor.
+                K next_key; V *next_value;
+                child = this->remove_min(root->right, next_key, next_value);
+                root = this->writable(root);
+                root->right = child;
+                root->key = next_key; root->object = next_value;
+            }
+
+            return this->rebalance(root);
+        }
+
+        void free_subtree(cow_node<K, V> *root) {
+
+            if( ! root ) return;
+            this->free_subtree(root->left);
+            this->free_subtree(root->right);
+            this->free_node(root);
+        }
+
+        void free_list(cow_node<K, V> *node) {
+
+            cow_node<K, V> *next_node;
+            while( node ) {
+                next_node = node->next;
+                this->free_node(node);
+                node = next_node;
+            }
+        }
+
+    public:
+
+        // Nodes come from a private arena whose blocks start at 'alloc_size'
+        // nodes and grow by a factor of 'alloc_exp'.
+        concurrent_AVL_tree(size_t alloc_size = 10, unsigned alloc_exp = 2)
+            : alloc(alloc_size, alloc_exp) {
+
+                this->root.store(NULL, std::memory_order_relaxed);
+                this->epoch.store(1UL, std::memory_order_relaxed);
+                this->nodes_in_tree.store(0UL, std::memory_order_relaxed);
+                for( size_t i = 0; i < AVL_READER_SLOTS; i++ ) this->readers[i].epoch.store(IDLE_SLOT, std::memory_order_relaxed);
+                this->retired_head = this->retired_tail = this->released = NULL;
+            }
+
+        // Nodes come from 'alloc', which may be shared with other containers.
+        explicit concurrent_AVL_tree(const Alloc &alloc)
+            : alloc(alloc) {
+
+                this->root.store(NULL, std::memory_order_relaxed);
+                this->epoch.store(1UL, std::memory_order_relaxed);
+                this->nodes_in_tree.store(0UL, std::memory_order_relaxed);
+                for( size_t i = 0; i < AVL_READER_SLOTS; i++ ) this->readers[i].epoch.store(IDLE_SLOT, std::memory_order_relaxed);
+                this->retired_head = this->retired_tail = this->released = NULL;
+            }
+
+        // No reader or writer may still be using the tree.
+        ~concurrent_AVL_tree() {
+            this->free_subtree(this->root.load(std::memory_order_relaxed));
+            this->free_list(this->retired_head);
+            this->free_list(this->released);
+        }
+
+        // Returns the value stored under 'key', or NULL. Never blocks, and may
+        // run at the same time as any number of other readers and one writer.
+        V* find(const K key) {
+
+            reader_slot *slot = this->enter();
+            V *value = NULL;
+            cow_node<K, V> *tmp_node = this->reader_root();
+            while( tmp_node ) {
+                if( key < tmp_node->key ) tmp_node = tmp_node->left;
+                else if( key > tmp_node->key ) tmp_node = tmp_node->right;
+                else {
+                    value = tmp_node->object;
+                    break;
+                }
+            }
+            this->leave(slot);
+
+            return value;
+        }
+
+        // Returns 1 if 'key' was inserted and 0 if it was already present.
+        int insert(const K key, V *value) {
+
+            std::lock_guard<std::mutex> lock(this->write_lock);
+            bool inserted = false;
+            cow_node<K, V> *new_root = this->insert_into(this->root.load(std::memory_order_relaxed), key, value, inserted);
+            if( ! inserted ) return 0;
+
+            this->publish(new_root);
+            this->nodes_in_tree.fetch_add(1UL, std::memory_order_relaxed);
+            return 1;
+        }
+
+        // Returns 1 if 'key' was removed and 0 if it was not present.
+        int remove(const K key) {
+
+            std::lock_guard<std::mutex> lock(this->write_lock);
+            bool removed = false;
+            cow_node<K, V> *new_root = this->remove_from(this->root.load(std::memory_order_relaxed), key, removed);
+            if( ! removed ) return 0;
+
+            this->publish(new_root);
+            this->nodes_in_tree.fetch_sub(1UL, std::memory_order_relaxed);
+            return 1;
+        }
+
+        size_t height() {
+
+            reader_slot *slot = this->enter();
+            size_t tree_height = node_height(this->reader_root());
+            this->leave(slot);
+            return tree_height;
+        }
+
+        size_t size() {
+            return this->nodes_in_tree.load(std::memory_order_relaxed);
+        }
+
+        // Returns the nodes that have become unreachable to the allocator so
+        // that it can reuse or trim them.
+        void shrink_to_fit() {
+
+            std::lock_guard<std::mutex> lock(this->write_lock);
+            this->reclaim();
+            this->free_list(this->released);
+            this->released = NULL;
+        }
+
+        // Calls 'f(key, value)' for every entry in key order, on a snapshot of
+        // the tree taken when the call starts. Writers are not blocked.
+        template <typename F>
+        void for_each(F f) {
+
+            reader_slot *slot = this->enter();
+            cow_node<K, V> *stack[2 * sizeof(size_t) * 8], *tmp_node = this->reader_root();
+            size_t depth = 0;
+            while( tmp_node || depth ) {
+                while( tmp_node ) {
+                    stack[depth++] = tmp_node;
+                    tmp_node = tmp_node->left;
+                }
+                tmp_node = stack[--depth];
+                f(tmp_node->key, tmp_node->object);
+                tmp_node = tmp_node->right;
+            }
+            this->leave(slot);
+        }
+};
+
+#endif /* CONCURRENT_AVL_TREE_H */
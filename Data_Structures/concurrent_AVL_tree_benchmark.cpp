@@ -0,0 +1,95 @@
+#include "concurrent_AVL_tree.h"
+#include "AVL_tree.h"
+#include <algorithm>
+#include <chrono>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+// Keys in the tree, and operations run by each thread. One operation in
+// UPDATE_EVERY is an insert or remove, the rest are lookups.
+const int N_KEYS = 100000;
+const size_t N_OPS = 500000UL;
+const size_t UPDATE_EVERY = 100UL;
+
+// AVL_tree behind a reader-writer lock, the usual way to share it.
+class locked_AVL_tree
+{
+    private:
+
+        AVL_tree<int, int> tree;
+        std::shared_mutex lock;
+
+    public:
+
+        locked_AVL_tree() : tree(1024, 2) {}
+
+        int* find(int key) {
+            std::shared_lock<std::shared_mutex> guard(this->lock);
+            bt_node<int, int> *node = this->tree.find(key);
+            return node ? node->object : NULL;
+        }
+
+        int insert(int key, int *value) {
+            std::unique_lock<std::shared_mutex> guard(this->lock);
+            return this->tree.insert(key, value) ? 1 : 0;
+        }
+
+        int remove(int key) {
+            std::unique_lock<std::shared_mutex> guard(this->lock);
+            return this->tree.remove(key);
+        }
+};
+
+// Runs 'n_threads' threads against 'tree' and returns the throughput in
+// millions of operations per second. Updates toggle keys above N_KEYS, so the
+// looked-up keys always stay in the tree.
+template <typename T>
+double run(T &tree, unsigned n_threads, int *value) {
+
+    std::vector<std::thread> threads;
+    std::atomic<size_t> found(0UL);
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < n_threads; t++) {
+        threads.emplace_back([&tree, &found, t, value]() {
+            size_t hits = 0UL, state = 0x9E3779B97F4A7C15UL * (t + 1);
+            for (size_t i = 0; i < N_OPS; i++) {
+                state = state * 6364136223846793005UL + 1442695040888963407UL;
+                int key = (int)((state >> 33) % N_KEYS);
+                if (i % UPDATE_EVERY == 0) {
+                    if ( ! tree.remove(N_KEYS + key) ) tree.insert(N_KEYS + key, value);
+                } else if (tree.find(key)) hits++;
+            }
+            found.fetch_add(hits);
+        });
+    }
+    for (auto &thread : threads) thread.join();
+    auto end = std::chrono::steady_clock::now();
+
+    if (found.load() != n_threads * (N_OPS - (N_OPS + UPDATE_EVERY - 1) / UPDATE_EVERY)) std::cout << "lookup missed a key" << std::endl;
+    return n_threads * N_OPS / std::chrono::duration<double>(end - start).count() / 1e6;
+}
+
+// Takes the maximum number of threads as an optional argument.
+int main(int argc, char **argv) {
+
+    unsigned max_threads = argc > 1 ? (unsigned)atoi(argv[1]) : std::max(1U, std::thread::hardware_concurrency());
+    int value = 1;
+
+    locked_AVL_tree locked;
+    concurrent_AVL_tree<int, int> lock_free(1024, 2);
+    for (int key = 0; key < N_KEYS; key++) {
+        locked.insert(key, &value);
+        lock_free.insert(key, &value);
+    }
+
+    std::cout << "threads  AVL_tree+shared_mutex  concurrent_AVL_tree  (M ops/s, "
+              << 100 - 100 / UPDATE_EVERY << "% lookups)" << std::endl;
+    // Powers of 2 up to 'max_threads', then 'max_threads' itself.
+    for (unsigned n_threads = 1; n_threads <= max_threads; n_threads = n_threads * 2 > max_threads && n_threads < max_threads ? max_threads : n_threads * 2) {
+        double locked_rate = run(locked, n_threads, &value);
+        double lock_free_rate = run(lock_free, n_threads, &value);
+        std::cout << n_threads << "        " << locked_rate << "                " << lock_free_rate << std::endl;
+    }
+}
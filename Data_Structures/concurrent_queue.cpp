@@ -0,0 +1,78 @@
+#include "concurrent_queue.h"
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Number of items each producer pushes during the stress tests.
+const size_t N_ITEMS = 1000000UL;
+
+// One producer pushes 0, 1, 2, ... and one consumer checks that every item
+// arrives exactly once and in order.
+bool stress_spsc() {
+
+    spsc_queue<size_t> queue(64);
+    bool ok = true;
+
+    std::thread producer([&queue]() {
+        for (size_t i = 0; i < N_ITEMS; i++) {
+            while ( ! queue.try_push(i) ) std::this_thread::yield();
+        }
+    });
+    std::thread consumer([&queue, &ok]() {
+        size_t item;
+        for (size_t i = 0; i < N_ITEMS; i++) {
+            while ( ! queue.try_pop(item) ) std::this_thread::yield();
+            if (item != i) ok = false;
+        }
+    });
+    producer.join(); consumer.join();
+
+    return ok && queue.length() == 0;
+}
+
+// Several producers push items tagged with their id and a sequence number.
+// Consumers check that the items of each producer arrive in order, and the
+// totals are compared to make sure nothing was lost or duplicated.
+bool stress_mpmc(unsigned n_producers, unsigned n_consumers) {
+
+    mpmc_queue<size_t> queue(64);
+    std::atomic<size_t> consumed(0UL), checksum(0UL);
+    std::atomic<bool> ok(true);
+    const size_t total = N_ITEMS * n_producers;
+
+    std::vector<std::thread> threads;
+    for (unsigned p = 0; p < n_producers; p++) {
+        threads.emplace_back([&queue, p]() {
+            for (size_t i = 0; i < N_ITEMS; i++) {
+                while ( ! queue.try_push(((size_t)p << 32) | i) ) std::this_thread::yield();
+            }
+        });
+    }
+    for (unsigned c = 0; c < n_consumers; c++) {
+        threads.emplace_back([&, n_producers]() {
+            std::vector<long> last(n_producers, -1L);
+            size_t item, sum = 0UL;
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                if ( ! queue.try_pop(item) ) { std::this_thread::yield(); continue; }
+                consumed.fetch_add(1, std::memory_order_relaxed);
+                size_t p = item >> 32; long i = (long)(item & 0xFFFFFFFFUL);
+                if (i <= last[p]) ok = false;
+                last[p] = i;
+                sum += i;
+            }
+            checksum.fetch_add(sum);
+        });
+    }
+    for (auto &thread : threads) thread.join();
+
+    return ok && consumed == total && checksum == n_producers * (N_ITEMS * (N_ITEMS - 1) / 2);
+}
+
+// For testing.
+int main() {
+
+    std::cout << "SPSC: " << (stress_spsc() ? "passed" : "FAILED") << std::endl;
+    std::cout << "MPMC 1x1: " << (stress_mpmc(1, 1) ? "passed" : "FAILED") << std::endl;
+    std::cout << "MPMC 4x4: " << (stress_mpmc(4, 4) ? "passed" : "FAILED") << std::endl;
+    std::cout << "MPMC 2x6: " << (stress_mpmc(2, 6) ? "passed" : "FAILED") << std::endl;
+}
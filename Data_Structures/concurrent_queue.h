@@ -0,0 +1,194 @@
+#ifndef CONCURRENT_QUEUE_H
+#define CONCURRENT_QUEUE_H
+
+#include <stdlib.h>
+#include <atomic>
+
+// Size of a cache line. Indices written by different threads are kept on
+// separate lines so that producers and consumers do not invalidate each other.
+#define CACHE_LINE 64
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+template <typename T>
+class spsc_queue
+{
+    private:
+
+        // Contiguous storage for the items. The capacity is always a power of 2
+        // so that indices can be wrapped with a mask instead of a modulo.
+        T *buffer;
+        size_t capacity, mask;
+        // Index of the next slot to read. Only written by the consumer.
+        alignas(CACHE_LINE) std::atomic<size_t> head;
+        // Consumer's cached copy of 'tail', refreshed only when the queue looks empty.
+        size_t tail_cache;
+        // Index of the next slot to write. Only written by the producer.
+        alignas(CACHE_LINE) std::atomic<size_t> tail;
+        // Producer's cached copy of 'head', refreshed only when the queue looks full.
+        size_t head_cache;
+
+        spsc_queue(const spsc_queue<T>&);
+        spsc_queue<T>& operator=(const spsc_queue<T>&);
+
+    public:
+
+        spsc_queue(size_t capacity = 1024)
+        {
+            // Round the capacity up to a power of 2.
+            this->capacity = 1UL;
+            while (this->capacity < capacity) this->capacity <<= 1;
+            this->mask = this->capacity - 1;
+            this->buffer = new T[this->capacity];
+            this->head.store(0UL, std::memory_order_relaxed);
+            this->tail.store(0UL, std::memory_order_relaxed);
+            this->head_cache = this->tail_cache = 0UL;
+        }
+
+        ~spsc_queue() {
+            delete[] this->buffer;
+        }
+
+        // Places 'item' at the end of the queue. Returns false if the queue is full.
+        // Must only be called from the producer thread.
+        bool try_push(const T &item) {
+
+            size_t tail = this->tail.load(std::memory_order_relaxed);
+            if (tail - this->head_cache == this->capacity) {
+                this->head_cache = this->head.load(std::memory_order_acquire);
+                if (tail - this->head_cache == this->capacity) return false;
+            }
+            this->buffer[tail & this->mask] = item;
+            this->tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Removes the item at the front of the queue and stores it in 'item'.
+        // Returns false if the queue is empty. Must only be called from the consumer thread.
+        bool try_pop(T &item) {
+
+            size_t head = this->head.load(std::memory_order_relaxed);
+            if (head == this->tail_cache) {
+                this->tail_cache = this->tail.load(std::memory_order_acquire);
+                if (head == this->tail_cache) return false;
+            }
+            item = this->buffer[head & this->mask];
+            this->head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Returns an estimate of the number of elements in the queue.
+        size_t length() {
+            return this->tail.load(std::memory_order_acquire) - this->head.load(std::memory_order_acquire);
+        }
+};
+
+// Slot of an mpmc_queue. 'sequence' records which lap of the ring the slot is
+// ready for, which is how slots are handed back and forth between producers and
+// consumers without a separate free list.
+template <typename T>
+struct seq_node {
+    std::atomic<size_t> sequence;
+    T item;
+};
+
+// Bounded lock-free queue for any number of producer and consumer threads.
+// All nodes are allocated up front and recycled in place: a consumer that
+// empties a node stamps it with the sequence number of the producer that may
+// reuse it on the next lap, so there is no allocation and no ABA hazard on the hot path.
+template <typename T>
+class mpmc_queue
+{
+    private:
+
+        // Free store of nodes. The capacity is always a power of 2.
+        seq_node<T> *nodes;
+        size_t capacity, mask;
+        // Ticket of the next consumer.
+        alignas(CACHE_LINE) std::atomic<size_t> head;
+        // Ticket of the next producer.
+        alignas(CACHE_LINE) std::atomic<size_t> tail;
+
+        mpmc_queue(const mpmc_queue<T>&);
+        mpmc_queue<T>& operator=(const mpmc_queue<T>&);
+
+    public:
+
+        mpmc_queue(size_t capacity = 1024)
+        {
+            // Round the capacity up to a power of 2, with at least 2 nodes.
+            this->capacity = 2UL;
+            while (this->capacity < capacity) this->capacity <<= 1;
+            this->mask = this->capacity - 1;
+            this->nodes = new seq_node<T>[this->capacity];
+            for (size_t i = 0; i < this->capacity; i++) {
+                this->nodes[i].sequence.store(i, std::memory_order_relaxed);
+            }
+            this->head.store(0UL, std::memory_order_relaxed);
+            this->tail.store(0UL, std::memory_order_relaxed);
+        }
+
+        ~mpmc_queue() {
+            delete[] this->nodes;
+        }
+
+        // Places 'item' at the end of the queue. Returns false if the queue is full.
+        bool try_push(const T &item) {
+
+            seq_node<T> *node;
+            size_t tail = this->tail.load(std::memory_order_relaxed);
+            while (true) {
+                node = &this->nodes[tail & this->mask];
+                size_t sequence = node->sequence.load(std::memory_order_acquire);
+                long diff = (long)sequence - (long)tail;
+                if (diff == 0) {
+                    // The node is free for this lap; claim it.
+                    if (this->tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)) break;
+                } else if (diff < 0) {
+                    // The node still holds an item from the previous lap.
+                    return false;
+                } else {
+                    // Another producer claimed the node first.
+                    tail = this->tail.load(std::memory_order_relaxed);
+                }
+            }
+            node->item = item;
+            node->sequence.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Removes the item at the front of the queue and stores it in 'item'.
+        // Returns false if the queue is empty.
+        bool try_pop(T &item) {
+
+            seq_node<T> *node;
+            size_t head = this->head.load(std::memory_order_relaxed);
+            while (true) {
+                node = &this->nodes[head & this->mask];
+                size_t sequence = node->sequence.load(std::memory_order_acquire);
+                long diff = (long)sequence - (long)(head + 1);
+                if (diff == 0) {
+                    // The node holds an item for this lap; claim it.
+                    if (this->head.compare_exchange_weak(head, head + 1, std::memory_order_relaxed)) break;
+                } else if (diff < 0) {
+                    // No producer has filled the node yet.
+                    return false;
+                } else {
+                    // Another consumer claimed the node first.
+                    head = this->head.load(std::memory_order_relaxed);
+                }
+            }
+            item = node->item;
+            // Release the node to the producer of the next lap.
+            node->sequence.store(head + this->capacity, std::memory_order_release);
+            return true;
+        }
+
+        // Returns an estimate of the number of elements in the queue.
+        size_t length() {
+            size_t head = this->head.load(std::memory_order_acquire);
+            size_t tail = this->tail.load(std::memory_order_acquire);
+            return tail > head ? tail - head : 0UL;
+        }
+};
+
+#endif /* CONCURRENT_QUEUE_H */
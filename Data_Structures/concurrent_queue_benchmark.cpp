@@ -0,0 +1,88 @@
+#include "concurrent_queue.h"
+#include "deque.h"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Number of items pushed through the queue in each run, shared among the producers.
+const size_t N_ITEMS = 4000000UL;
+
+// The single-threaded deque behind one lock, as used before the lock-free queues existed.
+template <typename T>
+class locked_deque
+{
+    private:
+
+        deque<T> deq;
+        std::mutex lock;
+
+    public:
+
+        locked_deque(size_t capacity) : deq(capacity, 2) {}
+
+        bool try_push(const T &item) {
+            std::lock_guard<std::mutex> guard(this->lock);
+            this->deq.append(item);
+            return true;
+        }
+
+        bool try_pop(T &item) {
+            std::lock_guard<std::mutex> guard(this->lock);
+            if ( ! this->deq.length() ) return false;
+            item = this->deq.prepop();
+            return true;
+        }
+};
+
+// Runs 'n_threads' producers and 'n_threads' consumers against 'queue' and
+// returns the throughput in millions of items per second.
+template <typename Q>
+double run(Q &queue, unsigned n_threads) {
+
+    const size_t per_producer = N_ITEMS / n_threads;
+    const size_t total = per_producer * n_threads;
+    std::atomic<size_t> consumed(0UL);
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < n_threads; t++) {
+        threads.emplace_back([&queue, per_producer]() {
+            for (size_t i = 0; i < per_producer; i++) {
+                while ( ! queue.try_push(i) ) std::this_thread::yield();
+            }
+        });
+        threads.emplace_back([&queue, &consumed, total]() {
+            size_t item;
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                if (queue.try_pop(item)) consumed.fetch_add(1, std::memory_order_relaxed);
+                else std::this_thread::yield();
+            }
+        });
+    }
+    for (auto &thread : threads) thread.join();
+    auto end = std::chrono::steady_clock::now();
+
+    return total / std::chrono::duration<double>(end - start).count() / 1e6;
+}
+
+int main() {
+
+    unsigned max_threads = std::max(2U, std::thread::hardware_concurrency() / 2);
+
+    {
+        spsc_queue<size_t> spsc(4096);
+        std::cout << "spsc_queue 1x1: " << run(spsc, 1) << " M items/s" << std::endl;
+    }
+
+    std::cout << "threads  locked_deque  mpmc_queue  (M items/s)" << std::endl;
+    for (unsigned n_threads = 1; n_threads <= max_threads; n_threads *= 2) {
+        locked_deque<size_t> locked(4096);
+        mpmc_queue<size_t> mpmc(4096);
+        double locked_rate = run(locked, n_threads);
+        double mpmc_rate = run(mpmc, n_threads);
+        std::cout << n_threads << "x" << n_threads << "      "
+                  << locked_rate << "       " << mpmc_rate << std::endl;
+    }
+}
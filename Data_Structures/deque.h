@@ -0,0 +1,480 @@
+#ifndef DEQUE_H
+#define DEQUE_H
+
+#include "slab_allocator.h"
+#include <stdlib.h>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+// Doubly-linked node.
+template <typename T>
+struct dl_node {
+    dl_node<T> *prev, *next;
+    T item;
+};
+
+// Singly-linked pointer node.
+template <typename T>
+struct slp_node {
+    slp_node<T> *next;
+    T *item;
+};
+
+template <typename T, typename Alloc = slab_allocator<T> >
+class deque
+{
+    private:
+
+        typedef typename std::allocator_traits<Alloc>::template rebind_alloc< dl_node<T> > node_allocator;
+        typedef std::allocator_traits<node_allocator> node_traits;
+
+        // Source of the nodes. By default each deque has a private slab arena,
+        // which reproduces the geometric block allocation the deque used to do itself.
+        node_allocator alloc;
+        // Head and tail of the doubly-linked list.
+        dl_node<T> *head, *tail;
+        // Released is the head of a singly-linked list of discarded nodes.
+        dl_node<T> *released;
+        // The number of elements in the deque.
+        size_t len;
+
+        // Request a node from the heap. Its item is not constructed.
+        dl_node<T>* get_node() {
+            
+            dl_node<T> *node;
+
+            // If there is a previously released node available, select it.
+            if ( this->released ) {
+                node = released;
+                released = node->next;
+                return node;
+            }
+            // Otherwise request a new node from the allocator.
+            return node_traits::allocate(this->alloc, 1);
+        }
+
+        // Request a node and construct its item from 'args' in place. If the
+        // constructor throws, the node is released again.
+        template <typename... Args>
+        dl_node<T>* make_node(Args&&... args) {
+
+            dl_node<T> *node = get_node();
+            try {
+                node_traits::construct(this->alloc, &node->item, std::forward<Args>(args)...);
+            } catch (...) {
+                node->next = this->released;
+                this->released = node;
+                throw;
+            }
+            return node;
+        }
+
+        // Destroys the item of a node and makes the node available for future addition to the deque.
+        void delete_node(dl_node<T> *node) {
+            node_traits::destroy(this->alloc, &node->item);
+            node->next = this->released;
+            this->released = node;
+        }
+
+        // Returns 'node', whose item has been destroyed, to the allocator.
+        void free_node(dl_node<T> *node) {
+            node_traits::deallocate(this->alloc, node, 1);
+        }
+
+        // Links 'node' in after the tail of the deque.
+        void link_back(dl_node<T> *node) {
+
+            node->next = NULL;
+            node->prev = this->tail;
+            if (this->tail) this->tail->next = node;
+            else this->head = node;
+            this->tail = node;
+            ++this->len;
+        }
+
+        // Links 'node' in before the head of the deque.
+        void link_front(dl_node<T> *node) {
+
+            node->prev = NULL;
+            node->next = this->head;
+            if (this->head) this->head->prev = node;
+            else this->tail = node;
+            this->head = node;
+            ++this->len;
+        }
+
+    public:
+
+        // Nodes come from a private arena whose blocks start at 'exp_mag' nodes
+        // and grow by a factor of 'exp_fac'.
+        deque(unsigned exp_mag = 100, unsigned exp_fac = 2)
+            : alloc(exp_mag, exp_fac)
+        {   
+            // Initialize the head and tail to NULL to indicate an empty deque.
+            this->head = this->tail = NULL;
+            // Initialize 'released' to NULL to indicate an empty list.
+            this->released = NULL;
+            // Initialize length of deque to 0.
+            this->len = 0UL;
+        }
+
+        // Nodes come from 'alloc', which may be shared with other containers.
+        explicit deque(const Alloc &alloc)
+            : alloc(alloc)
+        {
+            this->head = this->tail = NULL;
+            this->released = NULL;
+            this->len = 0UL;
+        }
+
+        // Return every node to the allocator.
+        ~deque() {
+            
+            dl_node<T> *next_node, *current_node = this->head;
+            while ( current_node ) {
+                next_node = current_node->next;
+                node_traits::destroy(this->alloc, &current_node->item);
+                free_node(current_node);
+                current_node = next_node;
+            }
+            shrink_to_fit();
+        }
+
+        // Provide global function with access to private members.
+        template <typename T_s, typename Alloc_s>
+        friend std::ostream& std::operator<<(std::ostream& os, const deque<T_s, Alloc_s>& deq);
+
+        // Returns the number of elements in the deque.
+        size_t length() {
+            return this->len;
+        }
+
+        // Returns the number of bytes the allocator holds on the heap. When the
+        // allocator is shared, this includes memory used by the other containers.
+        size_t memory_usage() {
+            return this->alloc.stats().bytes_reserved;
+        }
+
+        node_allocator get_allocator() {
+            return this->alloc;
+        }
+
+        // Returns the released nodes to the allocator so that it can reuse or trim them.
+        void shrink_to_fit() {
+
+            dl_node<T> *next_node;
+            while ( this->released ) {
+                next_node = this->released->next;
+                free_node(this->released);
+                this->released = next_node;
+            }
+        }
+
+        // Places 'item' at the end of the deque.
+        void append(const T &item) {
+            emplace_back(item);
+        }
+
+        void append(T &&item) {
+            emplace_back(std::move(item));
+        }
+
+        // Places 'item' at the front of the deque.
+        void prepend(const T &item) {
+            emplace_front(item);
+        }
+
+        void prepend(T &&item) {
+            emplace_front(std::move(item));
+        }
+
+        // Constructs an item from 'args' at the end of the deque and returns a reference to it.
+        template <typename... Args>
+        T& emplace_back(Args&&... args) {
+
+            dl_node<T> *node = make_node(std::forward<Args>(args)...);
+            link_back(node);
+            return node->item;
+        }
+
+        // Constructs an item from 'args' at the front of the deque and returns a reference to it.
+        template <typename... Args>
+        T& emplace_front(Args&&... args) {
+
+            dl_node<T> *node = make_node(std::forward<Args>(args)...);
+            link_front(node);
+            return node->item;
+        }
+
+        // Places the items in [first, last) at the end of the deque, in order.
+        // The allocator is told up front how many nodes are coming so that it
+        // can set them aside with a single block allocation.
+        template <typename ForwardIt>
+        void extend(ForwardIt first, ForwardIt last) {
+
+            reserve_blocks(this->alloc, std::distance(first, last));
+            for (; first != last; ++first) emplace_back(*first);
+        }
+
+        // Removes and returns the item at the end of the deque.
+        T pop() {
+
+            if ( ! this->len ) exit(EXIT_FAILURE);
+
+            dl_node<T> *last_node = this->tail;
+            T item = std::move(last_node->item);
+            if (last_node->prev) {
+                last_node->prev->next = NULL;
+            } else {
+                this->head = NULL;
+            }
+            this->tail = last_node->prev;
+            delete_node(last_node);
+            this->len--;
+            return item;
+        }
+
+        // Removes and returns the item at the front of the deque.
+        T prepop() {
+
+            if ( ! this->len ) exit(EXIT_FAILURE);
+
+            dl_node<T> *first_node = this->head;
+            T item = std::move(first_node->item);
+            if (first_node->next) { 
+                first_node->next->prev = NULL; 
+            } else {
+                this->tail = NULL; 
+            }
+            this->head = first_node->next;
+            delete_node(first_node);
+            this->len--;
+            return item;
+        }
+};
+
+// Overload << operator to accept deque.
+template <typename T, typename Alloc>
+std::ostream& std::operator<<(std::ostream& os, const deque<T, Alloc>& deq) {
+    
+    dl_node<T> *tmp_node = deq.head;
+    while ( tmp_node ) {
+        os << tmp_node->item << " ";
+        tmp_node = tmp_node->next;
+    } 
+    
+    return os;
+}
+
+// Deque stored in a growable circular buffer. Offers the same interface as 
+// 'deque' plus O(1) random access, at the cost of reallocating and moving
+// every element when the buffer is full.
+template <typename T>
+class ring_deque
+{
+    private:
+
+        // Contiguous storage for the items. Only the 'len' slots from 'head' on
+        // hold constructed items. The capacity is always a power of 2 so that
+        // indices can be wrapped with a mask instead of a modulo.
+        std::allocator<T> alloc;
+        T *buffer;
+        size_t capacity, mask;
+        // Index of the first item in the buffer.
+        size_t head;
+        // The number of elements in the deque.
+        size_t len;
+
+        // Double the capacity of the buffer, or more if needed to hold 'min_capacity' items.
+        size_t larger_capacity(size_t min_capacity = 0UL) {
+
+            size_t new_capacity = this->capacity * 2;
+            while (new_capacity < min_capacity) new_capacity <<= 1;
+            return new_capacity;
+        }
+
+        // Moves the items into 'new_buffer', unwrapped so that the first item
+        // sits at index 0, and frees the old buffer. New items are built in
+        // 'new_buffer' before this is called, as their arguments may refer to
+        // items of the old one.
+        void move_to(T *new_buffer, size_t new_capacity) {
+
+            for (size_t i = 0; i < this->len; i++) {
+                T &item = this->buffer[(this->head + i) & this->mask];
+                ::new ((void*)(new_buffer + i)) T(std::move(item));
+                item.~T();
+            }
+            this->alloc.deallocate(this->buffer, this->capacity);
+            this->buffer = new_buffer;
+            this->capacity = new_capacity;
+            this->mask = new_capacity - 1;
+            this->head = 0UL;
+        }
+
+        // Constructs an item from 'args' at 'index' of a new buffer of 'new_capacity'
+        // items, then moves the items across.
+        template <typename... Args>
+        T* grow_with(size_t new_capacity, size_t index, Args&&... args) {
+
+            T *new_buffer = this->alloc.allocate(new_capacity), *slot;
+            try {
+                slot = ::new ((void*)(new_buffer + index)) T(std::forward<Args>(args)...);
+            } catch (...) {
+                this->alloc.deallocate(new_buffer, new_capacity);
+                throw;
+            }
+            move_to(new_buffer, new_capacity);
+            return slot;
+        }
+
+        ring_deque(const ring_deque<T>&);
+        ring_deque<T>& operator=(const ring_deque<T>&);
+
+    public:
+
+        ring_deque(size_t capacity = 128)
+        {
+            // Round the initial capacity up to a power of 2.
+            this->capacity = 1UL;
+            while (this->capacity < capacity) this->capacity <<= 1;
+            this->mask = this->capacity - 1;
+            this->buffer = this->alloc.allocate(this->capacity);
+            this->head = this->len = 0UL;
+        }
+
+        ~ring_deque() {
+            for (size_t i = 0; i < this->len; i++) this->buffer[(this->head + i) & this->mask].~T();
+            this->alloc.deallocate(this->buffer, this->capacity);
+        }
+
+        // Provide global function with access to private members.
+        template <typename T_s>
+        friend std::ostream& std::operator<<(std::ostream& os, const ring_deque<T_s>& deq);
+
+        // Returns the number of elements in the deque.
+        size_t length() {
+            return this->len;
+        }
+
+        // Returns the number of bytes held on the heap by the deque.
+        size_t memory_usage() {
+            return this->capacity * sizeof(T);
+        }
+
+        // Returns a reference to the item at position 'index' from the front of the deque.
+        T& operator[](size_t index) {
+            return this->buffer[(this->head + index) & this->mask];
+        }
+
+        // Places 'item' at the end of the deque.
+        void append(const T &item) {
+            emplace_back(item);
+        }
+
+        void append(T &&item) {
+            emplace_back(std::move(item));
+        }
+
+        // Places 'item' at the front of the deque.
+        void prepend(const T &item) {
+            emplace_front(item);
+        }
+
+        void prepend(T &&item) {
+            emplace_front(std::move(item));
+        }
+
+        // Constructs an item from 'args' at the end of the deque and returns a reference to it.
+        template <typename... Args>
+        T& emplace_back(Args&&... args) {
+
+            T *slot;
+            if (this->len == this->capacity) {
+                slot = grow_with(larger_capacity(), this->len, std::forward<Args>(args)...);
+            } else {
+                slot = ::new ((void*)(this->buffer + ((this->head + this->len) & this->mask))) T(std::forward<Args>(args)...);
+            }
+            ++this->len;
+            return *slot;
+        }
+
+        // Constructs an item from 'args' at the front of the deque and returns a reference to it.
+        template <typename... Args>
+        T& emplace_front(Args&&... args) {
+
+            T *slot;
+            if (this->len == this->capacity) {
+                size_t new_capacity = larger_capacity();
+                slot = grow_with(new_capacity, new_capacity - 1, std::forward<Args>(args)...);
+            } else {
+                slot = ::new ((void*)(this->buffer + ((this->head - 1) & this->mask))) T(std::forward<Args>(args)...);
+            }
+            this->head = (this->head - 1) & this->mask;
+            ++this->len;
+            return *slot;
+        }
+
+        // Places the items in [first, last) at the end of the deque, in order,
+        // growing the buffer at most once. The items are copied into the new
+        // buffer before the old one is freed, so the range may lie in the deque.
+        template <typename ForwardIt>
+        void extend(ForwardIt first, ForwardIt last) {
+
+            size_t n = std::distance(first, last);
+            if (this->len + n <= this->capacity) {
+                for (; first != last; ++first) emplace_back(*first);
+                return;
+            }
+
+            size_t new_capacity = larger_capacity(this->len + n), built = 0UL;
+            T *new_buffer = this->alloc.allocate(new_capacity);
+            try {
+                for (; first != last; ++first, ++built) ::new ((void*)(new_buffer + this->len + built)) T(*first);
+            } catch (...) {
+                while (built) new_buffer[this->len + --built].~T();
+                this->alloc.deallocate(new_buffer, new_capacity);
+                throw;
+            }
+            move_to(new_buffer, new_capacity);
+            this->len += n;
+        }
+
+        // Removes and returns the item at the end of the deque.
+        T pop() {
+
+            if ( ! this->len ) exit(EXIT_FAILURE);
+
+            this->len--;
+            T &slot = this->buffer[(this->head + this->len) & this->mask];
+            T item = std::move(slot);
+            slot.~T();
+            return item;
+        }
+
+        // Removes and returns the item at the front of the deque.
+        T prepop() {
+
+            if ( ! this->len ) exit(EXIT_FAILURE);
+
+            T item = std::move(this->buffer[this->head]);
+            this->buffer[this->head].~T();
+            this->head = (this->head + 1) & this->mask;
+            this->len--;
+            return item;
+        }
+};
+
+// Overload << operator to accept ring_deque.
+template <typename T>
+std::ostream& std::operator<<(std::ostream& os, const ring_deque<T>& deq) {
+
+    for (size_t i = 0; i < deq.len; i++) {
+        os << deq.buffer[(deq.head + i) & deq.mask] << " ";
+    }
+
+    return os;
+}
+
+#endif /* DEQUE_H */
@@ -0,0 +1,101 @@
+#include "deque.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Number of elements pushed through each deque.
+const size_t N_ELEMENTS = 10000000UL;
+
+// Times 'N_ELEMENTS' appends followed by 'N_ELEMENTS' prepops and reports the
+// heap bytes used per element while the deque is full.
+template <typename D>
+void benchmark(const char *name, D &deq) {
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < N_ELEMENTS; i++) deq.append(i);
+    auto mid = std::chrono::steady_clock::now();
+    size_t bytes = deq.memory_usage();
+
+    size_t checksum = 0UL;
+    for (size_t i = 0; i < N_ELEMENTS; i++) checksum += deq.prepop();
+    auto end = std::chrono::steady_clock::now();
+
+    double push_s = std::chrono::duration<double>(mid - start).count();
+    double pop_s = std::chrono::duration<double>(end - mid).count();
+
+    std::cout << name << ": "
+              << (double)bytes / N_ELEMENTS << " bytes/element, "
+              << N_ELEMENTS / push_s / 1e6 << " M appends/s, "
+              << N_ELEMENTS / pop_s / 1e6 << " M prepops/s "
+              << "(checksum " << checksum << ")" << std::endl;
+}
+
+// Returns the time in seconds taken by 'f'.
+template <typename F>
+double seconds(F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Compares the ways of filling a deque with the items of 'source': copying
+// append, moving append, emplace_back and a single extend. Each fill is
+// followed by draining the deque with prepop, which moves the items out.
+template <typename D, typename T>
+void benchmark_insertion(const char *name, const std::vector<T> &source) {
+
+    const size_t n = source.size();
+    double copy_s, move_s, emplace_s, extend_s, drain_s;
+    size_t checksum = 0UL;
+    {
+        D deq;
+        copy_s = seconds([&]() { for (size_t i = 0; i < n; i++) deq.append(source[i]); });
+        drain_s = seconds([&]() {
+            for (size_t i = 0; i < n; i++) {
+                T item = deq.prepop();
+                checksum += sizeof(item);
+            }
+        });
+    }
+    {
+        D deq;
+        std::vector<T> items(source);
+        move_s = seconds([&]() { for (size_t i = 0; i < n; i++) deq.append(std::move(items[i])); });
+    }
+    {
+        D deq;
+        emplace_s = seconds([&]() { for (size_t i = 0; i < n; i++) deq.emplace_back(source[i]); });
+    }
+    {
+        D deq;
+        extend_s = seconds([&]() { deq.extend(source.begin(), source.end()); });
+        checksum += deq.length();
+    }
+
+    std::cout << name << " (M items/s): "
+              << "append copy " << n / copy_s / 1e6 << ", "
+              << "append move " << n / move_s / 1e6 << ", "
+              << "emplace_back " << n / emplace_s / 1e6 << ", "
+              << "extend " << n / extend_s / 1e6 << ", "
+              << "prepop " << n / drain_s / 1e6
+              << " (checksum " << checksum << ")" << std::endl;
+}
+
+int main() {
+
+    deque<size_t> linked(100, 2);
+    ring_deque<size_t> ring(128);
+
+    benchmark("deque     ", linked);
+    benchmark("ring_deque", ring);
+
+    std::vector<size_t> pods(N_ELEMENTS / 4);
+    for (size_t i = 0; i < pods.size(); i++) pods[i] = i;
+    std::vector<std::string> rows(N_ELEMENTS / 4);
+    for (size_t i = 0; i < rows.size(); i++) rows[i] = "row," + std::to_string(i) + ",with,some,padding,past,sso";
+
+    benchmark_insertion< deque<size_t> >("deque<size_t>          ", pods);
+    benchmark_insertion< ring_deque<size_t> >("ring_deque<size_t>     ", pods);
+    benchmark_insertion< deque<std::string> >("deque<std::string>     ", rows);
+    benchmark_insertion< ring_deque<std::string> >("ring_deque<std::string>", rows);
+}
@@ -0,0 +1,72 @@
+#include "slab_allocator.h"
+#include "deque.h"
+#include "AVL_tree.h"
+#include <iostream>
+#include <list>
+#include <thread>
+
+void print_stats(const char *label, slab_stats s) {
+    std::cout << label << ": reserved " << s.bytes_reserved << " B, live " << s.bytes_live
+              << " B, peak " << s.peak_bytes_live << " B" << std::endl;
+}
+
+// For testing.
+int main() {
+
+    // A single pool: blocks are recycled, and trim only releases fully free slabs.
+    slab_pool pool(24, 4, 2);
+    void *blocks[28];
+    for (size_t i = 0; i < 28; i++) blocks[i] = pool.allocate();
+    print_stats("Pool after 28 allocations", pool.stats());
+    for (size_t i = 0; i < 28; i += 2) pool.deallocate(blocks[i]);
+    std::cout << "Trim with every other block free: " << pool.trim() << " B released" << std::endl;
+    for (size_t i = 1; i < 28; i += 2) pool.deallocate(blocks[i]);
+    std::cout << "Trim with all blocks free: " << pool.trim() << " B released" << std::endl;
+    print_stats("Pool after trim", pool.stats());
+
+    // One arena shared by containers of different types.
+    auto arena = std::make_shared<slab_arena>(64, 2);
+    {
+        deque<int> numbers( (slab_allocator<int>(arena)) );
+        deque<double> reals( (slab_allocator<double>(arena)) );
+        AVL_tree<int, double> tree( (slab_allocator< bt_node<int, double> >(arena)) );
+        std::list< int, slab_allocator<int> > list( (slab_allocator<int>(arena)) );
+
+        double values[1000];
+        for (int i = 0; i < 1000; i++) {
+            values[i] = i * 0.5;
+            numbers.append(i); reals.prepend(values[i]);
+            tree.insert(i, &values[i]);
+            list.push_back(i);
+        }
+        print_stats("Arena with four containers", arena->stats());
+
+        for (int i = 0; i < 1000; i++) {
+            numbers.pop(); reals.pop();
+            tree.remove(i);
+        }
+        numbers.shrink_to_fit(); reals.shrink_to_fit(); tree.shrink_to_fit();
+        list.clear();
+        print_stats("Arena after emptying the containers", arena->stats());
+    }
+    std::cout << "Trim: " << arena->trim() << " B released" << std::endl;
+    print_stats("Arena after trim", arena->stats());
+
+    // A thread-safe arena: every thread allocates and frees through its own cache.
+    auto shared = std::make_shared<slab_arena>(64, 2, true);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([shared]() {
+            deque<long> local( (slab_allocator<long>(shared)) );
+            for (int round = 0; round < 100; round++) {
+                for (long i = 0; i < 1000; i++) local.append(i);
+                while (local.length()) local.prepop();
+                local.shrink_to_fit();
+            }
+        });
+    }
+    for (auto &thread : threads) thread.join();
+    print_stats("Thread-safe arena after 4 threads", shared->stats());
+    std::cout << "Trim: " << shared->trim() << " B released" << std::endl;
+    print_stats("Thread-safe arena after trim", shared->stats());
+}
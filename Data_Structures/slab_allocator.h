@@ -0,0 +1,531 @@
+#ifndef SLAB_ALLOCATOR_H
+#define SLAB_ALLOCATOR_H
+
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+// Size classes of a slab_arena are multiples of SLAB_GRANULARITY bytes up to
+// SLAB_SMALL_BLOCK bytes, then whole cache lines of SLAB_LINE bytes up to
+// SLAB_MAX_BLOCK bytes for nodes that span several lines, such as BP_tree's.
+// Larger requests go straight to operator new. A request
+// for more than 8-byte alignment is rounded up to a multiple of the alignment,
+// and every slab is aligned to the largest power of 2 dividing its block size,
+// so the blocks of such a size class are aligned too.
+#define SLAB_GRANULARITY 8
+#define SLAB_SMALL_BLOCK 256
+#define SLAB_LINE 64
+#define SLAB_MAX_BLOCK 1024
+#define SLAB_CLASSES (SLAB_SMALL_BLOCK / SLAB_GRANULARITY + (SLAB_MAX_BLOCK - SLAB_SMALL_BLOCK) / SLAB_LINE)
+// Blocks a thread keeps for each thread-safe pool, and the number moved
+// between the thread and the pool at once.
+#define SLAB_CACHE_BLOCKS 64
+#define SLAB_CACHE_BATCH 32
+// Number of pools a thread can cache blocks for at the same time.
+#define SLAB_CACHE_SLOTS 8
+
+// Memory from operator new aligned to 'align' bytes, a power of 2, and its release.
+inline void* slab_new(size_t bytes, size_t align) {
+    if (align <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) return ::operator new(bytes);
+    return ::operator new(bytes, std::align_val_t(align));
+}
+
+inline void slab_delete(void *memory, size_t align) {
+    if (align <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) ::operator delete(memory);
+    else ::operator delete(memory, std::align_val_t(align));
+}
+
+// Memory statistics of a pool or an arena.
+struct slab_stats {
+    // Bytes obtained from the system.
+    size_t bytes_reserved;
+    // Bytes handed out and not yet returned, including blocks parked in thread caches.
+    size_t bytes_live;
+    // Highest value 'bytes_live' has reached.
+    size_t peak_bytes_live;
+};
+
+// Pool of fixed-size blocks carved out of geometrically growing slabs, the same
+// scheme 'deque' and 'AVL_tree' used to hand-roll. Freed blocks are kept on an
+// intrusive free list, and slabs whose blocks are all free can be returned to
+// the system with 'trim'.
+//
+// A thread-safe pool guards its state with a mutex and gives every thread a
+// small cache of blocks, so most calls never take the lock. A thread-safe pool
+// may be destroyed while other threads still cache its blocks; those caches are
+// dropped the next time the thread touches them.
+class slab_pool
+{
+    private:
+
+        struct free_block {
+            free_block *next;
+        };
+
+        struct slab {
+            char *memory;
+            size_t n_blocks;
+        };
+
+        // Blocks cached by one thread for one pool.
+        struct thread_cache {
+            unsigned long pool_id;
+            size_t count;
+            void *blocks[SLAB_CACHE_BLOCKS];
+        };
+
+        // All of a thread's caches. When the thread exits, cached blocks are
+        // returned to their pools if those pools still exist.
+        struct thread_caches {
+            thread_cache slots[SLAB_CACHE_SLOTS];
+
+            thread_caches() {
+                for (size_t i = 0; i < SLAB_CACHE_SLOTS; i++) {
+                    this->slots[i].pool_id = 0UL;
+                    this->slots[i].count = 0UL;
+                }
+            }
+
+            ~thread_caches() {
+                for (size_t i = 0; i < SLAB_CACHE_SLOTS; i++) flush(this->slots[i]);
+            }
+        };
+
+        size_t block_size, alloc_size; unsigned alloc_exp;
+        // Alignment of the slabs, and so of every block.
+        size_t slab_align;
+        // Untouched blocks at the end of the newest slab.
+        char *free_store;
+        size_t blocks_remaining;
+        // Head of the intrusive list of freed blocks.
+        free_block *released;
+        std::vector<slab> allocations;
+        size_t blocks_reserved, blocks_live, peak_blocks_live;
+        bool thread_safe;
+        unsigned long id;
+        std::mutex lock;
+
+        slab_pool(const slab_pool&);
+        slab_pool& operator=(const slab_pool&);
+
+        // Live thread-safe pools by id, used to tell whether a cache's pool still exists.
+        static std::mutex& registry_lock() {
+            static std::mutex lock;
+            return lock;
+        }
+
+        static std::unordered_map<unsigned long, slab_pool*>& registry() {
+            static std::unordered_map<unsigned long, slab_pool*> pools;
+            return pools;
+        }
+
+        static unsigned long next_id() {
+            static std::atomic<unsigned long> counter(1UL);
+            return counter.fetch_add(1UL);
+        }
+
+        static thread_cache& local_cache(unsigned long id) {
+            static thread_local thread_caches caches;
+            return caches.slots[id % SLAB_CACHE_SLOTS];
+        }
+
+        // Returns the blocks of 'cache' to their pool, or drops them if the pool is gone.
+        static void flush(thread_cache &cache) {
+
+            if (cache.pool_id && cache.count) {
+                std::lock_guard<std::mutex> guard(registry_lock());
+                auto entry = registry().find(cache.pool_id);
+                if (entry != registry().end()) {
+                    slab_pool *pool = entry->second;
+                    std::lock_guard<std::mutex> pool_guard(pool->lock);
+                    while (cache.count) pool->push_block(cache.blocks[--cache.count]);
+                }
+            }
+            cache.pool_id = 0UL;
+            cache.count = 0UL;
+        }
+
+        // Returns this thread's cache for the pool, evicting another pool's cache if needed.
+        thread_cache& own_cache() {
+
+            thread_cache &cache = local_cache(this->id);
+            if (cache.pool_id != this->id) {
+                flush(cache);
+                cache.pool_id = this->id;
+            }
+            return cache;
+        }
+
+        // Dynamically allocate a slab of 'alloc_size' blocks and record it so
+        // that it can be released by 'trim' or the destructor.
+        void allocate_slab() {
+
+            slab new_slab;
+            new_slab.n_blocks = this->alloc_size;
+            new_slab.memory = (char*)slab_new(this->alloc_size * this->block_size, this->slab_align);
+            this->allocations.push_back(new_slab);
+            this->free_store = new_slab.memory;
+            this->blocks_remaining = this->alloc_size;
+            this->blocks_reserved += this->alloc_size;
+            this->alloc_size *= this->alloc_exp;
+        }
+
+        // Takes a block from the free list or the free store. The caller holds the lock.
+        void* pop_block() {
+
+            void *block;
+            if (this->released) {
+                block = this->released;
+                this->released = this->released->next;
+            } else {
+                if ( ! this->blocks_remaining ) allocate_slab();
+                block = this->free_store;
+                this->free_store += this->block_size;
+                this->blocks_remaining--;
+            }
+            if (++this->blocks_live > this->peak_blocks_live) this->peak_blocks_live = this->blocks_live;
+            return block;
+        }
+
+        // Puts a block on the free list. The caller holds the lock.
+        void push_block(void *block) {
+
+            free_block *node = (free_block*)block;
+            node->next = this->released;
+            this->released = node;
+            this->blocks_live--;
+        }
+
+    public:
+
+        slab_pool(size_t block_size, size_t alloc_size = 64, unsigned alloc_exp = 2, bool thread_safe = false)
+            : alloc_size(alloc_size), alloc_exp(alloc_exp), thread_safe(thread_safe)
+        {
+            // Every block must be able to hold a free list link.
+            this->block_size = std::max(block_size, sizeof(free_block));
+            this->slab_align = this->block_size & (~this->block_size + 1);
+            if ( ! this->alloc_size ) this->alloc_size = 1;
+            if (this->alloc_exp < 1) this->alloc_exp = 1;
+            this->free_store = NULL;
+            this->released = NULL;
+            this->blocks_remaining = 0UL;
+            this->blocks_reserved = this->blocks_live = this->peak_blocks_live = 0UL;
+            this->id = next_id();
+            if (thread_safe) {
+                std::lock_guard<std::mutex> guard(registry_lock());
+                registry()[this->id] = this;
+            }
+        }
+
+        // Release every slab. Blocks still in use become invalid.
+        ~slab_pool() {
+
+            if (this->thread_safe) {
+                {
+                    std::lock_guard<std::mutex> guard(registry_lock());
+                    registry().erase(this->id);
+                }
+                thread_cache &cache = local_cache(this->id);
+                if (cache.pool_id == this->id) cache.pool_id = cache.count = 0UL;
+            }
+            for (const auto &s : this->allocations) slab_delete(s.memory, this->slab_align);
+        }
+
+        size_t get_block_size() {
+            return this->block_size;
+        }
+
+        // Returns a block of 'block_size' bytes.
+        void* allocate() {
+
+            if ( ! this->thread_safe ) return pop_block();
+
+            thread_cache &cache = own_cache();
+            if ( ! cache.count ) {
+                std::lock_guard<std::mutex> guard(this->lock);
+                while (cache.count < SLAB_CACHE_BATCH) cache.blocks[cache.count++] = pop_block();
+            }
+            return cache.blocks[--cache.count];
+        }
+
+        // Returns 'block', previously obtained from 'allocate', to the pool.
+        void deallocate(void *block) {
+
+            if ( ! this->thread_safe ) {
+                push_block(block);
+                return;
+            }
+
+            thread_cache &cache = own_cache();
+            if (cache.count == SLAB_CACHE_BLOCKS) {
+                std::lock_guard<std::mutex> guard(this->lock);
+                while (cache.count > SLAB_CACHE_BLOCKS - SLAB_CACHE_BATCH) push_block(cache.blocks[--cache.count]);
+            }
+            cache.blocks[cache.count++] = block;
+        }
+
+        // Guarantees that the next 'n' blocks can be handed out with at most one
+        // more slab allocation. Leftover blocks of the current slab are moved onto
+        // the free list so that none of them are lost.
+        void reserve(size_t n) {
+
+            std::unique_lock<std::mutex> guard(this->lock, std::defer_lock);
+            if (this->thread_safe) guard.lock();
+
+            size_t n_free = this->blocks_remaining;
+            for (free_block *node = this->released; node && n_free < n; node = node->next) n_free++;
+            if (n_free >= n) return;
+
+            while (this->blocks_remaining) {
+                free_block *node = (free_block*)this->free_store;
+                node->next = this->released;
+                this->released = node;
+                this->free_store += this->block_size;
+                this->blocks_remaining--;
+            }
+            if (this->alloc_size < n - n_free) this->alloc_size = n - n_free;
+            allocate_slab();
+        }
+
+        // Returns every slab whose blocks are all free to the system, and returns
+        // the number of bytes released. Blocks parked in other threads' caches
+        // keep their slabs alive.
+        size_t trim() {
+
+            if (this->thread_safe) flush(local_cache(this->id));
+            std::unique_lock<std::mutex> guard(this->lock, std::defer_lock);
+            if (this->thread_safe) guard.lock();
+
+            // Sort the slabs by address so that each free block can be matched to its slab.
+            std::sort(this->allocations.begin(), this->allocations.end(),
+                [](const slab &a, const slab &b) { return a.memory < b.memory; });
+            std::vector<size_t> n_free(this->allocations.size(), 0UL);
+            auto slab_of = [this](const void *block) {
+                size_t lo = 0, hi = this->allocations.size();
+                while (hi - lo > 1) {
+                    size_t mid = (lo + hi) / 2;
+                    if ((const char*)block < this->allocations[mid].memory) hi = mid;
+                    else lo = mid;
+                }
+                return lo;
+            };
+
+            for (free_block *node = this->released; node; node = node->next) n_free[slab_of(node)]++;
+            if (this->blocks_remaining) n_free[slab_of(this->free_store)] += this->blocks_remaining;
+
+            // Rebuild the free list without the blocks of the slabs being released.
+            free_block *kept = NULL, *next_node;
+            for (free_block *node = this->released; node; node = next_node) {
+                next_node = node->next;
+                size_t s = slab_of(node);
+                if (n_free[s] != this->allocations[s].n_blocks) {
+                    node->next = kept;
+                    kept = node;
+                }
+            }
+            this->released = kept;
+
+            size_t bytes_released = 0UL, kept_slabs = 0UL;
+            for (size_t s = 0; s < this->allocations.size(); s++) {
+                slab &current = this->allocations[s];
+                if (n_free[s] == current.n_blocks) {
+                    if (this->blocks_remaining && this->free_store >= current.memory
+                        && this->free_store < current.memory + current.n_blocks * this->block_size) {
+                        this->free_store = NULL;
+                        this->blocks_remaining = 0UL;
+                    }
+                    bytes_released += current.n_blocks * this->block_size;
+                    this->blocks_reserved -= current.n_blocks;
+                    slab_delete(current.memory, this->slab_align);
+                } else {
+                    this->allocations[kept_slabs++] = current;
+                }
+            }
+            this->allocations.resize(kept_slabs);
+
+            return bytes_released;
+        }
+
+        slab_stats stats() {
+
+            std::unique_lock<std::mutex> guard(this->lock, std::defer_lock);
+            if (this->thread_safe) guard.lock();
+
+            slab_stats s;
+            s.bytes_reserved = this->blocks_reserved * this->block_size;
+            s.bytes_live = this->blocks_live * this->block_size;
+            s.peak_bytes_live = this->peak_blocks_live * this->block_size;
+            return s;
+        }
+};
+
+// Set of slab_pools, one per size class, that serves requests of any size.
+// Containers of different types can share one arena.
+class slab_arena
+{
+    private:
+
+        slab_pool *pools[SLAB_CLASSES];
+        // Bookkeeping for requests too large for any pool.
+        std::atomic<size_t> large_live, large_peak;
+
+        slab_arena(const slab_arena&);
+        slab_arena& operator=(const slab_arena&);
+
+        static size_t size_class(size_t bytes) {
+            if (bytes <= SLAB_SMALL_BLOCK) return bytes ? (bytes - 1) / SLAB_GRANULARITY : 0UL;
+            return SLAB_SMALL_BLOCK / SLAB_GRANULARITY + (bytes - SLAB_SMALL_BLOCK - 1) / SLAB_LINE;
+        }
+
+        // Block size of size class 'i'.
+        static size_t class_bytes(size_t i) {
+            if (i < SLAB_SMALL_BLOCK / SLAB_GRANULARITY) return (i + 1) * SLAB_GRANULARITY;
+            return SLAB_SMALL_BLOCK + (i + 1 - SLAB_SMALL_BLOCK / SLAB_GRANULARITY) * SLAB_LINE;
+        }
+
+        // Size of the blocks serving 'bytes' aligned to 'align', a power of 2.
+        static size_t block_bytes(size_t bytes, size_t align) {
+            return align > SLAB_GRANULARITY ? (bytes + align - 1) & ~(align - 1) : bytes;
+        }
+
+    public:
+
+        slab_arena(size_t alloc_size = 64, unsigned alloc_exp = 2, bool thread_safe = false)
+        {
+            for (size_t i = 0; i < SLAB_CLASSES; i++) {
+                this->pools[i] = new slab_pool(class_bytes(i), alloc_size, alloc_exp, thread_safe);
+            }
+            this->large_live.store(0UL);
+            this->large_peak.store(0UL);
+        }
+
+        ~slab_arena() {
+            for (size_t i = 0; i < SLAB_CLASSES; i++) delete this->pools[i];
+        }
+
+        // Returns 'bytes' bytes aligned to 'align', a power of 2.
+        void* allocate(size_t bytes, size_t align = SLAB_GRANULARITY) {
+
+            bytes = block_bytes(bytes, align);
+            if (bytes <= SLAB_MAX_BLOCK) return this->pools[size_class(bytes)]->allocate();
+
+            size_t live = this->large_live.fetch_add(bytes) + bytes;
+            size_t peak = this->large_peak.load();
+            while (live > peak && ! this->large_peak.compare_exchange_weak(peak, live));
+            return slab_new(bytes, align);
+        }
+
+        // Returns 'block', obtained from 'allocate' with the same 'bytes' and 'align'.
+        void deallocate(void *block, size_t bytes, size_t align = SLAB_GRANULARITY) {
+
+            bytes = block_bytes(bytes, align);
+            if (bytes <= SLAB_MAX_BLOCK) {
+                this->pools[size_class(bytes)]->deallocate(block);
+                return;
+            }
+            this->large_live.fetch_sub(bytes);
+            slab_delete(block, align);
+        }
+
+        // Prepares the pool serving 'bytes'-sized requests aligned to 'align' for 'n' more of them.
+        void reserve(size_t bytes, size_t n, size_t align = SLAB_GRANULARITY) {
+            bytes = block_bytes(bytes, align);
+            if (bytes <= SLAB_MAX_BLOCK) this->pools[size_class(bytes)]->reserve(n);
+        }
+
+        // Returns fully free slabs of every pool to the system.
+        size_t trim() {
+            size_t bytes_released = 0UL;
+            for (size_t i = 0; i < SLAB_CLASSES; i++) bytes_released += this->pools[i]->trim();
+            return bytes_released;
+        }
+
+        // Sums the statistics of every pool. The peak is the sum of the pools' peaks.
+        slab_stats stats() {
+
+            slab_stats total;
+            total.bytes_reserved = total.bytes_live = this->large_live.load();
+            total.peak_bytes_live = this->large_peak.load();
+            for (size_t i = 0; i < SLAB_CLASSES; i++) {
+                slab_stats s = this->pools[i]->stats();
+                total.bytes_reserved += s.bytes_reserved;
+                total.bytes_live += s.bytes_live;
+                total.peak_bytes_live += s.peak_bytes_live;
+            }
+            return total;
+        }
+};
+
+// Standard allocator backed by a slab_arena. Copies and rebound copies share
+// the arena; a default-constructed allocator gets a private one.
+template <typename T>
+class slab_allocator
+{
+    public:
+
+        typedef T value_type;
+
+        std::shared_ptr<slab_arena> arena;
+
+        slab_allocator()
+            : arena(std::make_shared<slab_arena>()) {}
+
+        // Private arena whose slabs start at 'alloc_size' blocks and grow by 'alloc_exp'.
+        slab_allocator(size_t alloc_size, unsigned alloc_exp)
+            : arena(std::make_shared<slab_arena>(alloc_size, alloc_exp)) {}
+
+        explicit slab_allocator(std::shared_ptr<slab_arena> arena)
+            : arena(arena) {}
+
+        template <typename U>
+        slab_allocator(const slab_allocator<U> &other)
+            : arena(other.arena) {}
+
+        T* allocate(size_t n) {
+            return (T*)this->arena->allocate(n * sizeof(T), alignof(T));
+        }
+
+        void deallocate(T *p, size_t n) {
+            this->arena->deallocate(p, n * sizeof(T), alignof(T));
+        }
+
+        // Prepares the arena for 'n' single-object allocations.
+        void reserve(size_t n) {
+            this->arena->reserve(sizeof(T), n, alignof(T));
+        }
+
+        size_t trim() {
+            return this->arena->trim();
+        }
+
+        slab_stats stats() {
+            return this->arena->stats();
+        }
+};
+
+template <typename T, typename U>
+bool operator==(const slab_allocator<T> &a, const slab_allocator<U> &b) {
+    return a.arena == b.arena;
+}
+
+template <typename T, typename U>
+bool operator!=(const slab_allocator<T> &a, const slab_allocator<U> &b) {
+    return a.arena != b.arena;
+}
+
+// Hints to an allocator that 'n' single-object allocations are coming. Only
+// slab allocators act on the hint.
+template <typename Alloc>
+void reserve_blocks(Alloc&, size_t) {}
+
+template <typename T>
+void reserve_blocks(slab_allocator<T> &alloc, size_t n) {
+    alloc.reserve(n);
+}
+
+#endif /* SLAB_ALLOCATOR_H */
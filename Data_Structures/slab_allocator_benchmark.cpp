@@ -0,0 +1,110 @@
+#include "slab_allocator.h"
+#include "deque.h"
+#include "AVL_tree.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+// Returns the time in seconds taken by 'f'.
+template <typename F>
+double seconds(F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// A long-lived deque spikes to 'spike' items and drains again. Without trim
+// the memory of the spike stays reserved until the deque is destroyed.
+void spike() {
+
+    const size_t spike = 4000000UL;
+    auto arena = std::make_shared<slab_arena>(100, 2);
+    deque<size_t> deq( (slab_allocator<size_t>(arena)) );
+
+    for (size_t i = 0; i < spike; i++) deq.append(i);
+    slab_stats full = arena->stats();
+    while (deq.length() > 1000) deq.prepop();
+    slab_stats drained = arena->stats();
+    deq.shrink_to_fit();
+    double trim_s = seconds([&]() { arena->trim(); });
+    slab_stats trimmed = arena->stats();
+
+    std::cout << "Spike to " << spike << " items, drain to 1000:" << std::endl;
+    std::cout << "  reserved at peak " << full.bytes_reserved / 1e6 << " MB, after drain "
+              << drained.bytes_reserved / 1e6 << " MB, after shrink_to_fit + trim "
+              << trimmed.bytes_reserved / 1e6 << " MB (trim took " << trim_s * 1e3 << " ms)" << std::endl;
+}
+
+// Builds and tears down 'rounds' short-lived deques and trees.
+template <typename DequeFactory, typename TreeFactory>
+double churn(DequeFactory make_deque, TreeFactory make_tree) {
+
+    const size_t rounds = 2000UL, n = 1000UL;
+    static double values[1000];
+    return seconds([&]() {
+        for (size_t r = 0; r < rounds; r++) {
+            auto deq = make_deque();
+            auto tree = make_tree();
+            for (size_t i = 0; i < n; i++) {
+                deq->append(i);
+                tree->insert((int)((i * 7919) % n), &values[i]);
+            }
+            delete deq;
+            delete tree;
+        }
+    });
+}
+
+// Every thread allocates and frees blocks of 'block' bytes in batches through 'arena'.
+double thread_scaling(slab_arena *arena, unsigned n_threads) {
+
+    const size_t per_thread = 4000000UL, batch = 256UL, block = 32UL;
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < n_threads; t++) {
+        threads.emplace_back([arena]() {
+            void *blocks[batch];
+            for (size_t i = 0; i < per_thread; i += batch) {
+                for (size_t j = 0; j < batch; j++) blocks[j] = arena ? arena->allocate(block) : ::operator new(block);
+                for (size_t j = 0; j < batch; j++) {
+                    if (arena) arena->deallocate(blocks[j], block);
+                    else ::operator delete(blocks[j]);
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) thread.join();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return 2.0 * per_thread * n_threads / elapsed / 1e6;
+}
+
+int main() {
+
+    spike();
+
+    std::cout << "Churn of 2000 deques and trees of 1000 items:" << std::endl;
+    double private_s = churn(
+        []() { return new deque<size_t>(100, 2); },
+        []() { return new AVL_tree<int, double>(10, 2); });
+    auto arena = std::make_shared<slab_arena>(100, 2);
+    double shared_s = churn(
+        [&arena]() { return new deque<size_t>( (slab_allocator<size_t>(arena)) ); },
+        [&arena]() { return new AVL_tree<int, double>( (slab_allocator< bt_node<int, double> >(arena)) ); });
+    double malloc_s = churn(
+        []() { return new deque< size_t, std::allocator<size_t> >( (std::allocator<size_t>()) ); },
+        []() { return new AVL_tree< int, double, std::allocator< bt_node<int, double> > >( (std::allocator< bt_node<int, double> >()) ); });
+    slab_stats s = arena->stats();
+    std::cout << "  private arenas " << private_s * 1e3 << " ms, shared arena " << shared_s * 1e3
+              << " ms, std::allocator " << malloc_s * 1e3 << " ms" << std::endl;
+    std::cout << "  shared arena reserved " << s.bytes_reserved / 1e3 << " kB, peak live "
+              << s.peak_bytes_live / 1e3 << " kB" << std::endl;
+
+    unsigned max_threads = std::max(2U, std::thread::hardware_concurrency());
+    std::cout << "threads  thread-safe arena  operator new  (M allocations+frees/s)" << std::endl;
+    for (unsigned n_threads = 1; n_threads <= max_threads; n_threads *= 2) {
+        slab_arena shared_arena(1024, 2, true);
+        double arena_rate = thread_scaling(&shared_arena, n_threads);
+        double new_rate = thread_scaling(NULL, n_threads);
+        std::cout << n_threads << "        " << arena_rate << "            " << new_rate << std::endl;
+    }
+}
@@ -0,0 +1,73 @@
+#include "work_stealing.h"
+#include <iostream>
+
+// Number of items the owner pushes during the deque stress test.
+const long N_ITEMS = 1000000L;
+
+// The owner pushes items and pops some of them back while thieves steal from
+// the other end. Every item must be taken exactly once.
+bool stress_ws_deque(unsigned n_thieves) {
+
+    ws_deque<long> deq(16);
+    std::vector< std::atomic<int> > taken(N_ITEMS);
+    for (auto &count : taken) count.store(0);
+    std::atomic<bool> done(false);
+
+    std::vector<std::thread> thieves;
+    for (unsigned i = 0; i < n_thieves; i++) {
+        thieves.emplace_back([&]() {
+            long item;
+            while ( ! done.load() || deq.length() ) {
+                if (deq.try_steal(item)) taken[item]++;
+            }
+        });
+    }
+
+    long item;
+    for (long i = 0; i < N_ITEMS; i++) {
+        deq.append(i);
+        if (i % 3 == 0 && deq.try_pop(item)) taken[item]++;
+    }
+    while (deq.length()) {
+        if (deq.try_pop(item)) taken[item]++;
+    }
+    done.store(true);
+    for (auto &thief : thieves) thief.join();
+
+    for (auto &count : taken) {
+        if (count.load() != 1) return false;
+    }
+    return true;
+}
+
+// Recursive fork-join: each call splits its range in two and runs the halves as tasks.
+long parallel_sum(thread_pool &pool, long first, long last) {
+
+    if (last - first <= 1000) {
+        long sum = 0L;
+        for (long i = first; i < last; i++) sum += i;
+        return sum;
+    }
+    long mid = first + (last - first) / 2, sums[2];
+    pool.parallel_for(0, 2, 1, [&](size_t half, size_t) {
+        sums[half] = half ? parallel_sum(pool, mid, last) : parallel_sum(pool, first, mid);
+    });
+    return sums[0] + sums[1];
+}
+
+// For testing.
+int main() {
+
+    std::cout << "ws_deque 1 thief: " << (stress_ws_deque(1) ? "passed" : "FAILED") << std::endl;
+    std::cout << "ws_deque 4 thieves: " << (stress_ws_deque(4) ? "passed" : "FAILED") << std::endl;
+
+    thread_pool pool(4);
+
+    std::atomic<long> total(0L);
+    for (long i = 0; i < 10000; i++) pool.submit([&total, i]() { total += i; });
+    pool.wait();
+    std::cout << "Submitted tasks: " << (total == 10000L * 9999 / 2 ? "passed" : "FAILED") << std::endl;
+
+    long n = 10000000L;
+    std::cout << "Fork-join sum: " << (parallel_sum(pool, 0, n) == n * (n - 1) / 2 ? "passed" : "FAILED") << std::endl;
+}
@@ -0,0 +1,312 @@
+#ifndef WORK_STEALING_H
+#define WORK_STEALING_H
+
+#include "deque.h"
+#include "concurrent_queue.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+// Circular array of atomic slots used by ws_deque. Indices grow without bound
+// and are wrapped with a mask.
+template <typename T>
+struct ws_array {
+    long capacity, mask;
+    std::atomic<T> *items;
+
+    ws_array(long capacity) : capacity(capacity), mask(capacity - 1) {
+        this->items = new std::atomic<T>[capacity];
+    }
+
+    ~ws_array() {
+        delete[] this->items;
+    }
+
+    T get(long index) {
+        return this->items[index & this->mask].load(std::memory_order_relaxed);
+    }
+
+    void put(long index, T item) {
+        this->items[index & this->mask].store(item, std::memory_order_relaxed);
+    }
+};
+
+// Chase-Lev work-stealing deque. The owner thread appends and pops at the tail
+// like a stack, while any number of thieves steal from the head. 'T' must be
+// trivially copyable; in practice it is a pointer to a task.
+template <typename T>
+class ws_deque
+{
+    private:
+
+        // Index one past the last item. Only written by the owner.
+        alignas(CACHE_LINE) std::atomic<long> bottom;
+        // Index of the first item. Advanced by thieves and by the owner when
+        // it races a thief for the last item.
+        alignas(CACHE_LINE) std::atomic<long> top;
+        alignas(CACHE_LINE) std::atomic< ws_array<T>* > array;
+        // Arrays replaced by 'grow'. Thieves may still be reading them, so they
+        // are kept until destruction, the same way 'deque' keeps its allocations.
+        slp_node< ws_array<T> > *retired;
+
+        ws_deque(const ws_deque<T>&);
+        ws_deque<T>& operator=(const ws_deque<T>&);
+
+        // Double the capacity of the array, copying the live items [t, b).
+        ws_array<T>* grow(ws_array<T> *old_array, long t, long b) {
+
+            ws_array<T> *new_array = new ws_array<T>(old_array->capacity * 2);
+            for (long i = t; i < b; i++) new_array->put(i, old_array->get(i));
+
+            slp_node< ws_array<T> > *store_node = new slp_node< ws_array<T> >;
+            store_node->item = old_array;
+            store_node->next = this->retired;
+            this->retired = store_node;
+
+            this->array.store(new_array, std::memory_order_release);
+            return new_array;
+        }
+
+    public:
+
+        ws_deque(long capacity = 256)
+        {
+            // Round the capacity up to a power of 2.
+            long rounded = 1L;
+            while (rounded < capacity) rounded <<= 1;
+            this->array.store(new ws_array<T>(rounded), std::memory_order_relaxed);
+            this->top.store(0L, std::memory_order_relaxed);
+            this->bottom.store(0L, std::memory_order_relaxed);
+            this->retired = NULL;
+        }
+
+        ~ws_deque() {
+
+            delete this->array.load(std::memory_order_relaxed);
+
+            slp_node< ws_array<T> > *next_node, *current_node = this->retired;
+            while ( current_node ) {
+                next_node = current_node->next;
+                delete current_node->item;
+                delete current_node;
+                current_node = next_node;
+            }
+        }
+
+        // Places 'item' at the tail. Must only be called by the owner.
+        void append(T item) {
+
+            long b = this->bottom.load(std::memory_order_relaxed);
+            long t = this->top.load(std::memory_order_acquire);
+            ws_array<T> *a = this->array.load(std::memory_order_relaxed);
+            if (b - t > a->capacity - 1) a = grow(a, t, b);
+            a->put(b, item);
+            std::atomic_thread_fence(std::memory_order_release);
+            this->bottom.store(b + 1, std::memory_order_relaxed);
+        }
+
+        // Removes the item at the tail and stores it in 'item'. Returns false
+        // if the deque is empty. Must only be called by the owner.
+        bool try_pop(T &item) {
+
+            long b = this->bottom.load(std::memory_order_relaxed) - 1;
+            ws_array<T> *a = this->array.load(std::memory_order_relaxed);
+            this->bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            long t = this->top.load(std::memory_order_relaxed);
+
+            if (t > b) {
+                // Empty.
+                this->bottom.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+
+            item = a->get(b);
+            if (t == b) {
+                // Last item: race any thieves for it.
+                bool won = this->top.compare_exchange_strong(t, t + 1,
+                    std::memory_order_seq_cst, std::memory_order_relaxed);
+                this->bottom.store(b + 1, std::memory_order_relaxed);
+                return won;
+            }
+            return true;
+        }
+
+        // Removes the item at the head and stores it in 'item'. Returns false
+        // if the deque is empty or another thread took the item first. May be
+        // called from any thread.
+        bool try_steal(T &item) {
+
+            long t = this->top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            long b = this->bottom.load(std::memory_order_acquire);
+            if (t >= b) return false;
+
+            ws_array<T> *a = this->array.load(std::memory_order_acquire);
+            item = a->get(t);
+            return this->top.compare_exchange_strong(t, t + 1,
+                std::memory_order_seq_cst, std::memory_order_relaxed);
+        }
+
+        // Returns an estimate of the number of elements in the deque.
+        size_t length() {
+            long b = this->bottom.load(std::memory_order_relaxed);
+            long t = this->top.load(std::memory_order_relaxed);
+            return b > t ? (size_t)(b - t) : 0UL;
+        }
+};
+
+// Fixed-size pool of worker threads, each owning a ws_deque of tasks. Tasks
+// submitted from a worker go onto that worker's own deque; tasks submitted from
+// outside the pool go through a shared mpmc_queue. Idle workers steal from
+// the head of a victim's deque.
+class thread_pool
+{
+    private:
+
+        typedef std::function<void()> task;
+
+        std::vector<std::thread> workers;
+        std::vector< ws_deque<task*>* > deques;
+        mpmc_queue<task*> injection;
+        // Number of submitted tasks that have not finished yet.
+        alignas(CACHE_LINE) std::atomic<size_t> pending;
+        std::atomic<bool> stopping;
+
+        // Pool and index of the worker running on the calling thread.
+        static thread_pool*& worker_pool() {
+            static thread_local thread_pool *pool = NULL;
+            return pool;
+        }
+
+        static int& worker_index() {
+            static thread_local int index = -1;
+            return index;
+        }
+
+        // Index of the calling thread among this pool's workers, or -1 if it is not one of them.
+        int own_index() {
+            return worker_pool() == this ? worker_index() : -1;
+        }
+
+        thread_pool(const thread_pool&);
+        thread_pool& operator=(const thread_pool&);
+
+        // Finds a task for worker 'self': its own deque first, then the
+        // injection queue, then the other workers' deques.
+        bool find_task(unsigned self, task *&t, unsigned &victim) {
+
+            if (this->deques[self]->try_pop(t)) return true;
+            if (this->injection.try_pop(t)) return true;
+            for (size_t i = 0; i < this->deques.size(); i++) {
+                victim = (victim + 1) % this->deques.size();
+                if (victim != self && this->deques[victim]->try_steal(t)) return true;
+            }
+            return false;
+        }
+
+        void run_task(task *t) {
+            (*t)();
+            delete t;
+            this->pending.fetch_sub(1, std::memory_order_release);
+        }
+
+        // Spins until 'counter' reaches zero. A worker keeps executing tasks
+        // while it waits so that nested waits cannot starve the pool.
+        void help_until(std::atomic<size_t> &counter) {
+
+            int self = own_index();
+            unsigned victim = self >= 0 ? (unsigned)self : 0U;
+            task *t;
+            while (counter.load(std::memory_order_acquire)) {
+                if (self >= 0 && find_task((unsigned)self, t, victim)) run_task(t);
+                else std::this_thread::yield();
+            }
+        }
+
+        void worker_loop(unsigned self) {
+
+            worker_pool() = this;
+            worker_index() = (int)self;
+            unsigned victim = self, idle_rounds = 0;
+            task *t;
+            while ( ! this->stopping.load(std::memory_order_acquire) ) {
+                if (find_task(self, t, victim)) {
+                    run_task(t);
+                    idle_rounds = 0;
+                } else if (++idle_rounds < 64) {
+                    std::this_thread::yield();
+                } else {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+            }
+        }
+
+    public:
+
+        thread_pool(unsigned n_threads = std::thread::hardware_concurrency())
+            : injection(4096)
+        {
+            if ( ! n_threads ) n_threads = 1;
+            this->pending.store(0UL, std::memory_order_relaxed);
+            this->stopping.store(false, std::memory_order_relaxed);
+            for (unsigned i = 0; i < n_threads; i++) this->deques.push_back(new ws_deque<task*>());
+            for (unsigned i = 0; i < n_threads; i++) {
+                this->workers.emplace_back(&thread_pool::worker_loop, this, i);
+            }
+        }
+
+        // Waits for all submitted tasks and joins the workers.
+        ~thread_pool() {
+            wait();
+            this->stopping.store(true, std::memory_order_release);
+            for (auto &worker : this->workers) worker.join();
+            for (auto deq : this->deques) delete deq;
+        }
+
+        size_t size() {
+            return this->workers.size();
+        }
+
+        // Schedules 'f' to run on one of the workers.
+        void submit(std::function<void()> f) {
+
+            task *t = new task(std::move(f));
+            this->pending.fetch_add(1, std::memory_order_relaxed);
+            int self = own_index();
+            if (self >= 0) {
+                this->deques[self]->append(t);
+                return;
+            }
+            while ( ! this->injection.try_push(t) ) std::this_thread::yield();
+        }
+
+        // Blocks until every submitted task has finished. Must not be called
+        // from inside a task, since the calling task itself is still pending;
+        // use parallel_for to wait on sub-tasks instead.
+        void wait() {
+            help_until(this->pending);
+        }
+
+        // Calls 'f(first, last)' on disjoint sub-ranges of [begin, end) of at
+        // most 'grain' indices each and returns once all of them have finished.
+        // May be called from inside a task.
+        void parallel_for(size_t begin, size_t end, size_t grain, std::function<void(size_t, size_t)> f) {
+
+            if ( ! grain ) grain = 1;
+            std::atomic<size_t> remaining((end - begin + grain - 1) / grain);
+            for (size_t first = begin; first < end; first += grain) {
+                size_t last = std::min(end, first + grain);
+                submit([&f, &remaining, first, last]() {
+                    f(first, last);
+                    remaining.fetch_sub(1, std::memory_order_release);
+                });
+            }
+            help_until(remaining);
+        }
+};
+
+#endif /* WORK_STEALING_H */
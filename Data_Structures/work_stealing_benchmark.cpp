@@ -0,0 +1,120 @@
+#include "work_stealing.h"
+#include <mutex>
+
+// Number of tasks executed in each run.
+const size_t N_TASKS = 1000000UL;
+// Number of children each root task spawns in the nested run.
+const size_t FAN_OUT = 100UL;
+
+// Pool of workers sharing one mutex-protected deque of tasks.
+class locked_pool
+{
+    private:
+
+        typedef std::function<void()> task;
+
+        std::vector<std::thread> workers;
+        deque<task*> tasks;
+        std::mutex lock;
+        std::atomic<size_t> pending;
+        std::atomic<bool> stopping;
+
+        void worker_loop() {
+
+            while ( ! this->stopping.load(std::memory_order_acquire) ) {
+                task *t = NULL;
+                {
+                    std::lock_guard<std::mutex> guard(this->lock);
+                    if (this->tasks.length()) t = this->tasks.prepop();
+                }
+                if ( ! t ) { std::this_thread::yield(); continue; }
+                (*t)();
+                delete t;
+                this->pending.fetch_sub(1, std::memory_order_release);
+            }
+        }
+
+    public:
+
+        locked_pool(unsigned n_threads) : tasks(1024, 2) {
+            this->pending.store(0UL); this->stopping.store(false);
+            for (unsigned i = 0; i < n_threads; i++) this->workers.emplace_back(&locked_pool::worker_loop, this);
+        }
+
+        ~locked_pool() {
+            wait();
+            this->stopping.store(true, std::memory_order_release);
+            for (auto &worker : this->workers) worker.join();
+        }
+
+        void submit(std::function<void()> f) {
+            task *t = new task(std::move(f));
+            this->pending.fetch_add(1, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> guard(this->lock);
+            this->tasks.append(t);
+        }
+
+        void wait() {
+            while (this->pending.load(std::memory_order_acquire)) std::this_thread::yield();
+        }
+};
+
+// A small amount of work per task so that scheduling overhead dominates.
+void tiny_task(std::atomic<size_t> &counter) {
+    volatile size_t x = 0;
+    for (size_t i = 0; i < 50; i++) x += i;
+    counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Submits every task from the main thread. Returns millions of tasks per second.
+template <typename P>
+double run_flat(P &pool) {
+
+    std::atomic<size_t> counter(0UL);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < N_TASKS; i++) pool.submit([&counter]() { tiny_task(counter); });
+    pool.wait();
+    auto end = std::chrono::steady_clock::now();
+
+    return counter / std::chrono::duration<double>(end - start).count() / 1e6;
+}
+
+// Submits root tasks that each spawn 'FAN_OUT' children from inside the pool,
+// which is where per-worker deques avoid the shared queue entirely.
+template <typename P>
+double run_nested(P &pool) {
+
+    std::atomic<size_t> counter(0UL);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < N_TASKS / FAN_OUT; i++) {
+        pool.submit([&pool, &counter]() {
+            for (size_t j = 0; j < FAN_OUT; j++) pool.submit([&counter]() { tiny_task(counter); });
+        });
+    }
+    pool.wait();
+    auto end = std::chrono::steady_clock::now();
+
+    return counter / std::chrono::duration<double>(end - start).count() / 1e6;
+}
+
+int main() {
+
+    unsigned max_threads = std::max(2U, std::thread::hardware_concurrency());
+
+    std::cout << "threads  locked flat  stealing flat  locked nested  stealing nested  (M tasks/s)" << std::endl;
+    for (unsigned n_threads = 1; n_threads <= max_threads; n_threads *= 2) {
+        double locked_flat, locked_nested, stealing_flat, stealing_nested;
+        {
+            locked_pool pool(n_threads);
+            locked_flat = run_flat(pool);
+            locked_nested = run_nested(pool);
+        }
+        {
+            thread_pool pool(n_threads);
+            stealing_flat = run_flat(pool);
+            stealing_nested = run_nested(pool);
+        }
+        std::cout << n_threads << "        " << locked_flat << "      " << stealing_flat << "        "
+                  << locked_nested << "        " << stealing_nested << std::endl;
+    }
+}
@@ -6,4 +6,9 @@
 void _mm256_print_ps(__m256* vec);
 void _mm256_print_si256(__m256i* vec);
 
+//Horizontal reductions of a register to a scalar.
+float _mm256_reduce_min_ps(__m256* vec);
+float _mm256_reduce_max_ps(__m256* vec);
+double _mm256_reduce_add_pd(__m256d* vec);
+
 #endif /* mm256_PRINT_H */
\ No newline at end of file
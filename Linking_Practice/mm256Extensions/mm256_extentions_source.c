@@ -26,4 +26,30 @@ void _mm256_print_si256(__m256i* vec)
     }
     printf("\n");
     free(elem);
+}
+
+//Smallest of 8 fp32. The halves are folded together until one lane is left.
+float _mm256_reduce_min_ps(__m256* vec)
+{
+    __m128 folded = _mm_min_ps(_mm256_castps256_ps128(*vec), _mm256_extractf128_ps(*vec, 1));
+    folded = _mm_min_ps(folded, _mm_movehl_ps(folded, folded));
+    folded = _mm_min_ss(folded, _mm_shuffle_ps(folded, folded, 1));
+    return _mm_cvtss_f32(folded);
+}
+
+//Largest of 8 fp32.
+float _mm256_reduce_max_ps(__m256* vec)
+{
+    __m128 folded = _mm_max_ps(_mm256_castps256_ps128(*vec), _mm256_extractf128_ps(*vec, 1));
+    folded = _mm_max_ps(folded, _mm_movehl_ps(folded, folded));
+    folded = _mm_max_ss(folded, _mm_shuffle_ps(folded, folded, 1));
+    return _mm_cvtss_f32(folded);
+}
+
+//Sum of 4 fp64.
+double _mm256_reduce_add_pd(__m256d* vec)
+{
+    __m128d folded = _mm_add_pd(_mm256_castpd256_pd128(*vec), _mm256_extractf128_pd(*vec, 1));
+    folded = _mm_add_sd(folded, _mm_unpackhi_pd(folded, folded));
+    return _mm_cvtsd_f64(folded);
 }
\ No newline at end of file
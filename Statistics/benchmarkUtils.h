@@ -0,0 +1,58 @@
+#ifndef BENCHMARKUTILS_H
+#define BENCHMARKUTILS_H
+
+#include "rvGeneration.h"
+#include<time.h>
+
+//Helpers shared by the benchmarks.
+
+static inline double seconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+//Distribution functions; params holds the parameters passed to the generators.
+static inline double uniformCDF(double x, const double* params)
+{   return x <= params[0] ? 0.0 : (x >= params[1] ? 1.0 : (x - params[0]) / (params[1] - params[0]));   }
+
+static inline double exponentialCDF(double x, const double* params)
+{   return x <= 0.0 ? 0.0 : 1.0 - exp(-x / params[0]); }
+
+static inline double normalCDF(double x, const double* params)
+{   return 0.5 * erfc((params[0] - x) / (params[1] * M_SQRT2));   }
+
+//One line of moments and KS statistic d of n samples, with the expected
+//moments in brackets unless expected_p is NULL.
+static inline void printMoments(const char* label, const rv_moments_t* moments_p, const rv_moments_t* expected_p, const double d, const size_t n)
+{
+    if (expected_p == NULL)
+    {
+        printf("  %-10s mean %9.5f, variance %9.5f, skewness %7.4f, kurtosis %7.4f, KS D %.5f, p %.3f \n", label,
+               moments_p->mean, moments_p->variance, moments_p->skewness, moments_p->kurtosis, d, rv_ksPValue(d, n));
+        return;
+    }
+    printf("  %-10s mean %9.5f (%9.5f), variance %9.5f (%9.5f), skewness %7.4f (%7.4f), kurtosis %7.4f (%7.4f), KS D %.5f, p %.3f \n",
+           label, moments_p->mean, expected_p->mean, moments_p->variance, expected_p->variance, moments_p->skewness,
+           expected_p->skewness, moments_p->kurtosis, expected_p->kurtosis, d, rv_ksPValue(d, n));
+}
+
+//Moments and KS test of n samples in buf against cdf, which is called with
+//params. Sorts the samples.
+static inline void printQuality(const char* label, float* buf, const size_t n, double (*cdf)(double, const double*),
+                                const double* params, const rv_moments_t* expected_p)
+{
+    const rv_moments_t moments = rv_sampleMoments(buf, n);
+    printMoments(label, &moments, expected_p, rv_ksStatistic(buf, n, cdf, params), n);
+}
+
+//The same for samples of a discrete distribution, whose cdf is a step function.
+static inline void printDiscreteQuality(const char* label, float* buf, const size_t n, double (*cdf)(double, const double*),
+                                        const double* params, const rv_moments_t* expected_p)
+{
+    const rv_moments_t moments = rv_sampleMoments(buf, n);
+    printMoments(label, &moments, expected_p, rv_ksDiscreteStatistic(buf, n, cdf, params), n);
+}
+
+#endif /* BENCHMARKUTILS_H */
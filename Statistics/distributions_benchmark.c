@@ -0,0 +1,286 @@
+#include "benchmarkUtils.h"
+#include<string.h>
+
+#define QUALITY_SAMPLES (1 << 20)
+#define N_DISTS 7
+#define MULTI_DIM 4
+
+//Regularised lower incomplete gamma P(a, x), by its series below a + 1 and its
+//continued fraction above.
+static double incompleteGamma(const double a, const double x)
+{
+    if (x <= 0.0)
+    {   return 0.0; }
+    const double logPrefix = a * log(x) - x - lgamma(a);
+    if (x < a + 1.0)
+    {
+        double term = 1.0 / a, sum = term;
+        for (int k = 1; k < 1000 && fabs(term) > 1e-16 * sum; k++)
+        {
+            term *= x / (a + k);
+            sum += term;
+        }
+        return sum * exp(logPrefix);
+    }
+    double b = x + 1.0 - a, c = 1e300, d = 1.0 / b, h = d;
+    for (int k = 1; k < 1000; k++)
+    {
+        const double an = -k * (k - a);
+        b += 2.0;
+        d = an * d + b;
+        d = fabs(d) < 1e-300 ? 1e-300 : d;
+        c = b + an / c;
+        c = fabs(c) < 1e-300 ? 1e-300 : c;
+        d = 1.0 / d;
+        h *= d * c;
+        if (fabs(d * c - 1.0) < 1e-16)
+        {   break;  }
+    }
+    return 1.0 - exp(logPrefix) * h;
+}
+
+//Continued fraction of the regularised incomplete beta, as in Numerical Recipes.
+static double betaFraction(const double a, const double b, const double x)
+{
+    double c = 1.0, d = 1.0 - (a + b) * x / (a + 1.0);
+    d = fabs(d) < 1e-300 ? 1e-300 : d;
+    d = 1.0 / d;
+    double h = d;
+    for (int m = 1; m < 1000; m++)
+    {
+        for (int odd = 0; odd < 2; odd++)
+        {
+            const double an = odd ? -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1))
+                                  : m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m));
+            d = 1.0 + an * d;
+            d = fabs(d) < 1e-300 ? 1e-300 : d;
+            c = 1.0 + an / c;
+            c = fabs(c) < 1e-300 ? 1e-300 : c;
+            d = 1.0 / d;
+            h *= d * c;
+        }
+        if (fabs(d * c - 1.0) < 1e-16)
+        {   break;  }
+    }
+    return h;
+}
+
+//Regularised incomplete beta I_x(a, b).
+static double incompleteBeta(const double a, const double b, const double x)
+{
+    if (x <= 0.0 || x >= 1.0)
+    {   return x <= 0.0 ? 0.0 : 1.0;    }
+    const double front = exp(lgamma(a + b) - lgamma(a) - lgamma(b) + a * log(x) + b * log(1.0 - x));
+    if (x < (a + 1.0) / (a + b + 2.0))
+    {   return front * betaFraction(a, b, x) / a;   }
+    return 1.0 - front * betaFraction(b, a, 1.0 - x) / b;
+}
+
+//Distribution functions; params holds the parameters passed to the fills.
+static double gammaCDF(double x, const double* params)
+{   return incompleteGamma(params[0], x / params[1]);  }
+
+static double betaCDF(double x, const double* params)
+{   return incompleteBeta(params[0], params[1], x); }
+
+static double poissonCDF(double k, const double* params)
+{   return k < 0.0 ? 0.0 : 1.0 - incompleteGamma(floor(k) + 1.0, params[0]);  }
+
+static double binomialCDF(double k, const double* params)
+{
+    k = floor(k);
+    return k < 0.0 ? 0.0 : (k >= params[0] ? 1.0 : incompleteBeta(params[0] - k, k + 1.0, 1.0 - params[1]));
+}
+
+static double logNormalCDF(double x, const double* params)
+{   return x <= 0.0 ? 0.0 : 0.5 * erfc((params[0] - log(x)) / (params[1] * M_SQRT2));  }
+
+//The same distributions a variate per call from rand(), the way they would be
+//drawn without the fills.
+static float naiveGamma(const float shape, const float scale)
+{
+    const float d = (shape < 1.0f ? shape + 1.0f : shape) - 1.0f / 3.0f, c = 1.0f / sqrtf(9.0f * d);
+    while (true)
+    {
+        const float x = f32_normal(0.0f, 1.0f), u = f32_uniform(0.0f, 1.0f);
+        float v = 1.0f + c * x;
+        if (v <= 0.0f)
+        {   continue;   }
+        v = v * v * v;
+        if (u > 0.0f && logf(u) < 0.5f * x * x + d * (1.0f - v + logf(v)))
+        {   return d * v * scale * (shape < 1.0f ? powf(f32_uniform(0.0f, 1.0f), 1.0f / shape) : 1.0f);  }
+    }
+}
+
+//Knuth's product of uniforms.
+static float naivePoisson(const float lambda)
+{
+    const float limit = expf(-lambda);
+    float product = f32_uniform(0.0f, 1.0f), k = 0.0f;
+    while (product > limit)
+    {
+        product *= f32_uniform(0.0f, 1.0f);
+        k += 1.0f;
+    }
+    return k;
+}
+
+//A sum of Bernoulli trials.
+static float naiveBinomial(const unsigned trials, const float p)
+{
+    float k = 0.0f;
+    for (unsigned t = 0; t < trials; t++)
+    {   k += f32_uniform(0.0f, 1.0f) < p;  }
+    return k;
+}
+
+typedef struct distribution
+{
+    const char* name;
+    rv_distribution_t dist;
+    float params[2];
+    double (*cdf)(double, const double*);
+    bool discrete;
+    //mean, variance, skewness and excess kurtosis
+    rv_moments_t expected;
+} distribution_t;
+
+static void naiveFill(const distribution_t* dist_p, float* buf, const size_t n)
+{
+    const float p0 = dist_p->params[0], p1 = dist_p->params[1];
+    for (size_t i = 0; i < n; i++)
+    {
+        switch (dist_p->dist)
+        {
+            case RV_GAMMA: *(buf + i) = naiveGamma(p0, p1); break;
+            case RV_BETA:
+            {
+                const float ga = naiveGamma(p0, 1.0f);
+                *(buf + i) = ga / (ga + naiveGamma(p1, 1.0f));
+                break;
+            }
+            case RV_POISSON: *(buf + i) = naivePoisson(p0); break;
+            case RV_BINOMIAL: *(buf + i) = naiveBinomial((unsigned)p0, p1); break;
+            default: *(buf + i) = expf(f32_normal(p0, p1)); break;
+        }
+    }
+}
+
+static void printDistributionQuality(const char* label, float* buf, const size_t n, const distribution_t* dist_p)
+{
+    const double params[] = { dist_p->params[0], dist_p->params[1] };
+    (dist_p->discrete ? printDiscreteQuality : printQuality)(label, buf, n, dist_p->cdf, params, &dist_p->expected);
+}
+
+//Sample means and covariances of n draws of a multivariate normal against mu
+//and cov, and the KS test of each coordinate against its marginal.
+static void multiNormalQuality(const size_t n)
+{
+    const float mu[MULTI_DIM] = { 1.0f, -2.0f, 0.0f, 5.0f };
+    const double cov[MULTI_DIM * MULTI_DIM] = {
+        4.0, 1.2, -0.8, 0.5,
+        1.2, 1.0, 0.3, 0.0,
+        -0.8, 0.3, 2.0, -0.6,
+        0.5, 0.0, -0.6, 0.5
+    };
+    double lower[MULTI_DIM * MULTI_DIM];
+    if (!rv_cholesky(cov, MULTI_DIM, lower))
+    {
+        printf("Covariance matrix not positive definite \n");
+        exit(1);
+    }
+    float* out = (float*)malloc(sizeof(float) * n * MULTI_DIM);
+    rv_generator_t gen;
+    rv_seed(&gen, 9999);
+    f32_multiNormalFill(&gen, out, n, n, MULTI_DIM, mu, lower);
+
+    double means[MULTI_DIM], meanError = 0.0, covError = 0.0;
+    for (size_t i = 0; i < MULTI_DIM; i++)
+    {
+        means[i] = rv_sampleMoments(out + i * n, n).mean;
+        meanError = fabs(means[i] - mu[i]) > meanError ? fabs(means[i] - mu[i]) : meanError;
+    }
+    for (size_t i = 0; i < MULTI_DIM; i++)
+    {
+        for (size_t j = 0; j <= i; j++)
+        {
+            double sum = 0.0;
+            for (size_t r = 0; r < n; r++)
+            {   sum += (*(out + i * n + r) - means[i]) * (*(out + j * n + r) - means[j]);    }
+            const double error = fabs(sum / (n - 1) - cov[i * MULTI_DIM + j]);
+            covError = error > covError ? error : covError;
+        }
+    }
+    printf("multivariate normal, %d dimensions \n  largest error of a mean %.5f, of a covariance %.5f \n  KS p of the marginals:",
+           MULTI_DIM, meanError, covError);
+    for (size_t i = 0; i < MULTI_DIM; i++)
+    {
+        const double params[] = { mu[i], sqrt(cov[i * MULTI_DIM + i]) };
+        const double d = rv_ksStatistic(out + i * n, n, normalCDF, params);
+        printf(" %.3f", rv_ksPValue(d, n));
+    }
+    printf(" \n");
+    free(out);
+}
+
+//Takes the number of samples per fill as an optional argument.
+int main(int argc, char** argv)
+{
+    const size_t n = argc > 1 ? (size_t)atol(argv[1]) : 1 << 22;
+    const double lnMean = exp(0.125), lnSpread = exp(0.25) - 1.0;
+    const distribution_t dists[N_DISTS] = {
+        { "gamma(3, 2)", RV_GAMMA, { 3.0f, 2.0f }, gammaCDF, false, { 6.0, 12.0, 2.0 / sqrt(3.0), 2.0 } },
+        { "gamma(0.5, 1)", RV_GAMMA, { 0.5f, 1.0f }, gammaCDF, false, { 0.5, 0.5, 2.0 / sqrt(0.5), 12.0 } },
+        { "beta(2, 5)", RV_BETA, { 2.0f, 5.0f }, betaCDF, false, { 2.0 / 7.0, 10.0 / 392.0, 6.0 * sqrt(8.0) / (9.0 * sqrt(10.0)), -0.12 } },
+        { "Poisson(4)", RV_POISSON, { 4.0f, 0.0f }, poissonCDF, true, { 4.0, 4.0, 0.5, 0.25 } },
+        { "Poisson(100)", RV_POISSON, { 100.0f, 0.0f }, poissonCDF, true, { 100.0, 100.0, 0.1, 0.01 } },
+        { "binomial(200, 0.3)", RV_BINOMIAL, { 200.0f, 0.3f }, binomialCDF, true, { 60.0, 42.0, 0.4 / sqrt(42.0), (1.0 - 6.0 * 0.21) / 42.0 } },
+        { "log-normal(0, 0.5)", RV_LOGNORMAL, { 0.0f, 0.5f }, logNormalCDF, false,
+          { lnMean, lnMean * lnMean * lnSpread, (lnSpread + 3.0) * sqrt(lnSpread), exp(1.0) + 2.0 * exp(0.75) + 3.0 * exp(0.5) - 6.0 } }
+    };
+    float* buf = (float*)malloc(sizeof(float) * (n > QUALITY_SAMPLES ? n : QUALITY_SAMPLES));
+    float* check = (float*)malloc(sizeof(float) * n);
+    rv_generator_t gen;
+
+    printf("Throughput, %zu samples, in millions of samples/s \n", n);
+    for (size_t d = 0; d < N_DISTS; d++)
+    {
+        srand(9999);
+        double start = seconds();
+        naiveFill(&dists[d], buf, n);
+        const double naiveTime = seconds() - start;
+
+        rv_useAVX2(false);
+        rv_seed(&gen, 9999);
+        start = seconds();
+        rv_fill(&gen, dists[d].dist, dists[d].params, check, n);
+        const double scalarTime = seconds() - start;
+
+        const bool avx2 = rv_useAVX2(true);
+        rv_seed(&gen, 9999);
+        start = seconds();
+        rv_fill(&gen, dists[d].dist, dists[d].params, buf, n);
+        const double avx2Time = seconds() - start;
+
+        printf("  %-20s rand(): %7.1f, scalar fill: %7.1f, AVX2 fill: %7.1f%s, %s \n", dists[d].name, n / naiveTime / 1e6,
+               n / scalarTime / 1e6, n / avx2Time / 1e6, avx2 ? "" : " (not supported)",
+               memcmp(buf, check, sizeof(float) * n) == 0 ? "same samples" : "SAMPLES DIFFER");
+    }
+
+    printf("Quality, %d samples, expected values in brackets \n", QUALITY_SAMPLES);
+    for (size_t d = 0; d < N_DISTS; d++)
+    {
+        printf("%s \n", dists[d].name);
+        srand(9999);
+        naiveFill(&dists[d], buf, QUALITY_SAMPLES);
+        printDistributionQuality("rand():", buf, QUALITY_SAMPLES, &dists[d]);
+        rv_seed(&gen, 9999);
+        rv_fill(&gen, dists[d].dist, dists[d].params, buf, QUALITY_SAMPLES);
+        printDistributionQuality("fill:", buf, QUALITY_SAMPLES, &dists[d]);
+    }
+    multiNormalQuality(QUALITY_SAMPLES);
+
+    free(buf);
+    free(check);
+    return 0;
+}
@@ -1,17 +1,19 @@
-#include<stdlib.h>
-#include<stdio.h>
-#include<math.h>
-
-static inline float f32_uniform(const float a, const float b)
-{   return ((float)rand() / (float)RAND_MAX * (b-a)) + a;  }
+#include "rvGeneration.h"
+#include "zigguratTables.h"
+#include<string.h>
+#include<unistd.h>
+#include<pthread.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include<immintrin.h>
+#endif
 
 float f32_exponential(const float alpha)
 {   return -1.0F * alpha * logf(f32_uniform(0, 1)); }
 
 float f32_normal(const float mu, const float sigma)
 {
-    static float n2;
-    static int generate = 1;
+    static _Thread_local float n2;
+    static _Thread_local int generate = 1;
 
     if (!generate)
     {
@@ -34,21 +36,1097 @@ float f32_normal(const float mu, const float sigma)
     return n1;
 }
 
-int main(void)
+static inline uint64_t rotl(const uint64_t x, const int k)
+{   return (x << k) | (x >> (64 - k));  }
+
+static uint64_t splitmix64(uint64_t* x_p)
+{
+    uint64_t z = (*x_p += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+//One step of lane l, returning its output.
+static inline uint64_t nextLane(uint64_t s[4][4], const size_t l)
+{
+    const uint64_t result = s[0][l] + s[3][l];
+    const uint64_t t = s[1][l] << 17;
+    s[2][l] ^= s[0][l];
+    s[3][l] ^= s[1][l];
+    s[1][l] ^= s[2][l];
+    s[0][l] ^= s[3][l];
+    s[2][l] ^= t;
+    s[3][l] = rotl(s[3][l], 45);
+    return result;
+}
+
+static const uint64_t shortJump[] = { 0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL };
+static const uint64_t longJump[] = { 0x76E15D3EFEFDCBBFULL, 0xC5004E441C522FB3ULL, 0x77710069854EE241ULL, 0x39109BB02ACBE635ULL };
+
+//Advance the lanes from first on by the number of steps that the polynomial
+//jump stands for.
+static void jumpLanes(uint64_t s[4][4], const size_t first, const uint64_t* jump)
+{
+    uint64_t jumped[4][4] = { { 0 } };
+    for (size_t i = 0; i < 4; i++)
+    {
+        for (int b = 0; b < 64; b++)
+        {
+            if (jump[i] & ((uint64_t)1 << b))
+            {
+                for (size_t w = 0; w < 4; w++)
+                {
+                    for (size_t l = first; l < 4; l++)
+                    {   jumped[w][l] ^= s[w][l];    }
+                }
+            }
+            for (size_t l = first; l < 4; l++)
+            {   nextLane(s, l); }
+        }
+    }
+    for (size_t w = 0; w < 4; w++)
+    {
+        for (size_t l = first; l < 4; l++)
+        {   s[w][l] = jumped[w][l]; }
+    }
+}
+
+void rv_seed(rv_generator_t* gen_p, const uint64_t seed)
+{
+    uint64_t x = seed;
+    for (size_t w = 0; w < 4; w++)
+    {   gen_p->s[w][0] = splitmix64(&x);    }
+    for (size_t w = 0; w < 4; w++)
+    {
+        for (size_t l = 1; l < 4; l++)
+        {   gen_p->s[w][l] = gen_p->s[w][0];    }
+    }
+    //Lane l is jumped l times.
+    for (size_t l = 1; l < 4; l++)
+    {   jumpLanes(gen_p->s, l, shortJump);  }
+}
+
+void rv_jump(rv_generator_t* gen_p)
+{   jumpLanes(gen_p->s, 0, shortJump);  }
+
+void rv_longJump(rv_generator_t* gen_p)
+{   jumpLanes(gen_p->s, 0, longJump);   }
+
+void rv_stream(rv_generator_t* gen_p, const uint64_t seed, const uint64_t streamId)
 {
-    srand(9999);
+    rv_seed(gen_p, seed);
+    for (uint64_t i = 0; i < streamId; i++)
+    {   rv_longJump(gen_p); }
+}
+
+//One step of the 4 lanes, as 8 32-bit halves in the order of an AVX2 register.
+static inline void scalarNext(uint64_t s[4][4], uint32_t* bits)
+{
+    for (size_t l = 0; l < 4; l++)
+    {
+        const uint64_t result = nextLane(s, l);
+        *(bits + 2 * l) = (uint32_t)result;
+        *(bits + 2 * l + 1) = (uint32_t)(result >> 32);
+    }
+}
 
-    for (size_t i = 0; i < 10; i++)
-    {   printf("%f ", f32_uniform(-1, 1));  }
-    printf("\n");
+//A float in (0, 1] from the upper 31 bits, offset by half a step so that it
+//is never 0. Small values keep all 31 bits, so -log(u) reaches 32 log(2)
+//rather than the 24 log(2) of a 24-bit uniform. Near 1 the float rounds.
+static inline float positiveUnit(const uint32_t bits)
+{   return (float)(bits >> 1) * 0x1p-31f + 0x1p-32f;  }
 
-    for (size_t i = 0; i < 10; i++)
-    {   printf("%f ", f32_exponential(1));  }
-    printf("\n");
+#define SQRT_HALF 0.707106781186547524f
 
-    for (size_t i = 0; i < 10; i++)
-    {   printf("%f ", f32_normal(5, 2));  }
-    printf("\n");
+//Natural log of a positive normal float, as in Cephes' logf: the mantissa m
+//is brought to [sqrt(1/2), sqrt(2)) and log(1 + x) taken by a polynomial.
+static inline float polyLog(const float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    float e = (float)((int32_t)(bits >> 23) - 126);
+    bits = (bits & 0x007FFFFF) | 0x3F000000;
+    float m;
+    memcpy(&m, &bits, sizeof(m));
+    float x = m - 1.0f;
+    if (m < SQRT_HALF)
+    {
+        e = e - 1.0f;
+        x = x + m;
+    }
 
-    return 0;
+    const float z = x * x;
+    float y = 7.0376836292E-2f;
+    y = y * x + -1.1514610310E-1f;
+    y = y * x + 1.1676998740E-1f;
+    y = y * x + -1.2420140846E-1f;
+    y = y * x + 1.4249322787E-1f;
+    y = y * x + -1.6668057665E-1f;
+    y = y * x + 2.0000714765E-1f;
+    y = y * x + -2.4999993993E-1f;
+    y = y * x + 3.3333331174E-1f;
+    y = y * x * z;
+    y = y + -2.12194440E-4f * e;
+    y = y + -0.5f * z;
+    return (x + y) + 0.693359375f * e;
+}
+
+static const float octantCos[8] = { 1.0f, SQRT_HALF, 0.0f, -SQRT_HALF, -1.0f, -SQRT_HALF, 0.0f, SQRT_HALF };
+static const float octantSin[8] = { 0.0f, SQRT_HALF, 1.0f, SQRT_HALF, 0.0f, -SQRT_HALF, -1.0f, -SQRT_HALF };
+
+//Sine and cosine of 2 pi k / 2^24 for k < 2^24. k is split exactly into the
+//nearest eighth of a turn and a remainder t of at most pi / 8, where Taylor
+//polynomials are accurate to float precision.
+static inline void polySinCos(const uint32_t k, float* sin_p, float* cos_p)
+{
+    const uint32_t j = (k + (1 << 20)) >> 21;
+    const float t = (float)((int32_t)k - (int32_t)(j << 21)) * (float)(M_PI / 4 / (1 << 21));
+    const float t2 = t * t;
+    float s = -1.98412698E-4f;
+    s = s * t2 + 8.33333333E-3f;
+    s = s * t2 + -1.66666667E-1f;
+    s = s * t2 * t + t;
+    float c = 2.48015873E-5f;
+    c = c * t2 + -1.38888889E-3f;
+    c = c * t2 + 4.16666667E-2f;
+    c = c * t2 + -0.5f;
+    c = c * t2 + 1.0f;
+    *cos_p = octantCos[j & 7] * c - octantSin[j & 7] * s;
+    *sin_p = octantSin[j & 7] * c + octantCos[j & 7] * s;
+}
+
+#define EXP_HI 88.0f
+#define EXP_LO -87.0f
+#define LOG2_E 1.44269504088896341f
+
+//exp of a float, as in Cephes' expf: x = n log(2) + t with |t| <= log(2) / 2,
+//exp(t) by a polynomial, and 2^n put in the exponent bits. Clamped to the
+//range where 2^n is a normal float.
+static inline float polyExp(float x)
+{
+    x = x < EXP_LO ? EXP_LO : (x > EXP_HI ? EXP_HI : x);
+    const float fx = floorf(x * LOG2_E + 0.5f);
+    x = x - fx * 0.693359375f;
+    x = x - fx * -2.12194440E-4f;
+    const float z = x * x;
+    float y = 1.9875691500E-4f;
+    y = y * x + 1.3981999507E-3f;
+    y = y * x + 8.3334519073E-3f;
+    y = y * x + 4.1665795894E-2f;
+    y = y * x + 1.6666665459E-1f;
+    y = y * x + 5.0000001201E-1f;
+    y = (y * z + x) + 1.0f;
+    const uint32_t bits = (uint32_t)((int32_t)fx + 127) << 23;
+    float scale;
+    memcpy(&scale, &bits, sizeof(scale));
+    return y * scale;
+}
+
+static void scalarExpInPlace(float* buf, const size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {   *(buf + i) = polyExp(*(buf + i));  }
+}
+
+static void scalarUniformFill(rv_generator_t* gen_p, float* buf, const size_t n, const float a, const float b)
+{
+    const float scale = (b - a) * 0x1p-24f;
+    uint32_t bits[8];
+    for (size_t i = 0; i < n; i += 8)
+    {
+        scalarNext(gen_p->s, bits);
+        for (size_t k = 0; k < 8 && i + k < n; k++)
+        {   *(buf + i + k) = (float)(bits[k] >> 8) * scale + a;  }
+    }
+}
+
+static void scalarExponentialFill(rv_generator_t* gen_p, float* buf, const size_t n, const float alpha)
+{
+    uint32_t bits[8];
+    for (size_t i = 0; i < n; i += 8)
+    {
+        scalarNext(gen_p->s, bits);
+        for (size_t k = 0; k < 8 && i + k < n; k++)
+        {   *(buf + i + k) = polyLog(positiveUnit(bits[k])) * -alpha; }
+    }
+}
+
+static void scalarNormalFill(rv_generator_t* gen_p, float* buf, const size_t n, const float mu, const float sigma)
+{
+    uint32_t radii[8], angles[8];
+    float sine, cosine;
+    for (size_t i = 0; i < n; i += 16)
+    {
+        scalarNext(gen_p->s, radii);
+        scalarNext(gen_p->s, angles);
+        for (size_t k = 0; k < 8; k++)
+        {
+            const float radius = sqrtf(polyLog(positiveUnit(radii[k])) * -2.0f) * sigma;
+            polySinCos(angles[k] >> 8, &sine, &cosine);
+            if (i + k < n)
+            {   *(buf + i + k) = radius * cosine + mu;  }
+            if (i + 8 + k < n)
+            {   *(buf + i + 8 + k) = radius * sine + mu;    }
+        }
+    }
+}
+
+//Steps of the generator handed out one 32-bit half at a time, for the slow
+//paths of the ziggurats.
+typedef struct bit_source
+{
+    uint32_t bits[8];
+    size_t next;
+} bit_source_t;
+
+static inline uint32_t nextBits(rv_generator_t* gen_p, bit_source_t* source_p)
+{
+    if (source_p->next == 8)
+    {
+        scalarNext(gen_p->s, source_p->bits);
+        source_p->next = 0;
+    }
+    return source_p->bits[source_p->next++];
+}
+
+//The ziggurats take the layer from the top bits of a 32-bit half and the
+//position in it from bits 1 to 23; the normal takes its sign from bit 24.
+//Returns whether the candidate is under the density without looking at it,
+//and puts it in x_p.
+static inline bool fastNormal(const uint32_t bits, float* x_p)
+{
+    const uint32_t i = bits >> 25;
+    const int32_t u = (bits >> 1) & 0x7FFFFF;
+    const float x = (float)u * zigNormalW[i];
+    *x_p = (bits >> 24) & 1 ? -x : x;
+    return u < zigNormalK[i];
+}
+
+static inline bool fastExponential(const uint32_t bits, float* x_p)
+{
+    const uint32_t i = bits >> 24;
+    const int32_t u = (bits >> 1) & 0x7FFFFF;
+    *x_p = (float)u * zigExpW[i];
+    return u < zigExpK[i];
+}
+
+//The variate for a candidate that failed the fast test: from the tail beyond
+//r, from the wedge of its layer if under the density, or else a new candidate.
+//The uniforms and new candidates come from source.
+static float slowNormal(rv_generator_t* gen_p, bit_source_t* source_p, uint32_t bits)
+{
+    float x;
+    while (!fastNormal(bits, &x))
+    {
+        const uint32_t i = bits >> 25;
+        const float sign = (bits >> 24) & 1 ? -1.0f : 1.0f;
+        if (i == 0)
+        {
+            //Marsaglia's method for the tail.
+            float y;
+            do
+            {
+                x = -logf(positiveUnit(nextBits(gen_p, source_p))) / ZIG_NORMAL_R;
+                y = -logf(positiveUnit(nextBits(gen_p, source_p)));
+            } while (y + y < x * x);
+            return sign * (ZIG_NORMAL_R + x);
+        }
+        const float height = zigNormalF[i] + positiveUnit(nextBits(gen_p, source_p)) * (zigNormalF[i - 1] - zigNormalF[i]);
+        if (height < expf(-0.5f * x * x))
+        {   return x;   }
+        bits = nextBits(gen_p, source_p);
+    }
+    return x;
+}
+
+static float slowExponential(rv_generator_t* gen_p, bit_source_t* source_p, uint32_t bits)
+{
+    float x;
+    while (!fastExponential(bits, &x))
+    {
+        const uint32_t i = bits >> 24;
+        if (i == 0)
+        {   return ZIG_EXP_R - logf(positiveUnit(nextBits(gen_p, source_p)));  }
+        const float height = zigExpF[i] + positiveUnit(nextBits(gen_p, source_p)) * (zigExpF[i - 1] - zigExpF[i]);
+        if (height < expf(-x))
+        {   return x;   }
+        bits = nextBits(gen_p, source_p);
+    }
+    return x;
+}
+
+//The ziggurat fills work in blocks of ZIG_BLOCK_STEPS steps: the fast test
+//on every candidate of the block, then the slow path on the ones that failed,
+//in order, from the steps after the block. The AVX2 fills follow the same order
+//and so give the same variates.
+#define ZIG_BLOCK_STEPS 64
+#define ZIG_BLOCK (8 * ZIG_BLOCK_STEPS)
+
+//Candidates of a block that failed the fast test: their place and their bits.
+typedef struct zig_rejects
+{
+    uint16_t at[ZIG_BLOCK];
+    uint32_t bits[ZIG_BLOCK];
+    size_t count;
+} zig_rejects_t;
+
+static void fixRejects(rv_generator_t* gen_p, float* x, const zig_rejects_t* rejects_p,
+                       float (*slow)(rv_generator_t*, bit_source_t*, uint32_t))
+{
+    bit_source_t source = { { 0 }, 8 };
+    for (size_t r = 0; r < rejects_p->count; r++)
+    {   *(x + rejects_p->at[r]) = slow(gen_p, &source, rejects_p->bits[r]);   }
+}
+
+static void scalarZigguratFill(rv_generator_t* gen_p, float* buf, const size_t n, const float scale, const float offset, bool normal)
+{
+    float x[ZIG_BLOCK];
+    uint32_t bits[8];
+    zig_rejects_t rejects;
+    for (size_t i = 0; i < n; i += ZIG_BLOCK)
+    {
+        const size_t count = n - i < ZIG_BLOCK ? n - i : ZIG_BLOCK;
+        rejects.count = 0;
+        for (size_t step = 0; step < (count + 7) / 8; step++)
+        {
+            scalarNext(gen_p->s, bits);
+            for (size_t k = 0; k < 8; k++)
+            {
+                const size_t at = 8 * step + k;
+                if (!(normal ? fastNormal(bits[k], x + at) : fastExponential(bits[k], x + at)))
+                {
+                    rejects.at[rejects.count] = (uint16_t)at;
+                    rejects.bits[rejects.count++] = bits[k];
+                }
+            }
+        }
+        fixRejects(gen_p, x, &rejects, normal ? slowNormal : slowExponential);
+        for (size_t k = 0; k < count; k++)
+        {   *(buf + i + k) = x[k] * scale + offset; }
+    }
+}
+
+static void scalarNormalZigguratFill(rv_generator_t* gen_p, float* buf, const size_t n, const float mu, const float sigma)
+{   scalarZigguratFill(gen_p, buf, n, sigma, mu, true);  }
+
+static void scalarExponentialZigguratFill(rv_generator_t* gen_p, float* buf, const size_t n, const float alpha)
+{   scalarZigguratFill(gen_p, buf, n, alpha, 0.0f, false);  }
+
+#if defined(__x86_64__) || defined(__i386__)
+//nextLane on the 4 lanes at once.
+__attribute__((target("avx2")))
+static inline __m256i avx2Next(__m256i* s)
+{
+    const __m256i result = _mm256_add_epi64(s[0], s[3]);
+    const __m256i t = _mm256_slli_epi64(s[1], 17);
+    s[2] = _mm256_xor_si256(s[2], s[0]);
+    s[3] = _mm256_xor_si256(s[3], s[1]);
+    s[1] = _mm256_xor_si256(s[1], s[2]);
+    s[0] = _mm256_xor_si256(s[0], s[3]);
+    s[2] = _mm256_xor_si256(s[2], t);
+    s[3] = _mm256_or_si256(_mm256_slli_epi64(s[3], 45), _mm256_srli_epi64(s[3], 19));
+    return result;
+}
+
+__attribute__((target("avx2")))
+static inline void avx2Load(const rv_generator_t* gen_p, __m256i* s)
+{
+    for (size_t w = 0; w < 4; w++)
+    {   s[w] = _mm256_loadu_si256((const __m256i*)gen_p->s[w]);  }
+}
+
+__attribute__((target("avx2")))
+static inline void avx2Store(rv_generator_t* gen_p, const __m256i* s)
+{
+    for (size_t w = 0; w < 4; w++)
+    {   _mm256_storeu_si256((__m256i*)gen_p->s[w], s[w]); }
+}
+
+__attribute__((target("avx2")))
+static inline __m256 avx2PositiveUnit(const __m256i bits)
+{
+    const __m256 u = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(bits, 1)), _mm256_set1_ps(0x1p-31f));
+    return _mm256_add_ps(u, _mm256_set1_ps(0x1p-32f));
+}
+
+//polyLog on 8 floats.
+__attribute__((target("avx2")))
+static inline __m256 avx2Log(const __m256 value)
+{
+    __m256i bits = _mm256_castps_si256(value);
+    __m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126)));
+    bits = _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)), _mm256_set1_epi32(0x3F000000));
+    const __m256 m = _mm256_castsi256_ps(bits);
+    const __m256 small = _mm256_cmp_ps(m, _mm256_set1_ps(SQRT_HALF), _CMP_LT_OQ);
+    e = _mm256_sub_ps(e, _mm256_and_ps(small, _mm256_set1_ps(1.0f)));
+    const __m256 x = _mm256_add_ps(_mm256_sub_ps(m, _mm256_set1_ps(1.0f)), _mm256_and_ps(small, m));
+
+    const __m256 z = _mm256_mul_ps(x, x);
+    __m256 y = _mm256_set1_ps(7.0376836292E-2f);
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(-1.1514610310E-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(1.1676998740E-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(-1.2420140846E-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(1.4249322787E-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(-1.6668057665E-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(2.0000714765E-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(-2.4999993993E-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(3.3333331174E-1f));
+    y = _mm256_mul_ps(_mm256_mul_ps(y, x), z);
+    y = _mm256_add_ps(y, _mm256_mul_ps(_mm256_set1_ps(-2.12194440E-4f), e));
+    y = _mm256_add_ps(y, _mm256_mul_ps(_mm256_set1_ps(-0.5f), z));
+    return _mm256_add_ps(_mm256_add_ps(x, y), _mm256_mul_ps(_mm256_set1_ps(0.693359375f), e));
+}
+
+//polySinCos on 8 angles, with the octant values looked up by a permute.
+__attribute__((target("avx2")))
+static inline void avx2SinCos(const __m256i k, __m256* sin_p, __m256* cos_p)
+{
+    const __m256i j = _mm256_srli_epi32(_mm256_add_epi32(k, _mm256_set1_epi32(1 << 20)), 21);
+    const __m256 t = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(k, _mm256_slli_epi32(j, 21))),
+                                   _mm256_set1_ps((float)(M_PI / 4 / (1 << 21))));
+    const __m256 t2 = _mm256_mul_ps(t, t);
+    __m256 s = _mm256_set1_ps(-1.98412698E-4f);
+    s = _mm256_add_ps(_mm256_mul_ps(s, t2), _mm256_set1_ps(8.33333333E-3f));
+    s = _mm256_add_ps(_mm256_mul_ps(s, t2), _mm256_set1_ps(-1.66666667E-1f));
+    s = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(s, t2), t), t);
+    __m256 c = _mm256_set1_ps(2.48015873E-5f);
+    c = _mm256_add_ps(_mm256_mul_ps(c, t2), _mm256_set1_ps(-1.38888889E-3f));
+    c = _mm256_add_ps(_mm256_mul_ps(c, t2), _mm256_set1_ps(4.16666667E-2f));
+    c = _mm256_add_ps(_mm256_mul_ps(c, t2), _mm256_set1_ps(-0.5f));
+    c = _mm256_add_ps(_mm256_mul_ps(c, t2), _mm256_set1_ps(1.0f));
+
+    //permutevar8x32 only uses the low 3 bits of each index.
+    const __m256 cj = _mm256_permutevar8x32_ps(_mm256_loadu_ps(octantCos), j);
+    const __m256 sj = _mm256_permutevar8x32_ps(_mm256_loadu_ps(octantSin), j);
+    *cos_p = _mm256_sub_ps(_mm256_mul_ps(cj, c), _mm256_mul_ps(sj, s));
+    *sin_p = _mm256_add_ps(_mm256_mul_ps(sj, c), _mm256_mul_ps(cj, s));
+}
+
+//The AVX2 fills write whole steps to buf, and the last partial one to tail.
+__attribute__((target("avx2")))
+static void avx2UniformFill(rv_generator_t* gen_p, float* buf, const size_t n, const float a, const float b)
+{
+    __m256i s[4];
+    float tail[8];
+    avx2Load(gen_p, s);
+    const __m256 scale = _mm256_set1_ps((b - a) * 0x1p-24f), offset = _mm256_set1_ps(a);
+    for (size_t i = 0; i < n; i += 8)
+    {
+        const __m256i bits = avx2Next(s);
+        const __m256 u = _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(bits, 8)), scale), offset);
+        _mm256_storeu_ps(i + 8 <= n ? buf + i : tail, u);
+        if (i + 8 > n)
+        {   memcpy(buf + i, tail, sizeof(float) * (n - i)); }
+    }
+    avx2Store(gen_p, s);
+}
+
+__attribute__((target("avx2")))
+static void avx2ExponentialFill(rv_generator_t* gen_p, float* buf, const size_t n, const float alpha)
+{
+    __m256i s[4];
+    float tail[8];
+    avx2Load(gen_p, s);
+    const __m256 scale = _mm256_set1_ps(-alpha);
+    for (size_t i = 0; i < n; i += 8)
+    {
+        const __m256 x = _mm256_mul_ps(avx2Log(avx2PositiveUnit(avx2Next(s))), scale);
+        _mm256_storeu_ps(i + 8 <= n ? buf + i : tail, x);
+        if (i + 8 > n)
+        {   memcpy(buf + i, tail, sizeof(float) * (n - i)); }
+    }
+    avx2Store(gen_p, s);
+}
+
+__attribute__((target("avx2")))
+static void avx2NormalFill(rv_generator_t* gen_p, float* buf, const size_t n, const float mu, const float sigma)
+{
+    __m256i s[4];
+    float tail[16];
+    avx2Load(gen_p, s);
+    const __m256 mus = _mm256_set1_ps(mu), sigmas = _mm256_set1_ps(sigma);
+    __m256 sine, cosine;
+    for (size_t i = 0; i < n; i += 16)
+    {
+        const __m256 logs = avx2Log(avx2PositiveUnit(avx2Next(s)));
+        const __m256 radius = _mm256_mul_ps(_mm256_sqrt_ps(_mm256_mul_ps(logs, _mm256_set1_ps(-2.0f))), sigmas);
+        avx2SinCos(_mm256_srli_epi32(avx2Next(s), 8), &sine, &cosine);
+        float* out = i + 16 <= n ? buf + i : tail;
+        _mm256_storeu_ps(out, _mm256_add_ps(_mm256_mul_ps(radius, cosine), mus));
+        _mm256_storeu_ps(out + 8, _mm256_add_ps(_mm256_mul_ps(radius, sine), mus));
+        if (i + 16 > n)
+        {   memcpy(buf + i, tail, sizeof(float) * (n - i)); }
+    }
+    avx2Store(gen_p, s);
+}
+
+//The fast tests on 8 candidates, with the table entries gathered by layer.
+//Returns the mask of the accepted ones.
+__attribute__((target("avx2")))
+static inline int avx2FastNormal(const __m256i bits, __m256* x_p)
+{
+    const __m256i i = _mm256_srli_epi32(bits, 25);
+    const __m256i u = _mm256_and_si256(_mm256_srli_epi32(bits, 1), _mm256_set1_epi32(0x7FFFFF));
+    const __m256i sign = _mm256_slli_epi32(_mm256_srli_epi32(bits, 24), 31);
+    const __m256 x = _mm256_mul_ps(_mm256_cvtepi32_ps(u), _mm256_i32gather_ps(zigNormalW, i, 4));
+    *x_p = _mm256_xor_ps(x, _mm256_castsi256_ps(sign));
+    const __m256i k = _mm256_i32gather_epi32((const int*)zigNormalK, i, 4);
+    return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(k, u)));
+}
+
+__attribute__((target("avx2")))
+static inline int avx2FastExponential(const __m256i bits, __m256* x_p)
+{
+    const __m256i i = _mm256_srli_epi32(bits, 24);
+    const __m256i u = _mm256_and_si256(_mm256_srli_epi32(bits, 1), _mm256_set1_epi32(0x7FFFFF));
+    *x_p = _mm256_mul_ps(_mm256_cvtepi32_ps(u), _mm256_i32gather_ps(zigExpW, i, 4));
+    const __m256i k = _mm256_i32gather_epi32((const int*)zigExpK, i, 4);
+    return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(k, u)));
+}
+
+__attribute__((target("avx2")))
+static void avx2ZigguratFill(rv_generator_t* gen_p, float* buf, const size_t n, const float scale, const float offset, bool normal)
+{
+    __m256i s[4];
+    float x[ZIG_BLOCK];
+    uint32_t bits[8];
+    zig_rejects_t rejects;
+    const __m256 scales = _mm256_set1_ps(scale), offsets = _mm256_set1_ps(offset);
+    for (size_t i = 0; i < n; i += ZIG_BLOCK)
+    {
+        const size_t count = n - i < ZIG_BLOCK ? n - i : ZIG_BLOCK;
+        rejects.count = 0;
+        avx2Load(gen_p, s);
+        for (size_t step = 0; step < (count + 7) / 8; step++)
+        {
+            const __m256i stepBits = avx2Next(s);
+            __m256 values;
+            int accepted = normal ? avx2FastNormal(stepBits, &values) : avx2FastExponential(stepBits, &values);
+            _mm256_storeu_ps(x + 8 * step, values);
+            if (accepted != 0xFF)
+            {
+                _mm256_storeu_si256((__m256i*)bits, stepBits);
+                for (int failed = ~accepted & 0xFF; failed; failed &= failed - 1)
+                {
+                    const int k = __builtin_ctz(failed);
+                    rejects.at[rejects.count] = (uint16_t)(8 * step + k);
+                    rejects.bits[rejects.count++] = bits[k];
+                }
+            }
+        }
+        avx2Store(gen_p, s);
+        fixRejects(gen_p, x, &rejects, normal ? slowNormal : slowExponential);
+
+        size_t k = 0;
+        for (; k + 8 <= count; k += 8)
+        {   _mm256_storeu_ps(buf + i + k, _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(x + k), scales), offsets));  }
+        for (; k < count; k++)
+        {   *(buf + i + k) = x[k] * scale + offset; }
+    }
+}
+
+__attribute__((target("avx2")))
+static void avx2NormalZigguratFill(rv_generator_t* gen_p, float* buf, const size_t n, const float mu, const float sigma)
+{   avx2ZigguratFill(gen_p, buf, n, sigma, mu, true); }
+
+__attribute__((target("avx2")))
+static void avx2ExponentialZigguratFill(rv_generator_t* gen_p, float* buf, const size_t n, const float alpha)
+{   avx2ZigguratFill(gen_p, buf, n, alpha, 0.0f, false); }
+
+//polyExp on 8 floats.
+__attribute__((target("avx2")))
+static inline __m256 avx2Exp(__m256 x)
+{
+    x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(EXP_LO)), _mm256_set1_ps(EXP_HI));
+    const __m256 fx = _mm256_floor_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(LOG2_E)), _mm256_set1_ps(0.5f)));
+    x = _mm256_sub_ps(x, _mm256_mul_ps(fx, _mm256_set1_ps(0.693359375f)));
+    x = _mm256_sub_ps(x, _mm256_mul_ps(fx, _mm256_set1_ps(-2.12194440E-4f)));
+    const __m256 z = _mm256_mul_ps(x, x);
+    __m256 y = _mm256_set1_ps(1.9875691500E-4f);
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(1.3981999507E-3f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(8.3334519073E-3f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(4.1665795894E-2f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(1.6666665459E-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(5.0000001201E-1f));
+    y = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(y, z), x), _mm256_set1_ps(1.0f));
+    const __m256i bits = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(fx), _mm256_set1_epi32(127)), 23);
+    return _mm256_mul_ps(y, _mm256_castsi256_ps(bits));
+}
+
+__attribute__((target("avx2")))
+static void avx2ExpInPlace(float* buf, const size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {   _mm256_storeu_ps(buf + i, avx2Exp(_mm256_loadu_ps(buf + i)));  }
+    for (; i < n; i++)
+    {   *(buf + i) = polyExp(*(buf + i));  }
+}
+#endif
+
+static void (*uniformFill)(rv_generator_t*, float*, const size_t, const float, const float) = NULL;
+static void (*exponentialFill)(rv_generator_t*, float*, const size_t, const float) = NULL;
+static void (*normalFill)(rv_generator_t*, float*, const size_t, const float, const float) = NULL;
+static void (*exponentialZigguratFill)(rv_generator_t*, float*, const size_t, const float) = NULL;
+static void (*normalZigguratFill)(rv_generator_t*, float*, const size_t, const float, const float) = NULL;
+static void (*expInPlace)(float*, const size_t) = NULL;
+
+bool rv_useAVX2(bool enable)
+{
+    uniformFill = scalarUniformFill;
+    exponentialFill = scalarExponentialFill;
+    normalFill = scalarNormalFill;
+    exponentialZigguratFill = scalarExponentialZigguratFill;
+    normalZigguratFill = scalarNormalZigguratFill;
+    expInPlace = scalarExpInPlace;
+#if defined(__x86_64__) || defined(__i386__)
+    if (enable && __builtin_cpu_supports("avx2"))
+    {
+        uniformFill = avx2UniformFill;
+        exponentialFill = avx2ExponentialFill;
+        normalFill = avx2NormalFill;
+        exponentialZigguratFill = avx2ExponentialZigguratFill;
+        normalZigguratFill = avx2NormalZigguratFill;
+        expInPlace = avx2ExpInPlace;
+    }
+#endif
+    return uniformFill != scalarUniformFill;
+}
+
+//The first fill picks the kernels once, whichever thread makes it.
+static pthread_once_t dispatchOnce = PTHREAD_ONCE_INIT;
+
+static void defaultDispatch(void)
+{
+    if (uniformFill == NULL)
+    {   rv_useAVX2(true);   }
+}
+
+void f32_uniformFill(rv_generator_t* gen_p, float* buf, const size_t n, const float a, const float b)
+{
+    pthread_once(&dispatchOnce, defaultDispatch);
+    uniformFill(gen_p, buf, n, a, b);
+}
+
+void f32_exponentialFill(rv_generator_t* gen_p, float* buf, const size_t n, const float alpha)
+{
+    pthread_once(&dispatchOnce, defaultDispatch);
+    exponentialFill(gen_p, buf, n, alpha);
+}
+
+void f32_normalFill(rv_generator_t* gen_p, float* buf, const size_t n, const float mu, const float sigma)
+{
+    pthread_once(&dispatchOnce, defaultDispatch);
+    normalFill(gen_p, buf, n, mu, sigma);
+}
+
+void f32_exponentialZigguratFill(rv_generator_t* gen_p, float* buf, const size_t n, const float alpha)
+{
+    pthread_once(&dispatchOnce, defaultDispatch);
+    exponentialZigguratFill(gen_p, buf, n, alpha);
+}
+
+void f32_normalZigguratFill(rv_generator_t* gen_p, float* buf, const size_t n, const float mu, const float sigma)
+{
+    pthread_once(&dispatchOnce, defaultDispatch);
+    normalZigguratFill(gen_p, buf, n, mu, sigma);
+}
+
+void f32_gammaFill(rv_generator_t* gen_p, float* buf, const size_t n, const float shape, const float scale)
+{
+    float z[RV_BLOCK], u[RV_BLOCK];
+    const float d = (shape < 1.0f ? shape + 1.0f : shape) - 1.0f / 3.0f;
+    const float c = 1.0f / sqrtf(9.0f * d);
+    size_t i = 0;
+    while (i < n)
+    {
+        f32_normalFill(gen_p, z, RV_BLOCK, 0.0f, 1.0f);
+        f32_uniformFill(gen_p, u, RV_BLOCK, 0.0f, 1.0f);
+        for (size_t k = 0; k < RV_BLOCK && i < n; k++)
+        {
+            const float x = z[k];
+            float v = 1.0f + c * x;
+            if (v <= 0.0f)
+            {   continue;   }
+            v = v * v * v;
+            //The squeeze accepts most candidates without a log.
+            if (u[k] < 1.0f - 0.0331f * (x * x) * (x * x) || logf(u[k]) < 0.5f * x * x + d * (1.0f - v + logf(v)))
+            {   *(buf + i++) = d * v * scale;  }
+        }
+    }
+
+    for (size_t first = 0; shape < 1.0f && first < n; first += RV_BLOCK)
+    {
+        const size_t count = n - first < RV_BLOCK ? n - first : RV_BLOCK;
+        f32_uniformFill(gen_p, u, count, 0.0f, 1.0f);
+        for (size_t k = 0; k < count; k++)
+        {   *(buf + first + k) *= powf(1.0f - u[k], 1.0f / shape); }
+    }
+}
+
+void f32_betaFill(rv_generator_t* gen_p, float* buf, const size_t n, const float a, const float b)
+{
+    float ga[RV_BLOCK], gb[RV_BLOCK];
+    for (size_t first = 0; first < n; first += RV_BLOCK)
+    {
+        const size_t count = n - first < RV_BLOCK ? n - first : RV_BLOCK;
+        f32_gammaFill(gen_p, ga, count, a, 1.0f);
+        f32_gammaFill(gen_p, gb, count, b, 1.0f);
+        for (size_t k = 0; k < count; k++)
+        {   *(buf + first + k) = ga[k] / (ga[k] + gb[k]);  }
+    }
+}
+
+//Uniforms handed out one at a time from blocks of the uniform fill, for the
+//discrete distributions.
+typedef struct uniform_source
+{
+    float u[RV_BLOCK];
+    size_t next;
+} uniform_source_t;
+
+//A uniform on [0, 1) of 48 bits, from two floats.
+static inline double nextUniform(rv_generator_t* gen_p, uniform_source_t* source_p)
+{
+    if (source_p->next + 2 > RV_BLOCK)
+    {
+        f32_uniformFill(gen_p, source_p->u, RV_BLOCK, 0.0f, 1.0f);
+        source_p->next = 0;
+    }
+    const double u = source_p->u[source_p->next] + source_p->u[source_p->next + 1] * 0x1p-24;
+    source_p->next += 2;
+    return u;
+}
+
+//Distribution function of a discrete distribution from its probabilities,
+//starting at pmf0 = P(0) with P(k) = P(k - 1) * ratio(k), into cdf up to the
+//first k where it is within 1e-15 of 1, or maxK. Returns the number of entries.
+static size_t tabulateCDF(double pmf0, double (*ratio)(size_t, const double*), const double* params, size_t maxK, double* cdf)
+{
+    double pmf = pmf0, total = pmf0;
+    size_t k = 0;
+    *cdf = total;
+    while (k < maxK && total < 1.0 - 1e-15)
+    {
+        k++;
+        pmf *= ratio(k, params);
+        total += pmf;
+        *(cdf + k) = total;
+    }
+    return k + 1;
+}
+
+//Smallest k with u <= cdf[k], or the last entry.
+static inline float invertCDF(const double u, const double* cdf, const size_t nEntries)
+{
+    size_t k = 0;
+    while (k + 1 < nEntries && u > *(cdf + k))
+    {   k++;    }
+    return (float)k;
+}
+
+static double poissonRatio(size_t k, const double* params)
+{   return params[0] / k;   }
+
+static double binomialRatio(size_t k, const double* params)
+{   return (params[0] - k + 1) / k * params[1] / (1.0 - params[1]);    }
+
+//Inversion needs at most about mean + 14 standard deviations of entries below
+//a mean of 10.
+#define MAX_CDF_ENTRIES 64
+
+void f32_poissonFill(rv_generator_t* gen_p, float* buf, const size_t n, const float lambda)
+{
+    uniform_source_t source;
+    source.next = RV_BLOCK;
+    const double lam = lambda;
+    if (lam < 10.0)
+    {
+        double cdf[MAX_CDF_ENTRIES];
+        const size_t nEntries = tabulateCDF(exp(-lam), poissonRatio, &lam, MAX_CDF_ENTRIES - 1, cdf);
+        for (size_t i = 0; i < n; i++)
+        {   *(buf + i) = invertCDF(nextUniform(gen_p, &source), cdf, nEntries);   }
+        return;
+    }
+
+    //PTRS, as in Hoermann, "The transformed rejection method for generating
+    //Poisson random variables" (1993).
+    const double slam = sqrt(lam), loglam = log(lam);
+    const double b = 0.931 + 2.53 * slam, a = -0.059 + 0.02483 * b;
+    const double logAlpha = log(1.1239 + 1.1328 / (b - 3.4)), vr = 0.9277 - 3.6224 / (b - 2.0);
+    for (size_t i = 0; i < n; i++)
+    {
+        while (true)
+        {
+            const double u = nextUniform(gen_p, &source) - 0.5, v = nextUniform(gen_p, &source);
+            const double us = 0.5 - fabs(u);
+            const double k = floor((2.0 * a / us + b) * u + lam + 0.43);
+            if (us >= 0.07 && v <= vr)
+            {
+                *(buf + i) = (float)k;
+                break;
+            }
+            if (k < 0.0 || (us < 0.013 && v > us))
+            {   continue;   }
+            if (log(v) + logAlpha - log(a / (us * us) + b) <= -lam + k * loglam - lgamma(k + 1.0))
+            {
+                *(buf + i) = (float)k;
+                break;
+            }
+        }
+    }
+}
+
+void f32_binomialFill(rv_generator_t* gen_p, float* buf, const size_t n, const unsigned trials, const float p)
+{
+    uniform_source_t source;
+    source.next = RV_BLOCK;
+    //Draw the count of the less likely outcome.
+    const bool flip = p > 0.5f;
+    const double q = flip ? 1.0 - p : p, count = trials;
+    if (count * q < 10.0)
+    {
+        double cdf[MAX_CDF_ENTRIES];
+        const double params[] = { count, q };
+        const size_t maxK = trials < MAX_CDF_ENTRIES - 1 ? trials : MAX_CDF_ENTRIES - 1;
+        const size_t nEntries = tabulateCDF(pow(1.0 - q, count), binomialRatio, params, maxK, cdf);
+        for (size_t i = 0; i < n; i++)
+        {
+            const float k = invertCDF(nextUniform(gen_p, &source), cdf, nEntries);
+            *(buf + i) = flip ? trials - k : k;
+        }
+        return;
+    }
+
+    //BTRS, as in Hoermann, "The generation of binomial random variates" (1993).
+    const double spq = sqrt(count * q * (1.0 - q));
+    const double b = 1.15 + 2.53 * spq, a = -0.0873 + 0.0248 * b + 0.01 * q;
+    const double c = count * q + 0.5, vr = 0.92 - 4.2 / b;
+    const double alpha = (2.83 + 5.1 / b) * spq, lpq = log(q / (1.0 - q));
+    const double m = floor((count + 1.0) * q), h = lgamma(m + 1.0) + lgamma(count - m + 1.0);
+    for (size_t i = 0; i < n; i++)
+    {
+        while (true)
+        {
+            const double u = nextUniform(gen_p, &source) - 0.5, v = nextUniform(gen_p, &source);
+            const double us = 0.5 - fabs(u);
+            const double k = floor((2.0 * a / us + b) * u + c);
+            if (k < 0.0 || k > count)
+            {   continue;   }
+            if ((us >= 0.07 && v <= vr)
+                || log(v * alpha / (a / (us * us) + b)) <= h - lgamma(k + 1.0) - lgamma(count - k + 1.0) + (k - m) * lpq)
+            {
+                *(buf + i) = (float)(flip ? count - k : k);
+                break;
+            }
+        }
+    }
+}
+
+void f32_logNormalFill(rv_generator_t* gen_p, float* buf, const size_t n, const float mu, const float sigma)
+{
+    f32_normalFill(gen_p, buf, n, mu, sigma);
+    expInPlace(buf, n);
+}
+
+bool rv_cholesky(const double* cov, const size_t dim, double* lower)
+{
+    memset(lower, 0, sizeof(double) * dim * dim);
+    for (size_t i = 0; i < dim; i++)
+    {
+        for (size_t j = 0; j <= i; j++)
+        {
+            double sum = *(cov + i * dim + j);
+            for (size_t k = 0; k < j; k++)
+            {   sum -= *(lower + i * dim + k) * *(lower + j * dim + k); }
+            if (i == j && sum <= 0.0)
+            {   return false;   }
+            *(lower + i * dim + j) = i == j ? sqrt(sum) : sum / *(lower + j * dim + j);
+        }
+    }
+    return true;
+}
+
+void f32_multiNormalFill(rv_generator_t* gen_p, float* out, const size_t colStride, const size_t n, const size_t dim, const float* mu, const double* lower)
+{
+    float* z = (float*)malloc(sizeof(float) * RV_BLOCK * dim);
+    for (size_t first = 0; first < n; first += RV_BLOCK)
+    {
+        const size_t count = n - first < RV_BLOCK ? n - first : RV_BLOCK;
+        for (size_t j = 0; j < dim; j++)
+        {   f32_normalFill(gen_p, z + j * RV_BLOCK, count, 0.0f, 1.0f);  }
+        for (size_t i = 0; i < dim; i++)
+        {
+            float* restrict x = out + i * colStride + first;
+            for (size_t r = 0; r < count; r++)
+            {   *(x + r) = *(mu + i);   }
+            for (size_t j = 0; j <= i; j++)
+            {
+                const float l = (float)*(lower + i * dim + j);
+                const float* restrict zj = z + j * RV_BLOCK;
+                for (size_t r = 0; r < count; r++)
+                {   *(x + r) += l * *(zj + r);  }
+            }
+        }
+    }
+    free(z);
+}
+
+void rv_fill(rv_generator_t* gen_p, const rv_distribution_t dist, const float* params, float* buf, const size_t n)
+{
+    switch (dist)
+    {
+        case RV_UNIFORM: f32_uniformFill(gen_p, buf, n, params[0], params[1]); break;
+        case RV_EXPONENTIAL: f32_exponentialFill(gen_p, buf, n, params[0]); break;
+        case RV_NORMAL: f32_normalFill(gen_p, buf, n, params[0], params[1]); break;
+        case RV_EXPONENTIAL_ZIGGURAT: f32_exponentialZigguratFill(gen_p, buf, n, params[0]); break;
+        case RV_NORMAL_ZIGGURAT: f32_normalZigguratFill(gen_p, buf, n, params[0], params[1]); break;
+        case RV_GAMMA: f32_gammaFill(gen_p, buf, n, params[0], params[1]); break;
+        case RV_BETA: f32_betaFill(gen_p, buf, n, params[0], params[1]); break;
+        case RV_POISSON: f32_poissonFill(gen_p, buf, n, params[0]); break;
+        case RV_BINOMIAL: f32_binomialFill(gen_p, buf, n, (unsigned)params[0], params[1]); break;
+        case RV_LOGNORMAL: f32_logNormalFill(gen_p, buf, n, params[0], params[1]); break;
+    }
+}
+
+typedef struct fill_task
+{
+    uint64_t seed;
+    rv_distribution_t dist;
+    const float* params;
+    float* buf;
+    size_t n;
+    size_t first;       //First stream of the task,
+    size_t stride;      //and the distance to its next one.
+} fill_task_t;
+
+//Stream i fills buf[start(i), start(i + 1)), in whole steps of every distribution.
+static size_t streamStart(const size_t n, const size_t i)
+{
+    const size_t steps = (n + 15) / 16;
+    const size_t start = steps * i / RV_PARALLEL_STREAMS * 16;
+    return start < n ? start : n;
+}
+
+static void* fillStreams(void* arg)
+{
+    fill_task_t* task = (fill_task_t*)arg;
+    rv_generator_t stream, gen;
+    rv_stream(&stream, task->seed, task->first);
+    for (size_t i = task->first; i < RV_PARALLEL_STREAMS; i += task->stride)
+    {
+        const size_t start = streamStart(task->n, i);
+        gen = stream;
+        rv_fill(&gen, task->dist, task->params, task->buf + start, streamStart(task->n, i + 1) - start);
+        //Jump from the start of the stream, not from where the fill left it.
+        for (size_t k = 0; k < task->stride && i + task->stride < RV_PARALLEL_STREAMS; k++)
+        {   rv_longJump(&stream);   }
+    }
+    return NULL;
+}
+
+void rv_parallelFill(const uint64_t seed, const rv_distribution_t dist, const float* params, float* buf, const size_t n, unsigned nThreads)
+{
+    if (nThreads == 0)
+    {   nThreads = (unsigned)sysconf(_SC_NPROCESSORS_ONLN); }
+    nThreads = nThreads < RV_PARALLEL_STREAMS ? nThreads : RV_PARALLEL_STREAMS;
+
+    fill_task_t* tasks = (fill_task_t*)malloc(sizeof(fill_task_t) * nThreads);
+    pthread_t* threads = (pthread_t*)malloc(sizeof(pthread_t) * nThreads);
+    for (unsigned t = 0; t < nThreads; t++)
+    {
+        fill_task_t task = { seed, dist, params, buf, n, t, nThreads };
+        *(tasks + t) = task;
+        if (t)
+        {   pthread_create(threads + t, NULL, fillStreams, tasks + t);    }
+    }
+    fillStreams(tasks);
+    for (unsigned t = 1; t < nThreads; t++)
+    {   pthread_join(*(threads + t), NULL);   }
+    free(threads);
+    free(tasks);
+}
+
+rv_moments_t rv_sampleMoments(const float* x, const size_t n)
+{
+    rv_moments_t moments = { 0.0, 0.0, 0.0, 0.0 };
+    if (n == 0)
+    {   return moments; }
+    double sum = 0.0;
+    for (size_t i = 0; i < n; i++)
+    {   sum += *(x + i);    }
+    moments.mean = sum / n;
+
+    double m2 = 0.0, m3 = 0.0, m4 = 0.0;
+    for (size_t i = 0; i < n; i++)
+    {
+        const double d = *(x + i) - moments.mean, d2 = d * d;
+        m2 += d2; m3 += d2 * d; m4 += d2 * d2;
+    }
+    moments.variance = n > 1 ? m2 / (n - 1) : 0.0;
+    if (m2 > 0.0)
+    {
+        moments.skewness = (m3 / n) / pow(m2 / n, 1.5);
+        moments.kurtosis = (m4 / n) / ((m2 / n) * (m2 / n)) - 3.0;
+    }
+    return moments;
+}
+
+static int compareFloats(const void* a, const void* b)
+{
+    const float x = *(const float*)a, y = *(const float*)b;
+    return (x > y) - (x < y);
+}
+
+double rv_ksStatistic(float* x, const size_t n, double (*cdf)(double, const double*), const double* params)
+{
+    qsort(x, n, sizeof(float), compareFloats);
+    double d = 0.0;
+    for (size_t i = 0; i < n; i++)
+    {
+        const double f = cdf(*(x + i), params);
+        const double above = f - (double)i / n, below = (double)(i + 1) / n - f;
+        d = above > d ? above : d;
+        d = below > d ? below : d;
+    }
+    return d;
+}
+
+double rv_ksDiscreteStatistic(float* x, const size_t n, double (*cdf)(double, const double*), const double* params)
+{
+    qsort(x, n, sizeof(float), compareFloats);
+    double d = 0.0;
+    for (size_t i = 0; i < n;)
+    {
+        size_t j = i;
+        while (j + 1 < n && *(x + j + 1) == *(x + i))
+        {   j++;    }
+        //Below the step at x[i] the samples count i / n, at it (j + 1) / n.
+        const double below = fabs((double)i / n - cdf(*(x + i) - 1.0, params));
+        const double at = fabs((double)(j + 1) / n - cdf(*(x + i), params));
+        d = below > d ? below : d;
+        d = at > d ? at : d;
+        i = j + 1;
+    }
+    return d;
+}
+
+double rv_ksPValue(const double d, const size_t n)
+{
+    const double root = sqrt((double)n);
+    const double lambda = (root + 0.12 + 0.11 / root) * d;
+    //The series converges too slowly to sum below 0.2, where the value is 1.
+    if (lambda < 0.2)
+    {   return 1.0; }
+    double p = 0.0, sign = 2.0;
+    for (int k = 1; k <= 100; k++)
+    {
+        const double term = sign * exp(-2.0 * k * k * lambda * lambda);
+        p += term;
+        if (fabs(term) < 1e-12 * p)
+        {   break;  }
+        sign = -sign;
+    }
+    return p < 0.0 ? 0.0 : (p > 1.0 ? 1.0 : p);
 }
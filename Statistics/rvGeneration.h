@@ -0,0 +1,158 @@
+#ifndef RVGENERATION_H
+#define RVGENERATION_H
+
+#include<stdlib.h>
+#include<stdio.h>
+#include<stdint.h>
+#include<stdbool.h>
+#include<math.h>
+
+//One variate per call from rand(), which is seeded with srand(). f32_normal
+//keeps its second variate per thread, but rand() is shared, so with several
+//threads the variates depend on their timing. Use rv_stream for parallel work.
+static inline float f32_uniform(const float a, const float b)
+{   return ((float)rand() / (float)RAND_MAX * (b-a)) + a;  }
+
+float f32_exponential(const float alpha);
+float f32_normal(const float mu, const float sigma);
+
+//State of 4 xoshiro256+ generators, which run side by side in the 4 64-bit
+//lanes of an AVX2 register. Word w of lane l is s[w][l].
+typedef struct rv_generator
+{
+    uint64_t s[4][4];
+} rv_generator_t;
+
+//Seed the generator. Lane 0 is seeded from seed with splitmix64 and each
+//other lane is the one before it jumped 2^128 steps ahead, so the lanes
+//never overlap.
+void rv_seed(rv_generator_t* gen_p, const uint64_t seed);
+
+//Advance every lane 2^128 steps, as if that many variates had been drawn.
+void rv_jump(rv_generator_t* gen_p);
+
+//Advance every lane 2^192 steps.
+void rv_longJump(rv_generator_t* gen_p);
+
+//Seed the generator with stream streamId of seed: the generator of rv_seed
+//long-jumped streamId times. Up to 2^64 streams of the same seed never
+//overlap, and each is the same whichever thread draws it. Takes time in
+//proportion to streamId.
+void rv_stream(rv_generator_t* gen_p, const uint64_t seed, const uint64_t streamId);
+
+//Fill buf with n variates. Each step of the generator gives 8 floats from the
+//upper 24 bits of each 32-bit half of the 4 lane outputs; the fills use whole
+//steps, so the unused floats of the last one are dropped.
+//  f32_uniformFill      uniform on [a, b);
+//  f32_exponentialFill  exponential of mean alpha, as -alpha * log(u);
+//  f32_normalFill       normal of mean mu and standard deviation sigma, by
+//                       Box-Muller, 16 at a time from 8 radii and 8 angles.
+//log, sin and cos are polynomials, computed the same way by the AVX2 and the
+//scalar code, so both give the same floats for the same seed unless the
+//compiler fuses multiplies and adds, as with -mfma.
+//The log is taken of a uniform in (0, 1] from 31 bits, whose smallest value is
+//2^-32, so exponentials stop at 32 log(2) alpha = 22.2 alpha, cutting off a
+//probability of 2^-32 = 2.3e-10, and Box-Muller normals stop at 6.66 sigma,
+//cutting off 2.7e-11 or about 3 in 10^11 samples.
+void f32_uniformFill(rv_generator_t* gen_p, float* buf, const size_t n, const float a, const float b);
+void f32_exponentialFill(rv_generator_t* gen_p, float* buf, const size_t n, const float alpha);
+void f32_normalFill(rv_generator_t* gen_p, float* buf, const size_t n, const float mu, const float sigma);
+
+//The same distributions by the ziggurat method of Marsaglia and Tsang: the
+//layer and position of a candidate come from one 32-bit half, and 97.2% of
+//normal and 97.8% of exponential candidates are accepted by comparing it to
+//an entry of a table, with no log or exp. The others take a slow path, which
+//draws further steps and calls logf or expf. With AVX2 the 8 candidates of a
+//step are tested at once with gathers.
+void f32_exponentialZigguratFill(rv_generator_t* gen_p, float* buf, const size_t n, const float alpha);
+void f32_normalZigguratFill(rv_generator_t* gen_p, float* buf, const size_t n, const float mu, const float sigma);
+
+//Fills built on blocks of RV_BLOCK uniforms or normals from the fills above,
+//which are then accepted, rejected or transformed a variate at a time. A
+//column j of a column-major f32_dataframe_t, data + j * colStride, can be
+//filled directly.
+//  f32_gammaFill        gamma of the given shape and scale, by Marsaglia and
+//                       Tsang's method, which accepts over 95% of normals;
+//                       shapes below 1 are boosted from shape + 1 by u^(1/shape);
+//  f32_betaFill         beta(a, b), as Ga / (Ga + Gb) from two gamma fills;
+//  f32_poissonFill      Poisson of mean lambda, by inversion below 10 and by
+//                       Hoermann's PTRS transformed rejection above;
+//  f32_binomialFill     binomial of trials trials of probability p, by
+//                       inversion when the smaller of trials * p and
+//                       trials * (1 - p) is below 10, by Hoermann's BTRS
+//                       transformed rejection otherwise;
+//  f32_logNormalFill    exp of a normal of mean mu and standard deviation
+//                       sigma, with exp a polynomial on 8 floats at a time.
+//Poisson and binomial counts are whole floats, exact up to 2^24.
+#define RV_BLOCK 512
+void f32_gammaFill(rv_generator_t* gen_p, float* buf, const size_t n, const float shape, const float scale);
+void f32_betaFill(rv_generator_t* gen_p, float* buf, const size_t n, const float a, const float b);
+void f32_poissonFill(rv_generator_t* gen_p, float* buf, const size_t n, const float lambda);
+void f32_binomialFill(rv_generator_t* gen_p, float* buf, const size_t n, const unsigned trials, const float p);
+void f32_logNormalFill(rv_generator_t* gen_p, float* buf, const size_t n, const float mu, const float sigma);
+
+//Lower triangular L with L L^T = cov, for the dim x dim row-major covariance
+//matrix cov, into the row-major matrix lower. Returns false if cov is not
+//positive definite.
+bool rv_cholesky(const double* cov, const size_t dim, double* lower);
+
+//n draws of a dim-dimensional normal of mean mu and covariance L L^T, where
+//lower is L from rv_cholesky: x = mu + L z for z of independent standard
+//normals. Coordinate i of draw r goes to out[i * colStride + r], so out can be
+//the data of a column-major f32_dataframe_t of n rows and dim columns. The
+//draws are made RV_BLOCK at a time, coordinate by coordinate.
+void f32_multiNormalFill(rv_generator_t* gen_p, float* out, const size_t colStride, const size_t n, const size_t dim, const float* mu, const double* lower);
+
+typedef enum rv_distribution
+{
+    RV_UNIFORM,         //params: a, b
+    RV_EXPONENTIAL,     //params: alpha
+    RV_NORMAL,          //params: mu, sigma
+    RV_EXPONENTIAL_ZIGGURAT,    //params: alpha
+    RV_NORMAL_ZIGGURAT,         //params: mu, sigma
+    RV_GAMMA,           //params: shape, scale
+    RV_BETA,            //params: a, b
+    RV_POISSON,         //params: lambda
+    RV_BINOMIAL,        //params: trials, p
+    RV_LOGNORMAL        //params: mu, sigma
+} rv_distribution_t;
+
+//The fill of dist with its params.
+void rv_fill(rv_generator_t* gen_p, const rv_distribution_t dist, const float* params, float* buf, const size_t n);
+
+//Fill buf with n variates of dist on nThreads threads, or one per online CPU
+//for 0. buf is cut into RV_PARALLEL_STREAMS parts, each filled from its own
+//rv_stream of seed and the streams dealt out to the threads in turn, so the
+//result depends on seed and n but not on the number of threads.
+#define RV_PARALLEL_STREAMS 256
+void rv_parallelFill(const uint64_t seed, const rv_distribution_t dist, const float* params, float* buf, const size_t n, unsigned nThreads);
+
+//Choose between the AVX2 and the scalar fills. AVX2 is only used if the CPU
+//supports it, which is also the default. Not to be called while fills run.
+//Returns whether AVX2 is used.
+bool rv_useAVX2(bool enable);
+
+//Mean, sample variance, skewness and excess kurtosis of n samples.
+typedef struct rv_moments
+{
+    double mean;
+    double variance;
+    double skewness;
+    double kurtosis;
+} rv_moments_t;
+
+rv_moments_t rv_sampleMoments(const float* x, const size_t n);
+
+//Kolmogorov-Smirnov statistic of n samples against the distribution function
+//cdf, which is called with params. Sorts the samples.
+double rv_ksStatistic(float* x, const size_t n, double (*cdf)(double, const double*), const double* params);
+
+//The same for a distribution on the integers, whose cdf is a step function:
+//the difference is taken on both sides of every step.
+double rv_ksDiscreteStatistic(float* x, const size_t n, double (*cdf)(double, const double*), const double* params);
+
+//Probability of a statistic at least d from n samples of the distribution,
+//from the asymptotic Kolmogorov distribution with Stephens' correction.
+double rv_ksPValue(const double d, const size_t n);
+
+#endif /* RVGENERATION_H */
@@ -0,0 +1,82 @@
+#include "benchmarkUtils.h"
+#include<string.h>
+
+#define QUALITY_SAMPLES (1 << 20)
+
+typedef struct distribution
+{
+    const char* name;
+    double params[2];
+    double (*cdf)(double, const double*);
+    //mean, variance, skewness and excess kurtosis
+    rv_moments_t expected;
+} distribution_t;
+
+//Fill buf with one of the distributions, from rand() or from gen_p.
+static void fill(const size_t d, rv_generator_t* gen_p, float* buf, const size_t n, const double* params)
+{
+    const float p0 = (float)params[0], p1 = (float)params[1];
+    for (size_t i = 0; gen_p == NULL && i < n; i++)
+    {   *(buf + i) = d == 0 ? f32_uniform(p0, p1) : (d == 1 ? f32_exponential(p0) : f32_normal(p0, p1));  }
+    if (gen_p && d == 0)
+    {   f32_uniformFill(gen_p, buf, n, p0, p1); }
+    else if (gen_p && d == 1)
+    {   f32_exponentialFill(gen_p, buf, n, p0); }
+    else if (gen_p)
+    {   f32_normalFill(gen_p, buf, n, p0, p1);  }
+}
+
+//Takes the number of samples per fill as an optional argument.
+int main(int argc, char** argv)
+{
+    const size_t n = argc > 1 ? (size_t)atol(argv[1]) : 1 << 24;
+    const distribution_t dists[] = {
+        { "uniform(-1, 1)", { -1.0, 1.0 }, uniformCDF, { 0.0, 1.0 / 3.0, 0.0, -1.2 } },
+        { "exponential(1)", { 1.0, 0.0 }, exponentialCDF, { 1.0, 1.0, 2.0, 6.0 } },
+        { "normal(5, 2)", { 5.0, 2.0 }, normalCDF, { 5.0, 4.0, 0.0, 0.0 } }
+    };
+    float* buf = (float*)malloc(sizeof(float) * (n > QUALITY_SAMPLES ? n : QUALITY_SAMPLES));
+    float* check = (float*)malloc(sizeof(float) * n);
+    rv_generator_t gen;
+
+    printf("Throughput, %zu samples, in millions of samples/s \n", n);
+    for (size_t d = 0; d < 3; d++)
+    {
+        srand(9999);
+        double start = seconds();
+        fill(d, NULL, buf, n, dists[d].params);
+        const double randTime = seconds() - start;
+
+        rv_useAVX2(false);
+        rv_seed(&gen, 9999);
+        start = seconds();
+        fill(d, &gen, check, n, dists[d].params);
+        const double scalarTime = seconds() - start;
+
+        const bool avx2 = rv_useAVX2(true);
+        rv_seed(&gen, 9999);
+        start = seconds();
+        fill(d, &gen, buf, n, dists[d].params);
+        const double avx2Time = seconds() - start;
+
+        printf("  %-15s rand(): %8.1f, scalar fill: %8.1f, AVX2 fill: %8.1f%s, %s \n", dists[d].name, n / randTime / 1e6,
+               n / scalarTime / 1e6, n / avx2Time / 1e6, avx2 ? "" : " (not supported)",
+               memcmp(buf, check, sizeof(float) * n) == 0 ? "same samples" : "SAMPLES DIFFER");
+    }
+
+    printf("Quality, %d samples, expected values in brackets \n", QUALITY_SAMPLES);
+    for (size_t d = 0; d < 3; d++)
+    {
+        printf("%s \n", dists[d].name);
+        srand(9999);
+        fill(d, NULL, buf, QUALITY_SAMPLES, dists[d].params);
+        printQuality("rand():", buf, QUALITY_SAMPLES, dists[d].cdf, dists[d].params, &dists[d].expected);
+        rv_seed(&gen, 9999);
+        fill(d, &gen, buf, QUALITY_SAMPLES, dists[d].params);
+        printQuality("fill:", buf, QUALITY_SAMPLES, dists[d].cdf, dists[d].params, &dists[d].expected);
+    }
+
+    free(buf);
+    free(check);
+    return 0;
+}
@@ -0,0 +1,39 @@
+#include "benchmarkUtils.h"
+#include<string.h>
+#include<unistd.h>
+
+//Takes the number of samples and the largest number of threads as optional
+//arguments. Fills a buffer with normal variates on 1 to M threads, and checks
+//that every thread count gives the samples of 1 thread.
+int main(int argc, char** argv)
+{
+    const size_t n = argc > 1 ? (size_t)atol(argv[1]) : 1 << 25;
+    const unsigned maxThreads = argc > 2 ? (unsigned)atoi(argv[2]) : (unsigned)sysconf(_SC_NPROCESSORS_ONLN);
+    const float params[] = { 0.0f, 1.0f };
+    float* reference = (float*)malloc(sizeof(float) * (n ? n : 1));
+    float* buf = (float*)malloc(sizeof(float) * (n ? n : 1));
+
+    //Touch the pages first so that the timings do not include faulting them in.
+    rv_parallelFill(9999, RV_NORMAL, params, reference, n, 1);
+    memset(buf, 0, sizeof(float) * n);
+
+    double start = seconds();
+    rv_parallelFill(9999, RV_NORMAL, params, reference, n, 1);
+    const double oneThread = seconds() - start;
+
+    printf("%zu normal samples on %ld CPUs \n", n, sysconf(_SC_NPROCESSORS_ONLN));
+    printf("Threads  Msamples/s  Speedup  Samples \n");
+    printf("%7u  %10.1f  %7.2f  reference \n", 1, n / oneThread / 1e6, 1.0);
+    for (unsigned nThreads = 2; nThreads <= maxThreads; nThreads *= 2)
+    {
+        start = seconds();
+        rv_parallelFill(9999, RV_NORMAL, params, buf, n, nThreads);
+        const double time = seconds() - start;
+        printf("%7u  %10.1f  %7.2f  %s \n", nThreads, n / time / 1e6, oneThread / time,
+               memcmp(buf, reference, sizeof(float) * n) == 0 ? "same" : "DIFFERENT");
+    }
+
+    free(reference);
+    free(buf);
+    return 0;
+}
@@ -0,0 +1,39 @@
+#include "rvGeneration.h"
+
+int main(void)
+{
+    srand(9999);
+
+    for (size_t i = 0; i < 10; i++)
+    {   printf("%f ", f32_uniform(-1, 1));  }
+    printf("\n");
+
+    for (size_t i = 0; i < 10; i++)
+    {   printf("%f ", f32_exponential(1));  }
+    printf("\n");
+
+    for (size_t i = 0; i < 10; i++)
+    {   printf("%f ", f32_normal(5, 2));  }
+    printf("\n");
+
+    rv_generator_t gen;
+    rv_seed(&gen, 9999);
+    float buf[10];
+
+    f32_uniformFill(&gen, buf, 10, -1, 1);
+    for (size_t i = 0; i < 10; i++)
+    {   printf("%f ", buf[i]);  }
+    printf("\n");
+
+    f32_exponentialFill(&gen, buf, 10, 1);
+    for (size_t i = 0; i < 10; i++)
+    {   printf("%f ", buf[i]);  }
+    printf("\n");
+
+    f32_normalFill(&gen, buf, 10, 5, 2);
+    for (size_t i = 0; i < 10; i++)
+    {   printf("%f ", buf[i]);  }
+    printf("\n");
+
+    return 0;
+}
@@ -0,0 +1,214 @@
+#ifndef ZIGGURATTABLES_H
+#define ZIGGURATTABLES_H
+
+#include<stdint.h>
+
+//Tables of the ziggurat samplers of rvGeneration.c, after Marsaglia and Tsang,
+//"The Ziggurat Method for Generating Random Variables" (2000). The density
+//f(x) = exp(-x^2 / 2) for the normal, or exp(-x) for the exponential, is
+//covered by N layers of area v: a base strip, rectangle up to r plus the tail,
+//and N - 1 rectangles stacked on it, layer i spanning [0, x_i) with
+//x_127 = r for the normal, x_255 = r for the exponential, and
+//x_(i-1) = f^-1(v / x_i + f(x_i)) going up. For a 23-bit integer u,
+//  K[i] = 2^23 x_(i-1) / x_i, so that u < K[i] when u W[i] < x_(i-1), where
+//         the whole height of layer i is under the density; K[0] = 2^23 r / x_0
+//         with x_0 = v / f(r), the width of a rectangle of the base's area;
+//  W[i] = x_i / 2^23;
+//  F[i] = f(x_i), with F[0] = 1.
+//normal:      N = 128, r = 3.442619855899, v = 9.91256303526217e-3
+//exponential: N = 256, r = 7.697117470131487, v = 3.949659822581572e-3
+#define ZIG_NORMAL_R 3.442619855899f
+#define ZIG_EXP_R 7.697117470131487f
+
+static const int32_t zigNormalK[128] = {
+    7777570, 0, 6295323, 7136327, 7494470, 7692293, 7817505, 7903781,
+    7966789, 8014798, 8052578, 8083074, 8108200, 8129255, 8147148, 8162540,
+    8175916, 8187646, 8198014, 8207240, 8215502, 8222941, 8229672, 8235790,
+    8241373, 8246486, 8251185, 8255516, 8259520, 8263230, 8266677, 8269885,
+    8272878, 8275675, 8278293, 8280747, 8283051, 8285218, 8287257, 8289178,
+    8290989, 8292700, 8294316, 8295843, 8297289, 8298656, 8299952, 8301178,
+    8302340, 8303442, 8304485, 8305474, 8306410, 8307298, 8308137, 8308932,
+    8309683, 8310392, 8311062, 8311693, 8312287, 8312844, 8313367, 8313856,
+    8314311, 8314734, 8315126, 8315486, 8315816, 8316116, 8316386, 8316626,
+    8316838, 8317020, 8317172, 8317296, 8317390, 8317454, 8317489, 8317493,
+    8317466, 8317408, 8317318, 8317194, 8317037, 8316844, 8316615, 8316348,
+    8316042, 8315694, 8315304, 8314868, 8314383, 8313848, 8313259, 8312612,
+    8311903, 8311128, 8310281, 8309356, 8308347, 8307246, 8306045, 8304732,
+    8303296, 8301724, 8299999, 8298102, 8296012, 8293700, 8291136, 8288279,
+    8285081, 8281482, 8277405, 8272755, 8267404, 8261183, 8253866, 8245132,
+    8234522, 8221344, 8204512, 8182196, 8151055, 8104203, 8024609, 7853668
+};
+static const float zigNormalW[128] = {
+    4.42634359e-07f, 3.2463177e-08f, 4.32576464e-08f, 5.0848481e-08f, 5.69150238e-08f, 6.20670377e-08f,
+    6.66012951e-08f, 7.06866885e-08f, 7.44293445e-08f, 7.79007223e-08f, 8.11514766e-08f, 8.42189323e-08f,
+    8.71314896e-08f, 8.99113033e-08f, 9.25760233e-08f, 9.51399883e-08f, 9.76149934e-08f, 1.00010901e-07f,
+    1.02336031e-07f, 1.04597504e-07f, 1.0680143e-07f, 1.08953145e-07f, 1.11057304e-07f, 1.13118006e-07f,
+    1.15138896e-07f, 1.17123221e-07f, 1.19073896e-07f, 1.20993548e-07f, 1.22884543e-07f, 1.2474905e-07f,
+    1.26589057e-07f, 1.28406356e-07f, 1.30202636e-07f, 1.31979419e-07f, 1.33738155e-07f, 1.3548015e-07f,
+    1.37206655e-07f, 1.38918836e-07f, 1.40617772e-07f, 1.42304501e-07f, 1.43980003e-07f, 1.45645174e-07f,
+    1.47300895e-07f, 1.48948018e-07f, 1.50587312e-07f, 1.5221957e-07f, 1.53845505e-07f, 1.55465827e-07f,
+    1.57081217e-07f, 1.58692359e-07f, 1.60299862e-07f, 1.61904396e-07f, 1.63506527e-07f, 1.65106897e-07f,
+    1.66706073e-07f, 1.68304652e-07f, 1.69903188e-07f, 1.71502265e-07f, 1.7310245e-07f, 1.74704311e-07f,
+    1.7630839e-07f, 1.77915268e-07f, 1.795255e-07f, 1.81139654e-07f, 1.82758313e-07f, 1.8438206e-07f,
+    1.86011462e-07f, 1.87647132e-07f, 1.89289679e-07f, 1.90939716e-07f, 1.92597881e-07f, 1.94264828e-07f,
+    1.95941226e-07f, 1.9762777e-07f, 1.99325171e-07f, 2.01034169e-07f, 2.0275553e-07f, 2.04490036e-07f,
+    2.06238525e-07f, 2.08001865e-07f, 2.09780964e-07f, 2.11576747e-07f, 2.13390223e-07f, 2.15222457e-07f,
+    2.17074515e-07f, 2.18947591e-07f, 2.20842892e-07f, 2.2276177e-07f, 2.24705587e-07f, 2.26675823e-07f,
+    2.28674097e-07f, 2.30702071e-07f, 2.32761593e-07f, 2.3485461e-07f, 2.36983254e-07f, 2.39149784e-07f,
+    2.4135673e-07f, 2.43606763e-07f, 2.45902811e-07f, 2.48248142e-07f, 2.50646252e-07f, 2.53101064e-07f,
+    2.55616925e-07f, 2.58198583e-07f, 2.60851436e-07f, 2.63581455e-07f, 2.66395375e-07f, 2.69300898e-07f,
+    2.72306693e-07f, 2.75422764e-07f, 2.78660679e-07f, 2.82033852e-07f, 2.85558031e-07f, 2.89251886e-07f,
+    2.93137816e-07f, 2.97242934e-07f, 3.01600664e-07f, 3.06252673e-07f, 3.11252137e-07f, 3.1666832e-07f,
+    3.22593877e-07f, 3.29157047e-07f, 3.36542769e-07f, 3.45032703e-07f, 3.55088275e-07f, 3.67549518e-07f,
+    3.84221664e-07f, 4.10392261e-07f
+};
+static const float zigNormalF[128] = {
+    1.0f, 0.963599682f, 0.936282694f, 0.913043618f, 0.892281651f, 0.873243034f,
+    0.855500579f, 0.838783622f, 0.822907209f, 0.807738304f, 0.793177009f, 0.779146075f,
+    0.765584171f, 0.752441585f, 0.73967725f, 0.727256894f, 0.715151489f, 0.70333612f,
+    0.69178915f, 0.680491865f, 0.669427693f, 0.658581972f, 0.647941828f, 0.637495458f,
+    0.627232492f, 0.617143393f, 0.607219517f, 0.597453177f, 0.58783704f, 0.57836467f,
+    0.569029987f, 0.559827387f, 0.550751805f, 0.541798353f, 0.53296268f, 0.524240553f,
+    0.515628219f, 0.50712204f, 0.498718649f, 0.490414828f, 0.482207656f, 0.474094301f,
+    0.466072142f, 0.458138704f, 0.450291634f, 0.442528725f, 0.434847832f, 0.427246988f,
+    0.419724345f, 0.412278026f, 0.404906422f, 0.397607863f, 0.3903808f, 0.383223802f,
+    0.376135468f, 0.369114459f, 0.362159491f, 0.355269372f, 0.348442972f, 0.341679156f,
+    0.334976852f, 0.328335106f, 0.321752906f, 0.315229386f, 0.308763623f, 0.302354842f,
+    0.29600215f, 0.289704859f, 0.283462197f, 0.277273506f, 0.271138072f, 0.265055299f,
+    0.25902456f, 0.253045291f, 0.247116953f, 0.241238996f, 0.235410944f, 0.229632318f,
+    0.223902702f, 0.21822165f, 0.212588772f, 0.207003713f, 0.201466113f, 0.195975646f,
+    0.190532044f, 0.185134992f, 0.179784268f, 0.174479634f, 0.169220895f, 0.164007857f,
+    0.158840373f, 0.153718308f, 0.148641571f, 0.143610075f, 0.138623774f, 0.133682653f,
+    0.128786713f, 0.123935983f, 0.119130544f, 0.11437051f, 0.109656021f, 0.104987256f,
+    0.100364439f, 0.0957878456f, 0.0912578031f, 0.0867746696f, 0.0823388994f, 0.0779509842f,
+    0.0736115053f, 0.0693211183f, 0.0650805831f, 0.0608907714f, 0.0567526631f, 0.0526674017f,
+    0.0486362949f, 0.0446608625f, 0.0407428667f, 0.0368843898f, 0.0330878869f, 0.0293563176f,
+    0.0256932918f, 0.022103304f, 0.0185921025f, 0.0151672978f, 0.0118394783f, 0.00862448476f,
+    0.00554899499f, 0.00266962918f
+};
+static const int32_t zigExpK[256] = {
+    7424080, 0, 5109103, 6405078, 6975196, 7292063, 7492724, 7630840,
+    7731567, 7808211, 7868455, 7917037, 7957036, 7990536, 8018998, 8043478,
+    8064756, 8083419, 8099922, 8114619, 8127789, 8139660, 8150413, 8160200,
+    8169144, 8177350, 8184905, 8191883, 8198348, 8204354, 8209949, 8215172,
+    8220059, 8224642, 8228947, 8232999, 8236820, 8240428, 8243841, 8247074,
+    8250140, 8253052, 8255821, 8258456, 8260968, 8263365, 8265654, 8267841,
+    8269934, 8271939, 8273860, 8275702, 8277470, 8279169, 8280801, 8282372,
+    8283883, 8285338, 8286741, 8288093, 8289397, 8290656, 8291871, 8293045,
+    8294180, 8295277, 8296338, 8297365, 8298359, 8299321, 8300254, 8301157,
+    8302033, 8302882, 8303706, 8304504, 8305280, 8306032, 8306763, 8307472,
+    8308161, 8308830, 8309480, 8310112, 8310726, 8311323, 8311903, 8312468,
+    8313016, 8313550, 8314068, 8314573, 8315064, 8315541, 8316006, 8316458,
+    8316897, 8317324, 8317740, 8318145, 8318538, 8318920, 8319292, 8319654,
+    8320006, 8320347, 8320680, 8321002, 8321316, 8321621, 8321916, 8322203,
+    8322482, 8322752, 8323014, 8323269, 8323515, 8323753, 8323984, 8324207,
+    8324423, 8324632, 8324833, 8325028, 8325215, 8325396, 8325569, 8325736,
+    8325896, 8326050, 8326197, 8326338, 8326472, 8326599, 8326721, 8326836,
+    8326945, 8327047, 8327143, 8327233, 8327317, 8327395, 8327467, 8327532,
+    8327591, 8327645, 8327692, 8327732, 8327767, 8327796, 8327818, 8327834,
+    8327843, 8327847, 8327844, 8327834, 8327818, 8327796, 8327767, 8327731,
+    8327688, 8327639, 8327583, 8327520, 8327449, 8327372, 8327287, 8327194,
+    8327094, 8326987, 8326871, 8326747, 8326616, 8326475, 8326327, 8326169,
+    8326002, 8325827, 8325642, 8325447, 8325242, 8325027, 8324802, 8324566,
+    8324318, 8324059, 8323789, 8323506, 8323210, 8322901, 8322579, 8322243,
+    8321892, 8321526, 8321144, 8320745, 8320330, 8319897, 8319445, 8318974,
+    8318483, 8317971, 8317436, 8316878, 8316296, 8315688, 8315053, 8314390,
+    8313697, 8312971, 8312213, 8311418, 8310587, 8309715, 8308800, 8307840,
+    8306832, 8305772, 8304657, 8303482, 8302243, 8300935, 8299553, 8298090,
+    8296540, 8294895, 8293146, 8291283, 8289296, 8287172, 8284897, 8282453,
+    8279822, 8276982, 8273907, 8270566, 8266923, 8262935, 8258551, 8253705,
+    8248322, 8242304, 8235528, 8227840, 8219034, 8208841, 8196893, 8182678,
+    8165456, 8144120, 8116923, 8080946, 8030872, 7955847, 7829464, 7564599
+};
+static const float zigExpW[256] = {
+    1.03677723e-06f, 7.61177077e-09f, 1.24977237e-08f, 1.63680287e-08f, 1.96847463e-08f, 2.26448407e-08f,
+    2.53524188e-08f, 2.78699979e-08f, 3.02384322e-08f, 3.24861027e-08f, 3.46336329e-08f, 3.6696548e-08f,
+    3.86868848e-08f, 4.06141858e-08f, 4.24861639e-08f, 4.43091572e-08f, 4.60884557e-08f, 4.7828518e-08f,
+    4.95331491e-08f, 5.12056282e-08f, 5.28488009e-08f, 5.44651542e-08f, 5.60568907e-08f, 5.76259467e-08f,
+    5.91740665e-08f, 6.07027957e-08f, 6.22135445e-08f, 6.37075743e-08f, 6.51860361e-08f, 6.66499815e-08f,
+    6.81003698e-08f, 6.9538082e-08f, 7.09639281e-08f, 7.23786613e-08f, 7.37829779e-08f, 7.51775104e-08f,
+    7.65628769e-08f, 7.79396245e-08f, 7.93082862e-08f, 8.06693521e-08f, 8.20232771e-08f, 8.33705016e-08f,
+    8.47114379e-08f, 8.60464695e-08f, 8.73759589e-08f, 8.87002614e-08f, 9.00197037e-08f, 9.13345914e-08f,
+    9.26452444e-08f, 9.39519254e-08f, 9.52549186e-08f, 9.65544871e-08f, 9.78508723e-08f, 9.9144323e-08f,
+    1.00435059e-07f, 1.01723316e-07f, 1.03009299e-07f, 1.04293214e-07f, 1.05575261e-07f, 1.0685563e-07f,
+    1.08134515e-07f, 1.09412099e-07f, 1.10688539e-07f, 1.11964027e-07f, 1.13238713e-07f, 1.14512765e-07f,
+    1.15786342e-07f, 1.17059592e-07f, 1.18332672e-07f, 1.1960573e-07f, 1.20878894e-07f, 1.22152315e-07f,
+    1.23426133e-07f, 1.24700477e-07f, 1.2597549e-07f, 1.27251297e-07f, 1.28528015e-07f, 1.29805798e-07f,
+    1.31084747e-07f, 1.32365003e-07f, 1.3364668e-07f, 1.34929891e-07f, 1.36214766e-07f, 1.37501416e-07f,
+    1.38789972e-07f, 1.4008053e-07f, 1.41373235e-07f, 1.42668171e-07f, 1.43965465e-07f, 1.45265247e-07f,
+    1.46567601e-07f, 1.47872669e-07f, 1.49180551e-07f, 1.50491346e-07f, 1.51805196e-07f, 1.53122187e-07f,
+    1.54442446e-07f, 1.55766088e-07f, 1.57093211e-07f, 1.58423944e-07f, 1.597584e-07f, 1.61096679e-07f,
+    1.62438923e-07f, 1.63785217e-07f, 1.65135688e-07f, 1.66490466e-07f, 1.67849649e-07f, 1.69213365e-07f,
+    1.70581728e-07f, 1.71954881e-07f, 1.73332907e-07f, 1.74715964e-07f, 1.76104152e-07f, 1.77497597e-07f,
+    1.78896443e-07f, 1.80300816e-07f, 1.81710831e-07f, 1.83126616e-07f, 1.84548327e-07f, 1.85976091e-07f,
+    1.87410023e-07f, 1.88850294e-07f, 1.90297015e-07f, 1.91750345e-07f, 1.93210425e-07f, 1.94677398e-07f,
+    1.96151433e-07f, 1.97632659e-07f, 1.99121232e-07f, 2.00617322e-07f, 2.02121086e-07f, 2.0363268e-07f,
+    2.05152276e-07f, 2.06680042e-07f, 2.0821615e-07f, 2.09760771e-07f, 2.11314102e-07f, 2.12876316e-07f,
+    2.14447596e-07f, 2.16028127e-07f, 2.17618123e-07f, 2.19217767e-07f, 2.20827289e-07f, 2.22446857e-07f,
+    2.24076729e-07f, 2.25717088e-07f, 2.27368176e-07f, 2.29030221e-07f, 2.30703449e-07f, 2.32388103e-07f,
+    2.34084453e-07f, 2.35792726e-07f, 2.37513177e-07f, 2.39246106e-07f, 2.40991739e-07f, 2.42750417e-07f,
+    2.44522369e-07f, 2.46307934e-07f, 2.48107426e-07f, 2.49921101e-07f, 2.51749356e-07f, 2.53592447e-07f,
+    2.55450772e-07f, 2.57324672e-07f, 2.59214517e-07f, 2.61120675e-07f, 2.63043518e-07f, 2.6498347e-07f,
+    2.6694093e-07f, 2.68916352e-07f, 2.70910135e-07f, 2.72922733e-07f, 2.74954658e-07f, 2.77006365e-07f,
+    2.79078392e-07f, 2.81171197e-07f, 2.83285402e-07f, 2.85421493e-07f, 2.87580121e-07f, 2.89761829e-07f,
+    2.91967268e-07f, 2.94197093e-07f, 2.96451958e-07f, 2.98732601e-07f, 3.01039734e-07f, 3.03374122e-07f,
+    3.05736563e-07f, 3.08127852e-07f, 3.10548899e-07f, 3.13000555e-07f, 3.15483817e-07f, 3.17999593e-07f,
+    3.20548963e-07f, 3.23133008e-07f, 3.25752808e-07f, 3.28409584e-07f, 3.3110453e-07f, 3.33838983e-07f,
+    3.36614278e-07f, 3.39431864e-07f, 3.42293276e-07f, 3.45200021e-07f, 3.48153861e-07f, 3.5115653e-07f,
+    3.54209874e-07f, 3.57315884e-07f, 3.60476662e-07f, 3.63694426e-07f, 3.66971506e-07f, 3.70310431e-07f,
+    3.73713846e-07f, 3.77184563e-07f, 3.80725623e-07f, 3.8434024e-07f, 3.88031879e-07f, 3.91804235e-07f,
+    3.95661289e-07f, 3.99607302e-07f, 4.03646879e-07f, 4.07784995e-07f, 4.12026992e-07f, 4.16378697e-07f,
+    4.20846447e-07f, 4.25437122e-07f, 4.30158224e-07f, 4.35017995e-07f, 4.40025445e-07f, 4.45190523e-07f,
+    4.50524198e-07f, 4.56038634e-07f, 4.61747362e-07f, 4.67665501e-07f, 4.73809962e-07f, 4.80199901e-07f,
+    4.86856834e-07f, 4.93805487e-07f, 5.01074055e-07f, 5.08694939e-07f, 5.16705938e-07f, 5.25151222e-07f,
+    5.34082858e-07f, 5.43563033e-07f, 5.53666553e-07f, 5.64484935e-07f, 5.76131299e-07f, 5.88748094e-07f,
+    6.02518128e-07f, 6.17681394e-07f, 6.34561843e-07f, 6.53611494e-07f, 6.75488707e-07f, 7.01206261e-07f,
+    7.32441492e-07f, 7.72282874e-07f, 8.27435713e-07f, 9.17567888e-07f
+};
+static const float zigExpF[256] = {
+    1.0f, 0.938143671f, 0.900469959f, 0.87170434f, 0.847785473f, 0.826993287f,
+    0.808421671f, 0.791527629f, 0.775956869f, 0.761463404f, 0.747868598f, 0.735038102f,
+    0.722867668f, 0.711274743f, 0.70019263f, 0.689566493f, 0.679350555f, 0.669506311f,
+    0.660000861f, 0.650805831f, 0.641896725f, 0.633251965f, 0.624852717f, 0.616682172f,
+    0.608725369f, 0.600968957f, 0.593400896f, 0.586010337f, 0.578787386f, 0.571723044f,
+    0.564809203f, 0.558038294f, 0.551403403f, 0.544898212f, 0.538516879f, 0.532253861f,
+    0.526104212f, 0.520063162f, 0.51412642f, 0.508289754f, 0.502549529f, 0.496901989f,
+    0.491343856f, 0.485872f, 0.480483353f, 0.475175202f, 0.469944835f, 0.464789748f,
+    0.459707618f, 0.454696149f, 0.449753255f, 0.444876879f, 0.440065116f, 0.435316116f,
+    0.430628151f, 0.425999552f, 0.42142874f, 0.416914195f, 0.412454456f, 0.408048183f,
+    0.403694004f, 0.399390697f, 0.395136982f, 0.390931726f, 0.386773825f, 0.382662177f,
+    0.378595769f, 0.374573559f, 0.370594651f, 0.366658092f, 0.362762988f, 0.358908474f,
+    0.355093747f, 0.351318002f, 0.347580492f, 0.343880445f, 0.340217143f, 0.336589903f,
+    0.332998067f, 0.329440951f, 0.325917959f, 0.322428495f, 0.318971902f, 0.315547675f,
+    0.312155247f, 0.308794081f, 0.305463612f, 0.302163392f, 0.298892915f, 0.295651704f,
+    0.292439282f, 0.289255232f, 0.286099076f, 0.282970428f, 0.279868841f, 0.276793927f,
+    0.273745298f, 0.270722598f, 0.267725408f, 0.264753431f, 0.26180625f, 0.258883536f,
+    0.255985022f, 0.25311029f, 0.250259072f, 0.24743107f, 0.244625971f, 0.241843462f,
+    0.23908329f, 0.236345157f, 0.23362878f, 0.23093392f, 0.228260294f, 0.225607663f,
+    0.222975761f, 0.220364377f, 0.217773244f, 0.215202153f, 0.212650865f, 0.210119158f,
+    0.207606822f, 0.205113649f, 0.202639446f, 0.200183973f, 0.197747067f, 0.195328519f,
+    0.19292815f, 0.190545768f, 0.188181207f, 0.185834259f, 0.18350479f, 0.181192607f,
+    0.178897545f, 0.176619455f, 0.174358174f, 0.172113538f, 0.169885397f, 0.167673618f,
+    0.165478036f, 0.163298532f, 0.161134943f, 0.158987135f, 0.156854987f, 0.154738367f,
+    0.152637139f, 0.150551185f, 0.148480371f, 0.146424592f, 0.144383729f, 0.142357647f,
+    0.140346244f, 0.138349429f, 0.136367068f, 0.134399071f, 0.13244532f, 0.130505741f,
+    0.128580198f, 0.126668632f, 0.124770917f, 0.122886978f, 0.121016718f, 0.119160056f,
+    0.117316902f, 0.115487166f, 0.113670766f, 0.111867629f, 0.110077679f, 0.108300827f,
+    0.106537007f, 0.104786143f, 0.103048161f, 0.101323001f, 0.099610582f, 0.0979108512f,
+    0.0962237418f, 0.0945491865f, 0.0928871334f, 0.0912375152f, 0.0896002799f, 0.0879753754f,
+    0.0863627419f, 0.0847623274f, 0.0831740946f, 0.0815979838f, 0.0800339505f, 0.0784819499f,
+    0.0769419447f, 0.0754138902f, 0.0738977492f, 0.0723934844f, 0.0709010586f, 0.0694204345f,
+    0.0679515898f, 0.0664944947f, 0.0650491193f, 0.0636154339f, 0.0621934161f, 0.0607830472f,
+    0.059384305f, 0.0579971746f, 0.0566216409f, 0.0552576892f, 0.053905312f, 0.0525644943f,
+    0.0512352362f, 0.049917534f, 0.0486113839f, 0.0473167934f, 0.0460337624f, 0.0447622985f,
+    0.0435024127f, 0.0422541238f, 0.0410174429f, 0.0397923924f, 0.0385789946f, 0.037377283f,
+    0.0361872837f, 0.0350090377f, 0.0338425823f, 0.0326879621f, 0.031545233f, 0.0304144435f,
+    0.0292956606f, 0.0281889495f, 0.0270943847f, 0.0260120463f, 0.0249420255f, 0.0238844212f,
+    0.0228393357f, 0.0218068883f, 0.0207872037f, 0.0197804235f, 0.0187867004f, 0.0178062003f,
+    0.0168391075f, 0.0158856213f, 0.0149459681f, 0.0140203917f, 0.0131091652f, 0.0122125922f,
+    0.0113310134f, 0.0104648098f, 0.0096144136f, 0.00878031459f, 0.00796307717f, 0.00716335326f,
+    0.0063819061f, 0.00561964232f, 0.00487765577f, 0.00415729498f, 0.00346026476f, 0.00278879888f,
+    0.00214596768f, 0.00153629982f, 0.000967269298f, 0.000454134366f
+};
+
+#endif /* ZIGGURATTABLES_H */
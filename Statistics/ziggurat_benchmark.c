@@ -0,0 +1,119 @@
+#include "benchmarkUtils.h"
+#include<string.h>
+
+#define QUALITY_SAMPLES (1 << 20)
+#define CHUNK_SAMPLES (1 << 20)
+#define N_TAILS 4
+
+//Normal or exponential variates by one of the methods: 0 the rand() function,
+//1 the Box-Muller or -log(u) fill, 2 the ziggurat fill.
+static void fill(bool normal, int method, rv_generator_t* gen_p, float* buf, const size_t n)
+{
+    for (size_t i = 0; method == 0 && i < n; i++)
+    {   *(buf + i) = normal ? f32_normal(0, 1) : f32_exponential(1);   }
+    if (method == 1)
+    {   normal ? f32_normalFill(gen_p, buf, n, 0, 1) : f32_exponentialFill(gen_p, buf, n, 1);  }
+    else if (method == 2)
+    {   normal ? f32_normalZigguratFill(gen_p, buf, n, 0, 1) : f32_exponentialZigguratFill(gen_p, buf, n, 1);  }
+}
+
+static double rate(bool normal, int method, bool avx2, float* buf, const size_t n)
+{
+    rv_useAVX2(avx2);
+    rv_generator_t gen;
+    rv_seed(&gen, 9999);
+    srand(9999);
+    const double start = seconds();
+    fill(normal, method, &gen, buf, n);
+    return n / (seconds() - start) / 1e6;
+}
+
+//Counts of |x| beyond each of the bounds over n variates, made a chunk at a time.
+static void countTails(bool normal, int method, const size_t n, const double* bounds, size_t* counts, float* buf)
+{
+    rv_generator_t gen;
+    rv_seed(&gen, 12345);
+    srand(12345);
+    memset(counts, 0, sizeof(size_t) * N_TAILS);
+    for (size_t done = 0; done < n; done += CHUNK_SAMPLES)
+    {
+        const size_t chunk = n - done < CHUNK_SAMPLES ? n - done : CHUNK_SAMPLES;
+        fill(normal, method, &gen, buf, chunk);
+        for (size_t i = 0; i < chunk; i++)
+        {
+            for (size_t t = 0; t < N_TAILS; t++)
+            {   counts[t] += fabsf(*(buf + i)) > bounds[t];    }
+        }
+    }
+}
+
+static void compareTails(bool normal, const size_t n, float* buf)
+{
+    const double bounds[N_TAILS] = { normal ? 2.0 : 4.0, normal ? 3.0 : 8.0, normal ? 4.0 : 12.0, normal ? 5.0 : 16.0 };
+    const char* methods[] = { "rand():", normal ? "Box-Muller:" : "-log(u):", "ziggurat:" };
+    size_t counts[N_TAILS];
+    printf("%s, %zu samples, count beyond each bound and its deviation from the expected count in standard deviations \n",
+           normal ? "P(|Z| > x)" : "P(X > x)", n);
+    printf("  %-12s", "x:");
+    for (size_t t = 0; t < N_TAILS; t++)
+    {   printf("%22.0f", bounds[t]);    }
+    printf("\n  %-12s", "expected:");
+    for (size_t t = 0; t < N_TAILS; t++)
+    {   printf("%22.1f", n * (normal ? erfc(bounds[t] / M_SQRT2) : exp(-bounds[t])));  }
+    printf("\n");
+    for (int method = 0; method < 3; method++)
+    {
+        countTails(normal, method, n, bounds, counts, buf);
+        printf("  %-12s", methods[method]);
+        for (size_t t = 0; t < N_TAILS; t++)
+        {
+            const double expected = n * (normal ? erfc(bounds[t] / M_SQRT2) : exp(-bounds[t]));
+            printf("%14zu (%+5.1f)", counts[t], (counts[t] - expected) / sqrt(expected));
+        }
+        printf("\n");
+    }
+}
+
+//Takes the number of samples to time and the number to count tails over as
+//optional arguments.
+int main(int argc, char** argv)
+{
+    const size_t n = argc > 1 ? (size_t)atol(argv[1]) : 1 << 24;
+    const size_t nTail = argc > 2 ? (size_t)atol(argv[2]) : 1 << 26;
+    float* buf = (float*)malloc(sizeof(float) * (n > CHUNK_SAMPLES ? n : CHUNK_SAMPLES));
+    float* check = (float*)malloc(sizeof(float) * (n > QUALITY_SAMPLES ? n : QUALITY_SAMPLES));
+
+    printf("Throughput, %zu samples, in millions of samples/s \n", n);
+    for (int normal = 1; normal >= 0; normal--)
+    {
+        const double randRate = rate(normal, 0, false, buf, n);
+        const double fillRate = rate(normal, 1, false, buf, n), fillAVX2Rate = rate(normal, 1, true, buf, n);
+        const double zigRate = rate(normal, 2, false, check, n), zigAVX2Rate = rate(normal, 2, true, buf, n);
+        printf("  %-12s rand(): %6.1f, %-11s scalar %6.1f, AVX2 %6.1f, ziggurat: scalar %6.1f, AVX2 %6.1f, %s \n",
+               normal ? "normal" : "exponential", randRate, normal ? "Box-Muller:" : "-log(u):", fillRate, fillAVX2Rate,
+               zigRate, zigAVX2Rate, memcmp(buf, check, sizeof(float) * n) == 0 ? "same samples" : "SAMPLES DIFFER");
+    }
+
+    printf("Quality, %d samples, expected values in brackets \n", QUALITY_SAMPLES);
+    for (int normal = 1; normal >= 0; normal--)
+    {
+        const double params[] = { normal ? 0.0 : 1.0, 1.0 };
+        const rv_moments_t expected = { normal ? 0.0 : 1.0, 1.0, normal ? 0.0 : 2.0, normal ? 0.0 : 6.0 };
+        double (*cdf)(double, const double*) = normal ? normalCDF : exponentialCDF;
+        rv_generator_t gen;
+        rv_seed(&gen, 9999);
+        srand(9999);
+        printf("%s \n", normal ? "normal(0, 1)" : "exponential(1)");
+        fill(normal, 0, &gen, check, QUALITY_SAMPLES);
+        printQuality("rand():", check, QUALITY_SAMPLES, cdf, params, &expected);
+        fill(normal, 2, &gen, check, QUALITY_SAMPLES);
+        printQuality("ziggurat:", check, QUALITY_SAMPLES, cdf, params, &expected);
+    }
+
+    compareTails(true, nTail, buf);
+    compareTails(false, nTail, buf);
+
+    free(buf);
+    free(check);
+    return 0;
+}